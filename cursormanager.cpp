@@ -1,10 +1,32 @@
 #include "cursormanager.h"
 #include "qcustomplot.h"
+#include "renderscheduler.h"
+#include "signalgraph.h"
 #include <QMouseEvent>
 #include <QDebug>
 #include <algorithm>
+#include <QtNumeric>
 #include <QFontMetrics>
 
+// 游标专用图层 (lmBuffered)，拖拽游标时只重绘此图层
+static const char *const kCursorLayerName = "cursor";
+
+/**
+ * @brief [辅助函数] 取曲线的时间向量
+ * * SignalGraph 直接共享源数据；其他曲线从 data() 中拷贝一次
+ */
+static QVector<double> graphKeys(QCPGraph *graph)
+{
+    if (SignalGraph *signalGraph = qobject_cast<SignalGraph *>(graph))
+        return signalGraph->sourceKeys();
+
+    QVector<double> keys;
+    keys.reserve(graph->data()->size());
+    for (auto it = graph->data()->constBegin(); it != graph->data()->constEnd(); ++it)
+        keys.append(it->key);
+    return keys;
+}
+
 CursorManager::CursorManager(QList<QCustomPlot *> *plotWidgets,
                              QObject *parent)
     : QObject(parent),
@@ -27,11 +49,86 @@ CursorManager::CursorMode CursorManager::getMode() const
     return m_cursorMode;
 }
 
+double CursorManager::cursorKey(int cursorIndex) const
+{
+    if (cursorIndex < 1 || cursorIndex > m_cursors.size())
+        return qQNaN();
+    return m_cursors.at(cursorIndex - 1).key;
+}
+
 void CursorManager::setActivePlot(QCustomPlot *plot)
 {
     m_currentActivePlot = plot;
 }
 
+void CursorManager::setRenderScheduler(RenderScheduler *scheduler)
+{
+    m_renderScheduler = scheduler;
+}
+
+void CursorManager::setMaxValueLabels(int count)
+{
+    if (m_maxValueLabels == count)
+        return;
+    m_maxValueLabels = count;
+    updateAllCursors();
+}
+
+CursorManager::SnapMode CursorManager::snapMode() const
+{
+    return m_snapMode;
+}
+
+void CursorManager::setSnapMode(SnapMode mode)
+{
+    m_snapMode = mode;
+}
+
+void CursorManager::setSnapGraph(QCPGraph *graph)
+{
+    m_snapGraph = graph;
+}
+
+/**
+ * @brief [辅助] 通过渲染调度器合并重绘请求 (未设置时直接重绘)
+ */
+void CursorManager::requestReplot(QCustomPlot *plot)
+{
+    if (m_renderScheduler)
+        m_renderScheduler->requestReplot(plot);
+    else
+        plot->replot();
+}
+
+/**
+ * @brief [辅助] 仅重绘游标图层，数据图层保留已缓存的像素
+ */
+void CursorManager::requestCursorLayerReplot(QCustomPlot *plot)
+{
+    if (m_renderScheduler)
+        m_renderScheduler->requestLayerReplot(plot, kCursorLayerName);
+    else if (QCPLayer *layer = plot->layer(kCursorLayerName))
+        layer->replot();
+    else
+        plot->replot();
+}
+
+/**
+ * @brief [辅助] 获取 (必要时创建) 子图上的游标图层
+ * * 图层位于 legend 之上、overlay 之下，并使用独立的绘制缓冲
+ */
+QCPLayer *CursorManager::ensureCursorLayer(QCustomPlot *plot)
+{
+    QCPLayer *layer = plot->layer(kCursorLayerName);
+    if (!layer)
+    {
+        plot->addLayer(kCursorLayerName, plot->layer("legend"), QCustomPlot::limAbove);
+        layer = plot->layer(kCursorLayerName);
+        layer->setMode(QCPLayer::lmBuffered);
+    }
+    return layer;
+}
+
 /**
  * @brief 响应游标模式切换
  */
@@ -69,6 +166,9 @@ void CursorManager::setMode(CursorManager::CursorMode mode)
 
     if (mode != CursorManager::NoCursor)
     {
+        // 游标关闭期间添加的曲线尚未进入索引
+        refreshTimeIndex();
+
         QCustomPlot *plot = m_currentActivePlot;
         if (!plot && !m_plotWidgets->isEmpty())
             plot = m_plotWidgets->first();
@@ -118,6 +218,8 @@ void CursorManager::setMode(CursorManager::CursorMode mode)
 
     setupCursors();
     updateAllCursors();
+
+    emit modeChanged(mode);
 }
 /**
  * @brief 使用内部键值强制更新所有游标
@@ -150,9 +252,9 @@ void CursorManager::onPlotMousePress(QMouseEvent *event)
 
     for (int i = 0; i <= maxCursorIdx; ++i)
     {
-        if (plotIndex < m_cursors[i].lines.size())
+        if (QCPItemLine *line = cursorLine(i, plot))
         {
-            double dist = m_cursors[i].lines.at(plotIndex)->selectTest(event->pos(), false);
+            double dist = line->selectTest(event->pos(), false);
             if (dist >= 0 && dist < plot->selectionTolerance())
             {
                 m_cursors[i].isDragging = true;
@@ -203,9 +305,9 @@ void CursorManager::onPlotMouseMove(QMouseEvent *event)
             int maxCursorIdx = (m_cursorMode == CursorManager::DoubleCursor) ? 1 : 0;
             for (int i = 0; i <= maxCursorIdx; ++i)
             {
-                if (plotIndex < m_cursors[i].lines.size())
+                if (QCPItemLine *line = cursorLine(i, plot))
                 {
-                    double dist = m_cursors[i].lines.at(plotIndex)->selectTest(event->pos(), false);
+                    double dist = line->selectTest(event->pos(), false);
                     if (dist >= 0 && dist < plot->selectionTolerance())
                         nearCursor = true;
                 }
@@ -235,138 +337,349 @@ void CursorManager::onPlotMouseRelease(QMouseEvent *event)
 }
 
 /**
- * @brief 销毁所有游标项
+ * @brief 销毁所有游标项 (包括池中的空闲图元)
  */
 void CursorManager::clearCursors()
 {
-    auto safeRemoveItem = [](QCPAbstractItem *item)
+    for (int i = 0; i < m_cursors.size(); ++i)
     {
-        if (item && item->parentPlot())
-            item->parentPlot()->removeItem(item);
-        else if (item)
-            delete item;
-    };
+        for (auto it = m_cursors[i].plots.begin(); it != m_cursors[i].plots.end(); ++it)
+            destroyItems(it.value());
+        m_cursors[i].plots.clear();
+    }
+}
 
-    // 遍历所有游标数据进行清理
+/**
+ * @brief 根据 m_cursorMode 增量同步游标图元
+ * * 只为新出现的子图/曲线分配图元，已移除曲线的 tracer 回收到池中，
+ * 未使用的游标 (关闭或单游标模式下的游标 2) 仅隐藏
+ */
+void CursorManager::setupCursors()
+{
+    // 1. 清理已不在布局中的子图 (已销毁的子图在 onPlotDestroyed 中处理)
     for (int i = 0; i < m_cursors.size(); ++i)
     {
-        for (auto item : m_cursors[i].yLabels.values())
-            safeRemoveItem(item);
-        m_cursors[i].yLabels.clear();
+        auto it = m_cursors[i].plots.begin();
+        while (it != m_cursors[i].plots.end())
+        {
+            if (m_plotWidgets->contains(it.key()))
+            {
+                ++it;
+                continue;
+            }
+            destroyItems(it.value());
+            it = m_cursors[i].plots.erase(it);
+        }
+    }
+
+    m_cursorFont = (!m_plotWidgets->isEmpty()) ? m_plotWidgets->first()->font() : QFont();
+    m_cursorFont.setPointSize(7);
 
-        for (auto item : m_cursors[i].graphTracers.values())
-            safeRemoveItem(item);
-        m_cursors[i].graphTracers.clear();
+    int activeCursors = 0;
+    if (m_cursorMode == CursorManager::SingleCursor)
+        activeCursors = 1;
+    else if (m_cursorMode == CursorManager::DoubleCursor)
+        activeCursors = 2;
 
-        for (auto item : m_cursors[i].lines)
-            safeRemoveItem(item);
-        m_cursors[i].lines.clear();
+    // 2. 逐子图同步
+    for (QCustomPlot *plot : *m_plotWidgets)
+    {
+        if (!m_trackedPlots.contains(plot))
+        {
+            m_trackedPlots.insert(plot);
+            connect(plot, &QObject::destroyed, this, &CursorManager::onPlotDestroyed);
+        }
 
-        for (auto item : m_cursors[i].xLabels)
-            safeRemoveItem(item);
-        m_cursors[i].xLabels.clear();
+        for (int i = 0; i < m_cursors.size(); ++i)
+        {
+            if (i >= activeCursors)
+            {
+                auto it = m_cursors[i].plots.find(plot);
+                if (it != m_cursors[i].plots.end())
+                    setItemsVisible(it.value(), false);
+                continue;
+            }
+
+            PlotItems &items = m_cursors[i].plots[plot];
+            if (!items.line)
+                createCursorLine(plot, items, i);
+            syncGraphTracers(plot, items);
+            setItemsVisible(items, true);
+        }
+
+        requestCursorLayerReplot(plot);
     }
+
+    refreshTimeIndex();
 }
 
 /**
- * @brief 根据 m_cursorMode 设置游标
+ * @brief 增量同步吸附索引：新出现的可见曲线并入，隐藏或移出布局的曲线移除
+ * * 只登记/注销来源 (隐式共享时间向量，不复制、不合并)，O(1)
  */
-void CursorManager::setupCursors()
+void CursorManager::refreshTimeIndex()
 {
-    clearCursors();
+    QSet<QCPGraph *> current;
+    for (QCustomPlot *plot : *m_plotWidgets)
+    {
+        for (int g = 0; g < plot->graphCount(); ++g)
+        {
+            QCPGraph *graph = plot->graph(g);
+            if (!graph || !graph->visible())
+                continue;
+            current.insert(graph);
+            if (m_indexedGraphs.contains(graph))
+                continue;
+
+            IndexedGraph entry;
+            entry.plot = plot;
+            entry.keys = graphKeys(graph);
+            m_allTimeIndex.addSource(entry.keys);
+            m_plotTimeIndex[plot].addSource(entry.keys);
+            m_indexedGraphs.insert(graph, entry);
+            connect(graph, &QObject::destroyed, this, &CursorManager::onGraphDestroyed, Qt::UniqueConnection);
+        }
+    }
 
-    if (m_cursorMode == CursorManager::NoCursor)
+    QList<QCPGraph *> stale;
+    for (auto it = m_indexedGraphs.constBegin(); it != m_indexedGraphs.constEnd(); ++it)
+    {
+        if (!current.contains(it.key()))
+            stale.append(it.key());
+    }
+    for (QCPGraph *graph : stale)
+        unindexGraph(graph);
+
+    auto plotIt = m_plotTimeIndex.begin();
+    while (plotIt != m_plotTimeIndex.end())
+    {
+        if (plotIt.value().sourceCount() == 0)
+            plotIt = m_plotTimeIndex.erase(plotIt);
+        else
+            ++plotIt;
+    }
+}
+
+/**
+ * @brief [辅助] 从吸附索引中注销曲线 (不解引用 graph)
+ */
+void CursorManager::unindexGraph(QCPGraph *graph)
+{
+    auto it = m_indexedGraphs.find(graph);
+    if (it == m_indexedGraphs.end())
+        return;
+
+    m_allTimeIndex.removeSource(it.value().keys);
+    auto plotIt = m_plotTimeIndex.find(it.value().plot);
+    if (plotIt != m_plotTimeIndex.end())
+        plotIt.value().removeSource(it.value().keys);
+    m_indexedGraphs.erase(it);
+}
+
+/**
+ * @brief [辅助] 创建游标竖线和 X 标签
+ */
+void CursorManager::createCursorLine(QCustomPlot *plot, PlotItems &items, int cursorIndex)
+{
+    // Cursor 1 红色，Cursor 2 蓝色
+    const QColor color = (cursorIndex == 0) ? QColor(Qt::red) : QColor(Qt::blue);
+    QCPLayer *cursorLayer = ensureCursorLayer(plot);
+
+    QCPItemLine *line = new QCPItemLine(plot);
+    line->setLayer(cursorLayer);
+    line->setPen(QPen(color, 0, Qt::DashLine));
+    line->setSelectable(true);
+    line->start->setType(QCPItemPosition::ptAbsolute);
+    line->end->setType(QCPItemPosition::ptAbsolute);
+    line->setClipToAxisRect(true);
+    items.line = line;
+
+    QCPItemText *xLabel = new QCPItemText(plot);
+    xLabel->setLayer(cursorLayer);
+    xLabel->setClipToAxisRect(false);
+    xLabel->setPadding(QMargins(5, 2, 5, 2));
+    xLabel->setBrush(QBrush(QColor(255, 255, 255, 200)));
+    xLabel->setPen(QPen(Qt::black));
+    xLabel->setFont(m_cursorFont);
+    xLabel->setPositionAlignment(Qt::AlignTop | Qt::AlignHCenter);
+    xLabel->position->setParentAnchor(line->start);
+    xLabel->position->setCoords(0, 5);
+    items.xLabel = xLabel;
+}
+
+/**
+ * @brief [辅助] 让 tracer 集合与子图当前的曲线一致
+ * * 已移除的曲线回收 tracer，新曲线从池中取用；其余 tracer 只刷新画笔
+ */
+void CursorManager::syncGraphTracers(QCustomPlot *plot, PlotItems &items)
+{
+    // 1. 回收不再属于此子图的曲线 (hasPlottable 只比较指针，不解引用)
+    QList<QCPGraph *> stale;
+    for (auto it = items.graphTracers.constBegin(); it != items.graphTracers.constEnd(); ++it)
     {
-        for (QCustomPlot *plot : *m_plotWidgets)
-            plot->replot();
+        if (!plot->hasPlottable(it.key()))
+            stale.append(it.key());
+    }
+    for (QCPGraph *graph : stale)
+        recycleTracer(items, graph);
+
+    // 2. 为新曲线分配 tracer，已有的同步画笔 (颜色可能被修改)
+    for (int g = 0; g < plot->graphCount(); ++g)
+    {
+        QCPGraph *graph = plot->graph(g);
+        if (!graph)
+            continue;
+
+        QCPItemTracer *tracer = items.graphTracers.value(graph, nullptr);
+        if (!tracer)
+        {
+            tracer = acquireTracer(plot, items);
+            tracer->setGraph(graph);
+            items.graphTracers.insert(graph, tracer);
+            // 曲线被删除时立即解除引用，避免 tracer 持有悬空指针
+            connect(graph, &QObject::destroyed, this, &CursorManager::onGraphDestroyed, Qt::UniqueConnection);
+        }
+
+        const QColor color = graph->pen().color();
+        tracer->setPen(graph->pen());
+        tracer->setBrush(QBrush(color));
+
+        QCPItemText *yLabel = items.yLabels.value(tracer, nullptr);
+        if (yLabel)
+        {
+            yLabel->setPen(QPen(color));
+            yLabel->setColor(color);
+        }
+    }
+}
+
+/**
+ * @brief [辅助] 从池中取出一对 tracer/yLabel，池为空时新建
+ */
+QCPItemTracer *CursorManager::acquireTracer(QCustomPlot *plot, PlotItems &items)
+{
+    if (!items.tracerPool.isEmpty())
+        return items.tracerPool.takeLast();
+
+    QCPLayer *cursorLayer = ensureCursorLayer(plot);
+
+    QCPItemTracer *tracer = new QCPItemTracer(plot);
+    tracer->setLayer(cursorLayer);
+    tracer->setInterpolating(false);
+    tracer->setStyle(QCPItemTracer::tsCircle);
+    tracer->setSize(3);
+
+    QCPItemText *yLabel = new QCPItemText(plot);
+    yLabel->setLayer(cursorLayer);
+    yLabel->setClipToAxisRect(false);
+    yLabel->setPadding(QMargins(5, 2, 5, 2));
+    yLabel->setBrush(QBrush(QColor(255, 255, 255, 180)));
+    yLabel->setPositionAlignment(Qt::AlignLeft | Qt::AlignVCenter);
+    yLabel->position->setParentAnchor(tracer->position);
+    yLabel->position->setCoords(5, 0);
+    yLabel->setFont(m_cursorFont);
+    items.yLabels.insert(tracer, yLabel);
+
+    return tracer;
+}
+
+/**
+ * @brief [辅助] 解除 tracer 与曲线的关联并放回池中 (不解引用 graph)
+ */
+void CursorManager::recycleTracer(PlotItems &items, QCPGraph *graph)
+{
+    QCPItemTracer *tracer = items.graphTracers.take(graph);
+    if (!tracer)
         return;
+
+    tracer->setGraph(nullptr);
+    tracer->setVisible(false);
+    if (QCPItemText *yLabel = items.yLabels.value(tracer, nullptr))
+        yLabel->setVisible(false);
+    items.tracerPool.append(tracer);
+}
+
+/**
+ * @brief [辅助] 显示/隐藏一个游标在某子图上的全部在用图元 (池中图元保持隐藏)
+ */
+void CursorManager::setItemsVisible(PlotItems &items, bool visible)
+{
+    if (items.line)
+        items.line->setVisible(visible);
+    if (items.xLabel)
+        items.xLabel->setVisible(visible);
+    for (QCPItemTracer *tracer : items.graphTracers)
+    {
+        tracer->setVisible(visible);
+        if (QCPItemText *yLabel = items.yLabels.value(tracer, nullptr))
+            yLabel->setVisible(visible);
     }
+}
 
-    // 定义样式配置
-    struct StyleConfig
+/**
+ * @brief [辅助] 从子图中删除图元
+ */
+void CursorManager::destroyItems(PlotItems &items)
+{
+    auto safeRemoveItem = [](QCPAbstractItem *item)
     {
-        QColor color;
-        Qt::PenStyle style;
-    };
-    StyleConfig configs[] = {
-        {Qt::red, Qt::DashLine}, // Cursor 1
-        {Qt::blue, Qt::DashLine} // Cursor 2
+        if (item && item->parentPlot())
+            item->parentPlot()->removeItem(item);
+        else if (item)
+            delete item;
     };
 
-    QColor xLabelBgColor(255, 255, 255, 200);
-    QBrush xLabelBrush(xLabelBgColor);
-    QPen xLabelPen(Qt::black);
-    QFont cursorFont = (!m_plotWidgets->isEmpty()) ? m_plotWidgets->first()->font() : QFont();
-    cursorFont.setPointSize(7);
+    // yLabels 覆盖所有 (在用 + 池中) tracer
+    for (auto it = items.yLabels.constBegin(); it != items.yLabels.constEnd(); ++it)
+    {
+        safeRemoveItem(it.value());
+        safeRemoveItem(it.key());
+    }
+    safeRemoveItem(items.xLabel);
+    safeRemoveItem(items.line);
 
-    int activeCursors = (m_cursorMode == DoubleCursor) ? 2 : 1;
+    items = PlotItems();
+}
 
-    // 遍历每个子图
-    for (QCustomPlot *plot : *m_plotWidgets)
+/**
+ * @brief [辅助] 获取某游标在子图上的竖线 (未创建或已隐藏时返回 nullptr)
+ */
+QCPItemLine *CursorManager::cursorLine(int cursorIndex, QCustomPlot *plot) const
+{
+    auto it = m_cursors[cursorIndex].plots.constFind(plot);
+    if (it == m_cursors[cursorIndex].plots.constEnd() || !it.value().line || !it.value().line->visible())
+        return nullptr;
+    return it.value().line;
+}
+
+/**
+ * @brief [槽] 曲线被删除：回收其 tracer
+ * * 此时对象已析构，只按指针值查找
+ */
+void CursorManager::onGraphDestroyed(QObject *object)
+{
+    QCPGraph *graph = static_cast<QCPGraph *>(object);
+    for (int i = 0; i < m_cursors.size(); ++i)
     {
-        // 遍历每个逻辑游标 (1 或 2)
-        for (int i = 0; i < activeCursors; ++i)
+        for (auto it = m_cursors[i].plots.begin(); it != m_cursors[i].plots.end(); ++it)
         {
-            CursorData &cursor = m_cursors[i];
-            QPen linePen(configs[i].color, 0, configs[i].style);
-
-            // 1. 创建 Line
-            QCPItemLine *line = new QCPItemLine(plot);
-            line->setPen(linePen);
-            line->setSelectable(true);
-            line->start->setType(QCPItemPosition::ptAbsolute);
-            line->end->setType(QCPItemPosition::ptAbsolute);
-            line->setClipToAxisRect(true);
-            cursor.lines.append(line);
-
-            // 2. 创建 X Label
-            QCPItemText *xLabel = new QCPItemText(plot);
-            xLabel->setLayer("overlay");
-            xLabel->setClipToAxisRect(false);
-            xLabel->setPadding(QMargins(5, 2, 5, 2));
-            xLabel->setBrush(xLabelBrush);
-            xLabel->setPen(xLabelPen);
-            xLabel->setFont(cursorFont);
-            xLabel->setPositionAlignment(Qt::AlignTop | Qt::AlignHCenter);
-            xLabel->position->setParentAnchor(line->start);
-            xLabel->position->setCoords(0, 5);
-            cursor.xLabels.append(xLabel);
-
-            // 3. 创建 Tracers & Y Labels
-            for (int g = 0; g < plot->graphCount(); ++g)
-            {
-                QCPGraph *graph = plot->graph(g);
-                if (!graph)
-                    continue;
-
-                QCPItemTracer *tracer = new QCPItemTracer(plot);
-                tracer->setGraph(graph);
-                tracer->setInterpolating(false);
-                tracer->setVisible(true);
-                tracer->setStyle(QCPItemTracer::tsCircle);
-                tracer->setSize(3);
-                tracer->setPen(graph->pen());
-                tracer->setBrush(QBrush(graph->pen().color()));
-                cursor.graphTracers.insert(graph, tracer);
-
-                QCPItemText *yLabel = new QCPItemText(plot);
-                yLabel->setLayer("overlay");
-                yLabel->setClipToAxisRect(false);
-                yLabel->setPadding(QMargins(5, 2, 5, 2));
-                yLabel->setBrush(QBrush(QColor(255, 255, 255, 180)));
-                yLabel->setPen(QPen(graph->pen().color()));
-                yLabel->setColor(graph->pen().color());
-                yLabel->setPositionAlignment(Qt::AlignLeft | Qt::AlignVCenter);
-                yLabel->position->setParentAnchor(tracer->position);
-                yLabel->position->setCoords(5, 0);
-                yLabel->setFont(cursorFont);
-                cursor.yLabels.insert(tracer, yLabel);
-            }
+            if (it.value().graphTracers.contains(graph))
+                recycleTracer(it.value(), graph);
         }
     }
+    unindexGraph(graph);
+}
 
-    for (QCustomPlot *plot : *m_plotWidgets)
-        plot->replot();
+/**
+ * @brief [槽] 子图被销毁：其图元已由 QCustomPlot 删除，只需丢弃记录
+ */
+void CursorManager::onPlotDestroyed(QObject *object)
+{
+    QCustomPlot *plot = static_cast<QCustomPlot *>(object);
+    m_trackedPlots.remove(plot);
+    for (int i = 0; i < m_cursors.size(); ++i)
+        m_cursors[i].plots.remove(plot);
+    m_plotTimeIndex.remove(plot);
 }
 
 /**
@@ -480,100 +793,90 @@ void CursorManager::updateCursors(double key, int cursorIndex)
         return;
 
     // 遍历所有 Plot 并更新视觉元素
-    for (int i = 0; i < m_plotWidgets->size(); ++i)
+    for (QCustomPlot *plot : *m_plotWidgets)
     {
-        QCustomPlot *plot = m_plotWidgets->at(i);
-        if (i >= cursor.lines.size())
+        auto itemsIt = cursor.plots.find(plot);
+        if (itemsIt == cursor.plots.end() || !itemsIt.value().line)
             continue;
+        PlotItems &items = itemsIt.value();
 
         QList<QCPItemText *> labelsOnThisPlot;
 
         // A. Update Line
         double xPixel = plot->xAxis->coordToPixel(key);
-        QCPItemLine *line = cursor.lines.at(i);
-        line->start->setCoords(xPixel, plot->axisRect()->bottom());
-        line->end->setCoords(xPixel, plot->axisRect()->top());
+        items.line->start->setCoords(xPixel, plot->axisRect()->bottom());
+        items.line->end->setCoords(xPixel, plot->axisRect()->top());
 
         // B. Update X Label
-        cursor.xLabels.at(i)->setText(QString::number(key, 'f', 4));
+        items.xLabel->setText(QString::number(key, 'f', 4));
 
-        // C. Update Tracers and Y Labels
+        // C. Update Tracers and Y Labels (超出上限的曲线不显示标签，也不格式化文本)
+        int labelCount = 0;
         for (int j = 0; j < plot->graphCount(); ++j)
         {
-            QCPGraph *graph = plot->graph(j);
-            if (cursor.graphTracers.contains(graph))
+            // 按曲线顺序遍历，"前 N 条" 与图例顺序一致
+            QCPItemTracer *tracer = items.graphTracers.value(plot->graph(j), nullptr);
+            if (!tracer)
+                continue;
+            tracer->setGraphKey(key);
+            tracer->updatePosition();
+
+            QCPItemText *yLabel = items.yLabels.value(tracer, nullptr);
+            if (yLabel && m_maxValueLabels >= 0 && labelCount >= m_maxValueLabels)
             {
-                QCPItemTracer *tracer = cursor.graphTracers.value(graph);
-                tracer->setGraphKey(key);
-                tracer->updatePosition();
-
-                QCPItemText *yLabel = cursor.yLabels.value(tracer, nullptr);
-                if (yLabel)
-                {
-                    double value = tracer->position->value();
-                    yLabel->setText(QString::number(value, 'f', 3));
-                    yLabel->setVisible(true);
-                    labelsOnThisPlot.append(yLabel);
-                }
+                yLabel->setVisible(false);
+            }
+            else if (yLabel)
+            {
+                labelCount++;
+                double value = tracer->position->value();
+                yLabel->setText(QString::number(value, 'f', 3));
+                yLabel->setVisible(true);
+                labelsOnThisPlot.append(yLabel);
             }
         }
         resolveLabelOverlaps(labelsOnThisPlot);
-        plot->replot();
+        requestCursorLayerReplot(plot);
     }
 }
 
 /**
- * @brief [辅助] 将一个 key (X坐标) 吸附到活动子图上的最近数据点
+ * @brief [辅助] 按吸附模式将一个 key (X坐标) 吸附到最近的采样时刻
+ * * 在各来源的时间向量上二分查找，与数据量呈对数关系
  * @param key 要吸附的原始 key
  * @return 吸附后的 key
  */
 double CursorManager::snapKeyToData(double key) const
 {
-    QCustomPlot *plot = m_currentActivePlot;
-    if (!plot && !m_plotWidgets->isEmpty())
-        plot = m_plotWidgets->first();
-    if (!plot)
-        return key;
+    double snapped = key;
 
-    // 修改：直接检查 graphCount
-    if (plot->graphCount() == 0)
+    switch (m_snapMode)
+    {
+    case SnapNone:
         return key;
 
-    double closestKey = key;
-    double minDistance = std::numeric_limits<double>::max();
-    bool foundAny = false;
-
-    // 修改：直接遍历 graph
-    for (int i = 0; i < plot->graphCount(); ++i)
+    case SnapSignal:
     {
-        QCPGraph *graph = plot->graph(i);
-        if (!graph || !graph->visible() || graph->data()->isEmpty())
-            continue;
+        auto it = m_indexedGraphs.constFind(m_snapGraph.data());
+        if (m_snapGraph && it != m_indexedGraphs.constEnd())
+            return TimeIndex::nearestIn(it.value().keys, key, &snapped) ? snapped : key;
+        break; // 目标曲线已删除或隐藏：退回所有信号
+    }
 
-        auto it = graph->data()->findBegin(key);
+    case SnapActivePlot:
+    {
+        QCustomPlot *plot = m_currentActivePlot;
+        if (!plot && !m_plotWidgets->isEmpty())
+            plot = m_plotWidgets->first();
+        auto it = m_plotTimeIndex.constFind(plot);
+        if (it == m_plotTimeIndex.constEnd())
+            return key;
+        return it.value().nearest(key, &snapped) ? snapped : key;
+    }
 
-        if (it != graph->data()->constEnd())
-        {
-            double dist = qAbs(it->key - key);
-            if (dist < minDistance)
-            {
-                minDistance = dist;
-                closestKey = it->key;
-                foundAny = true;
-            }
-        }
-        if (it != graph->data()->constBegin())
-        {
-            auto prevIt = it - 1;
-            double dist = qAbs(prevIt->key - key);
-            if (dist < minDistance)
-            {
-                minDistance = dist;
-                closestKey = prevIt->key;
-                foundAny = true;
-            }
-        }
+    case SnapAllSignals:
+        break;
     }
 
-    return foundAny ? closestKey : key;
-}
\ No newline at end of file
+    return m_allTimeIndex.nearest(key, &snapped) ? snapped : key;
+}
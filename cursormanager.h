@@ -4,7 +4,12 @@
 #include <QObject>
 #include <QList>
 #include <QMap>
+#include <QHash>
+#include <QSet>
 #include <QPen>
+#include <QFont>
+#include <QPointer>
+#include "timeindex.h"
 
 // 向前声明
 class QCustomPlot;
@@ -15,6 +20,8 @@ class QCPItemText;
 class QMouseEvent;
 class QAction;
 class QCPRange;
+class QCPLayer;
+class RenderScheduler;
 
 class CursorManager : public QObject
 {
@@ -27,15 +34,49 @@ public:
         SingleCursor,
         DoubleCursor
     };
+
+    /**
+     * @brief 游标吸附目标
+     */
+    enum SnapMode
+    {
+        SnapAllSignals, // 所有子图上可见信号的最近采样时刻
+        SnapActivePlot, // 仅当前子图
+        SnapSignal,     // 仅指定信号 (见 setSnapGraph)
+        SnapNone        // 不吸附
+    };
     explicit CursorManager(QList<QCustomPlot *> *plotWidgets,
                            QObject *parent = nullptr);
     ~CursorManager();
 
     CursorMode getMode() const;
+
+    /**
+     * @brief 游标当前所在的 key
+     * @param cursorIndex 1 或 2
+     */
+    double cursorKey(int cursorIndex) const;
     void setActivePlot(QCustomPlot *plot);
+    void setRenderScheduler(RenderScheduler *scheduler);
+
+    /**
+     * @brief 限制每个子图上显示数值标签的曲线数量
+     * * 超出部分只保留 tracer 标记 (数值可在游标读数面板中查看)
+     * @param count 最大数量，-1 表示不限制
+     */
+    void setMaxValueLabels(int count);
+
+    SnapMode snapMode() const;
+    void setSnapMode(SnapMode mode);
+
+    /**
+     * @brief 设置 SnapSignal 模式下的目标曲线 (曲线删除后自动退回 SnapAllSignals 的行为)
+     */
+    void setSnapGraph(QCPGraph *graph);
 
 signals:
     void cursorKeyChanged(double key, int cursorIndex);
+    void modeChanged(CursorManager::CursorMode mode);
 
 public slots:
     void onCursorActionTriggered(QAction *action);
@@ -45,26 +86,57 @@ public slots:
     void clearCursors();
     void setupCursors();
 
+    /**
+     * @brief [槽] 使时间索引与当前可见曲线一致 (曲线显示/隐藏后调用)
+     */
+    void refreshTimeIndex();
+
     // QCustomPlot 信号槽
     void onPlotMousePress(QMouseEvent *event);
     void onPlotMouseMove(QMouseEvent *event);
     void onPlotMouseRelease(QMouseEvent *event);
 
+private slots:
+    void onGraphDestroyed(QObject *object);
+    void onPlotDestroyed(QObject *object);
+
 private:
-    void resolveLabelOverlaps(QList<QCPItemText *> &labelsOnPlot);
-    double snapKeyToData(double key) const;
+    /**
+     * @brief 某个游标在单个子图上的图元
+     * * tracer/yLabel 成对分配；曲线移除后放回 tracerPool 隐藏复用，而不是销毁
+     */
+    struct PlotItems
+    {
+        QCPItemLine *line = nullptr;
+        QCPItemText *xLabel = nullptr;
+        QMap<QCPGraph *, QCPItemTracer *> graphTracers;
+        QMap<QCPItemTracer *, QCPItemText *> yLabels; // 包含池中的 tracer
+        QList<QCPItemTracer *> tracerPool;
+    };
 
     struct CursorData
     {
         double key = 0.0;
         bool isDragging = false;
 
-        QList<QCPItemLine *> lines;
-        QList<QCPItemText *> xLabels;
-        QMap<QCPGraph *, QCPItemTracer *> graphTracers;
-        QMap<QCPItemTracer *, QCPItemText *> yLabels;
+        QHash<QCustomPlot *, PlotItems> plots;
     };
 
+    void resolveLabelOverlaps(QList<QCPItemText *> &labelsOnPlot);
+    double snapKeyToData(double key) const;
+    void requestReplot(QCustomPlot *plot);
+    void requestCursorLayerReplot(QCustomPlot *plot);
+    QCPLayer *ensureCursorLayer(QCustomPlot *plot);
+
+    void createCursorLine(QCustomPlot *plot, PlotItems &items, int cursorIndex);
+    void syncGraphTracers(QCustomPlot *plot, PlotItems &items);
+    QCPItemTracer *acquireTracer(QCustomPlot *plot, PlotItems &items);
+    void recycleTracer(PlotItems &items, QCPGraph *graph);
+    void setItemsVisible(PlotItems &items, bool visible);
+    void destroyItems(PlotItems &items);
+    void unindexGraph(QCPGraph *graph);
+    QCPItemLine *cursorLine(int cursorIndex, QCustomPlot *plot) const;
+
     CursorMode m_cursorMode;
 
     // 使用 Vector 替代散乱的 1/2 变量
@@ -73,6 +145,22 @@ private:
 
     QList<QCustomPlot *> *m_plotWidgets;
     QCustomPlot *m_currentActivePlot = nullptr;
+    RenderScheduler *m_renderScheduler = nullptr;
+    QFont m_cursorFont;
+    int m_maxValueLabels = -1;
+    QSet<QCustomPlot *> m_trackedPlots; // 已连接 destroyed 信号的子图
+
+    // 吸附用的时间索引 (按可见曲线增量维护，查询时在各来源上二分)
+    struct IndexedGraph
+    {
+        QCustomPlot *plot = nullptr;
+        QVector<double> keys; // 隐式共享，删除曲线后仍可用于从索引中移除
+    };
+    SnapMode m_snapMode = SnapAllSignals;
+    QPointer<QCPGraph> m_snapGraph;
+    QHash<QCPGraph *, IndexedGraph> m_indexedGraphs;
+    TimeIndex m_allTimeIndex;
+    QHash<QCustomPlot *, TimeIndex> m_plotTimeIndex;
     // --- 优化部分结束 ---
 };
 
@@ -0,0 +1,193 @@
+#include "cursorreadoutmodel.h"
+#include "latestjobrunner.h"
+
+#include <QRunnable>
+#include <QtNumeric>
+#include <algorithm>
+
+/**
+ * @brief [辅助函数] 取最接近 key 的样本值 (与非插值 tracer 一致)
+ * * key 超出信号的时间范围时返回 NaN
+ */
+static double valueAtKey(const QVector<double> &keys, const QVector<double> &values, double key)
+{
+    const int n = qMin(keys.size(), values.size());
+    if (n == 0 || key < keys.first() || key > keys.at(n - 1))
+        return qQNaN();
+
+    const double *keyData = keys.constData();
+    int i = int(std::lower_bound(keyData, keyData + n, key) - keyData);
+    if (i >= n)
+        i = n - 1;
+    if (i > 0 && (key - keyData[i - 1]) < (keyData[i] - key))
+        --i;
+    return values.at(i);
+}
+
+/**
+ * @brief 批量取值任务 (在线程池中运行)
+ */
+class CursorReadoutJob : public QRunnable
+{
+public:
+    CursorReadoutJob(CursorReadoutModel *owner, const QVector<CursorReadoutModel::Entry> &entries,
+                     double key1, double key2, int cursorCount, int generation)
+        : m_owner(owner),
+          m_entries(entries),
+          m_key1(key1),
+          m_key2(key2),
+          m_cursorCount(cursorCount),
+          m_generation(generation)
+    {
+    }
+
+    void run() override
+    {
+        CursorReadoutResult result;
+        result.generation = m_generation;
+        result.values1.fill(qQNaN(), m_entries.size());
+        result.values2.fill(qQNaN(), m_entries.size());
+
+        for (int i = 0; i < m_entries.size(); ++i)
+        {
+            const CursorReadoutModel::Entry &entry = m_entries.at(i);
+            if (m_cursorCount >= 1)
+                result.values1[i] = valueAtKey(entry.keys, entry.values, m_key1);
+            if (m_cursorCount >= 2)
+                result.values2[i] = valueAtKey(entry.keys, entry.values, m_key2);
+        }
+
+        emit m_owner->readoutReady(result);
+    }
+
+private:
+    CursorReadoutModel *m_owner;
+    QVector<CursorReadoutModel::Entry> m_entries;
+    double m_key1;
+    double m_key2;
+    int m_cursorCount;
+    int m_generation;
+};
+
+CursorReadoutModel::CursorReadoutModel(QObject *parent)
+    : SignalRowModel(parent),
+      m_cursorKey1(0),
+      m_cursorKey2(0),
+      m_cursorCount(0),
+      m_runner(nullptr)
+{
+    qRegisterMetaType<CursorReadoutResult>("CursorReadoutResult");
+
+    // 任务按提交时的条目和游标位置创建
+    m_runner = new LatestJobRunner([this](int generation) -> QRunnable *
+                                   { return new CursorReadoutJob(this, m_entries, m_cursorKey1, m_cursorKey2, m_cursorCount, generation); },
+                                   this);
+
+    connect(this, &CursorReadoutModel::readoutReady, this, &CursorReadoutModel::onReadoutReady, Qt::QueuedConnection);
+}
+
+CursorReadoutModel::~CursorReadoutModel()
+{
+    m_runner->cancelAndWait();
+}
+
+int CursorReadoutModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+int CursorReadoutModel::entryCount() const
+{
+    return m_entries.size();
+}
+
+const SignalRowEntry &CursorReadoutModel::entryAt(int row) const
+{
+    return m_entries.at(row);
+}
+
+QVariant CursorReadoutModel::valueText(int row, int column) const
+{
+    const double v1 = m_values1.value(row, qQNaN());
+    const double v2 = m_values2.value(row, qQNaN());
+    switch (column)
+    {
+    case Cursor1Column:
+        return m_cursorCount >= 1 ? formatValue(v1) : QString();
+    case Cursor2Column:
+        return m_cursorCount >= 2 ? formatValue(v2) : QString();
+    case DeltaColumn:
+        return m_cursorCount >= 2 ? formatValue(v2 - v1) : QString();
+    default:
+        return QVariant();
+    }
+}
+
+QVariant CursorReadoutModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QAbstractTableModel::headerData(section, orientation, role);
+
+    switch (section)
+    {
+    case NameColumn:
+        return tr("信号");
+    case Cursor1Column:
+        return tr("游标 1");
+    case Cursor2Column:
+        return tr("游标 2");
+    case DeltaColumn:
+        return tr("差值 (2-1)");
+    default:
+        return QVariant();
+    }
+}
+
+void CursorReadoutModel::setEntries(const QVector<Entry> &entries)
+{
+    beginResetModel();
+    m_entries = entries;
+    m_values1.fill(qQNaN(), m_entries.size());
+    m_values2.fill(qQNaN(), m_entries.size());
+    endResetModel();
+
+    // 基于旧条目的任务结果需丢弃
+    m_runner->invalidate();
+    m_runner->request();
+}
+
+void CursorReadoutModel::setCursorCount(int count)
+{
+    if (m_cursorCount == count)
+        return;
+    m_cursorCount = count;
+    m_runner->request();
+}
+
+/**
+ * @brief [槽] 记录游标位置并请求重新取值
+ */
+void CursorReadoutModel::setCursorKey(double key, int cursorIndex)
+{
+    if (cursorIndex == 1)
+        m_cursorKey1 = key;
+    else if (cursorIndex == 2)
+        m_cursorKey2 = key;
+    else
+        return;
+
+    m_runner->request();
+}
+
+/**
+ * @brief [槽] 接收取值结果，只通知数值列变化
+ */
+void CursorReadoutModel::onReadoutReady(const CursorReadoutResult &result)
+{
+    if (!m_runner->isCurrent(result.generation) || result.values1.size() != m_entries.size())
+        return;
+
+    m_values1 = result.values1;
+    m_values2 = result.values2;
+    emitValuesChanged();
+}
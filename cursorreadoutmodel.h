@@ -0,0 +1,93 @@
+#ifndef CURSORREADOUTMODEL_H
+#define CURSORREADOUTMODEL_H
+
+#include <QVector>
+#include <QMetaType>
+
+#include "signalrowmodel.h"
+
+// 向前声明
+class LatestJobRunner;
+
+/**
+ * @brief 一次游标取值任务的结果 (工作线程 -> GUI 线程)
+ */
+struct CursorReadoutResult
+{
+    int generation = 0;
+    QVector<double> values1; // 与条目一一对应，无数据时为 NaN
+    QVector<double> values2;
+};
+Q_DECLARE_METATYPE(CursorReadoutResult)
+
+/**
+ * @brief 游标读数表模型
+ * * 每行一个已绘制的信号，列为 游标 1 处的值、游标 2 处的值以及二者之差。
+ * 取值 (二分查找最近样本) 在工作线程中批量完成，由 LatestJobRunner 调度，拖拽时不会堆积任务。
+ * 视图只绘制可见行，模型本身不为每行创建任何控件。
+ */
+class CursorReadoutModel : public SignalRowModel
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        NameColumn = 0,
+        Cursor1Column,
+        Cursor2Column,
+        DeltaColumn,
+        ColumnCount
+    };
+
+    typedef SignalRowEntry Entry;
+
+    explicit CursorReadoutModel(QObject *parent = nullptr);
+    ~CursorReadoutModel();
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief 替换全部条目并重新取值
+     */
+    void setEntries(const QVector<Entry> &entries);
+
+    /**
+     * @brief 设置活动游标数量 (0、1 或 2)
+     */
+    void setCursorCount(int count);
+
+public slots:
+    /**
+     * @brief [槽] 游标位置变化 (与 CursorManager::cursorKeyChanged 对应)
+     */
+    void setCursorKey(double key, int cursorIndex);
+
+signals:
+    /**
+     * @brief [信号] 工作线程完成一次取值 (以排队连接送回 GUI 线程)
+     */
+    void readoutReady(const CursorReadoutResult &result);
+
+private slots:
+    void onReadoutReady(const CursorReadoutResult &result);
+
+protected:
+    int entryCount() const override;
+    const SignalRowEntry &entryAt(int row) const override;
+    QVariant valueText(int row, int column) const override;
+
+private:
+    QVector<Entry> m_entries;
+    QVector<double> m_values1;
+    QVector<double> m_values2;
+
+    double m_cursorKey1;
+    double m_cursorKey2;
+    int m_cursorCount;
+
+    LatestJobRunner *m_runner;
+};
+
+#endif // CURSORREADOUTMODEL_H
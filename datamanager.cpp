@@ -1,10 +1,14 @@
 #include "datamanager.h"
+#include "derivedexpression.h"
 #include <QFile>
 #include <QTextStream>
 #include <QDebug>
 #include <QThread>
 #include <QFileInfo>
 #include <QRegularExpression>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QtNumeric>
 #include <algorithm>
 
 #include <stdio.h>
@@ -98,6 +102,127 @@ static QStringList readMatStringArray(matvar_t *variable)
     return result;
 }
 
+/**
+ * @brief 为一段连续的列构建 LOD 金字塔、统计记录和分位数摘要 (在线程池中运行)
+ * * 各任务只写入自己负责的列，结果向量已预先分配好大小
+ */
+class ColumnPrepareJob : public QRunnable
+{
+public:
+    ColumnPrepareJob(const SignalTable &table, SignalLod *lods, SignalStats *stats, SignalQuantiles *quantiles,
+                     int begin, int end)
+        : m_table(table),
+          m_lods(lods),
+          m_stats(stats),
+          m_quantiles(quantiles),
+          m_begin(begin),
+          m_end(end)
+    {
+    }
+
+    void run() override
+    {
+        for (int c = m_begin; c < m_end; ++c)
+        {
+            const QVector<double> &values = m_table.valueData.at(c);
+            m_lods[c] = SignalLod::build(values);
+            m_stats[c] = SignalStats::compute(values);
+            m_quantiles[c] = SignalQuantiles::build(values);
+        }
+    }
+
+private:
+    const SignalTable &m_table;
+    SignalLod *m_lods;
+    SignalStats *m_stats;
+    SignalQuantiles *m_quantiles;
+    int m_begin;
+    int m_end;
+};
+
+/**
+ * @brief [辅助函数] 按时间稳定排序整张表 (时间轴与所有数据列同步重排)
+ * * 时间为 NaN 的行排在最后；相同时刻保持文件中的先后顺序
+ */
+static void sortTableByTime(SignalTable &table)
+{
+    const int n = table.timeData.size();
+    const double *time = table.timeData.constData();
+    QVector<int> order(n);
+    for (int i = 0; i < n; ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [time](int a, int b)
+                     { return qIsNaN(time[b]) ? !qIsNaN(time[a]) : time[a] < time[b]; });
+
+    auto permute = [&order, n](QVector<double> &column)
+    {
+        const int count = qMin(n, column.size());
+        QVector<double> sorted(column.size());
+        int out = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            if (order.at(i) < count)
+                sorted[out++] = column.at(order.at(i));
+        }
+        // 比时间轴长的部分 (格式异常) 保持原位置
+        for (int i = count; i < column.size(); ++i)
+            sorted[out++] = column.at(i);
+        column = sorted;
+    };
+
+    permute(table.timeData);
+    for (QVector<double> &column : table.valueData)
+        permute(column);
+}
+
+/**
+ * @brief [辅助函数] 为表中的每一列构建 LOD 金字塔、统计信息和分位数摘要 (在工作线程中调用)
+ * * 各列相互独立，按 CPU 核数分块并行；时间轴统计在当前线程中同时计算。
+ * 曲线、游标和统计的快速路径都在时间轴上二分查找，因此时间不单调的表先按时间排序
+ */
+static void prepareTable(SignalTable &table)
+{
+    table.stats = TableStats::compute(table.timeData);
+    if (!table.stats.timeMonotonic)
+    {
+        sortTableByTime(table);
+        // 步长统计按排序后的时间轴重新计算，timeMonotonic 仍记录源数据的情况
+        table.stats = TableStats::compute(table.timeData);
+        table.stats.timeMonotonic = false;
+    }
+
+    const int columns = table.valueData.size();
+    table.lods.resize(columns);
+    table.signalStats.resize(columns);
+    table.quantiles.resize(columns);
+
+    // 预先分离，任务中只通过裸指针写入
+    SignalLod *lods = table.lods.data();
+    SignalStats *stats = table.signalStats.data();
+    SignalQuantiles *quantiles = table.quantiles.data();
+
+    QThreadPool pool;
+    const int chunks = qMin(columns, qMax(1, QThread::idealThreadCount()));
+    for (int i = 0; i < chunks; ++i)
+    {
+        ColumnPrepareJob *job = new ColumnPrepareJob(table, lods, stats, quantiles,
+                                                     columns * i / chunks, columns * (i + 1) / chunks);
+        pool.start(job);
+    }
+
+    pool.waitForDone();
+}
+
+/**
+ * @brief [辅助函数] 汇总文件中各表的时间轴统计
+ */
+static void mergeFileStats(FileData &fileData)
+{
+    fileData.stats = TableStats();
+    for (const SignalTable &table : fileData.tables)
+        fileData.stats.merge(table.stats);
+}
+
 /**
  * @brief [辅助函数] 处理一组 MAT 变量 (pX, pX_title, pX_title2) 并构建 SignalTable
  */
@@ -173,6 +298,7 @@ static bool processMatTable(int index,
             std::copy(colPtr, colPtr + rows, table.valueData[c - 1].begin());
         }
     }
+    prepareTable(table);
     return true;
 }
 
@@ -199,6 +325,7 @@ static QString readMatString(matvar_t *variable)
 DataManager::DataManager(QObject *parent) : QObject(parent)
 {
     qRegisterMetaType<FileData>("FileData");
+    qRegisterMetaType<DerivedSignalRequest>("DerivedSignalRequest");
 }
 
 void DataManager::loadCsvFile(const QString &filePath)
@@ -314,8 +441,10 @@ void DataManager::loadCsvFile(const QString &filePath)
             table.valueData[i].append(qQNaN());
         }
     }
+    prepareTable(table);
 
     fileData.tables.append(table);
+    mergeFileStats(fileData);
     emit loadProgress(100);
     emit loadFinished(fileData);
     qDebug() << "DataManager: CSV Load finished on thread" << QThread::currentThreadId();
@@ -398,8 +527,164 @@ void DataManager::loadMatFile(const QString &filePath)
         emit loadFailed(filePath, tr("MAT file contains no valid 'p' variables."));
         return;
     }
+    mergeFileStats(fileData);
 
     emit loadProgress(100);
     emit loadFinished(fileData);
     qDebug() << "DataManager: MAT Load finished on thread" << QThread::currentThreadId();
+}
+
+/**
+ * @brief [辅助函数] 把派生信号的输入对齐到同一条时间轴
+ * * 共用同一条时间轴的输入 (数据指针相同) 作为一组，每组按列并行重采样一次；
+ * 时间轴与目标轴相同的组直接共享，不复制
+ * @param errorMessage 失败时写入错误原因
+ * @return 无法得到目标时间轴时返回 false
+ */
+static bool alignDerivedInputs(const DerivedSignalRequest &request, QVector<double> &timeData,
+                               QVector<QVector<double>> &inputs, QString *errorMessage)
+{
+    const QString noCommonRange = DataManager::tr("The input signals have no common time range.");
+
+    const int count = qMin(request.inputKeys.size(), request.inputs.size());
+    inputs = request.inputs;
+
+    // 1. 按时间轴分组
+    QVector<const double *> axisIds;
+    QVector<QVector<double>> axes;
+    QVector<QVector<int>> groups;
+    for (int i = 0; i < count; ++i)
+    {
+        const int group = axisIds.indexOf(request.inputKeys.at(i).constData());
+        if (group >= 0)
+        {
+            groups[group].append(i);
+            continue;
+        }
+        axisIds.append(request.inputKeys.at(i).constData());
+        axes.append(request.inputKeys.at(i));
+        groups.append(QVector<int>() << i);
+    }
+    if (axes.isEmpty() || (axes.size() == 1 && axes.first().isEmpty()))
+    {
+        *errorMessage = noCommonRange;
+        return false;
+    }
+    if (axes.size() == 1)
+    {
+        timeData = axes.first();
+        return true;
+    }
+
+    // 2. 目标时间轴
+    switch (request.axisMode)
+    {
+    case SignalResampler::ReferenceAxis:
+        timeData = request.inputKeys.value(request.referenceInput, axes.first());
+        break;
+    case SignalResampler::UniformGrid:
+    {
+        if (!qIsFinite(request.gridStep) || request.gridStep <= 0)
+        {
+            *errorMessage = DataManager::tr("The grid step must be a positive number.");
+            return false;
+        }
+
+        // 各时间轴的公共范围
+        double start = -qInf();
+        double end = qInf();
+        for (const QVector<double> &axis : axes)
+        {
+            if (axis.isEmpty())
+            {
+                *errorMessage = noCommonRange;
+                return false;
+            }
+            start = qMax(start, axis.first());
+            end = qMin(end, axis.last());
+        }
+        // 网格、每个重采样后的输入和输出列同时存在，在分配任何一列之前按总预算拒绝
+        const int maxPoints = SignalResampler::maxGridPoints(count + 2);
+        if (SignalResampler::gridPointCount(start, end, request.gridStep) > maxPoints)
+        {
+            *errorMessage = DataManager::tr("The grid step %1 is too small: the grid would exceed %2 points.")
+                                .arg(request.gridStep)
+                                .arg(maxPoints);
+            return false;
+        }
+        timeData = SignalResampler::uniformGrid(start, end, request.gridStep);
+        break;
+    }
+    default:
+        timeData = SignalResampler::unionAxis(axes);
+        break;
+    }
+    if (timeData.isEmpty())
+    {
+        *errorMessage = noCommonRange;
+        return false;
+    }
+
+    // 3. 逐组重采样
+    for (int g = 0; g < axes.size(); ++g)
+    {
+        if (axisIds.at(g) == timeData.constData())
+            continue;
+
+        QVector<QVector<double>> columns;
+        for (int input : groups.at(g))
+            columns.append(request.inputs.at(input));
+        const QVector<QVector<double>> resampled =
+            SignalResampler::resampleColumns(axes.at(g), columns, timeData, request.interpolation);
+        for (int k = 0; k < groups.at(g).size(); ++k)
+            inputs[groups.at(g).at(k)] = resampled.at(k);
+    }
+    return true;
+}
+
+/**
+ * @brief 计算派生信号
+ */
+void DataManager::computeDerivedSignal(const DerivedSignalRequest &request)
+{
+    const QString filePath = request.name + QStringLiteral(".derived");
+
+    DerivedExpression expression;
+    QString error;
+    if (!expression.compile(request.expression, &error))
+    {
+        emit loadFailed(filePath, error);
+        return;
+    }
+
+    // 1. 表名使用表达式文本，信号名使用派生信号名称；时间轴与输入共享或为对齐后的公共时间轴
+    SignalTable table;
+    table.name = request.expression;
+    table.headers << request.name;
+
+    QVector<QVector<double>> inputs;
+    if (!alignDerivedInputs(request, table.timeData, inputs, &error))
+    {
+        emit loadFailed(filePath, error);
+        return;
+    }
+
+    // 2. 分块并行求值
+    const int count = table.timeData.size();
+    QVector<double> values = expression.evaluateColumn(inputs, count);
+    if (values.size() != count)
+    {
+        emit loadFailed(filePath, tr("Input signals do not match the time axis."));
+        return;
+    }
+    table.valueData.append(values);
+    prepareTable(table);
+
+    FileData fileData;
+    fileData.filePath = filePath;
+    fileData.tables.append(table);
+    mergeFileStats(fileData);
+
+    emit loadFinished(fileData);
+    qDebug() << "DataManager: Derived signal" << request.name << "finished on thread" << QThread::currentThreadId();
 }
\ No newline at end of file
@@ -7,6 +7,11 @@
 #include <QStringList>
 #include <QList> 
 
+#include "signallod.h"
+#include "signalstats.h"
+#include "signalquantiles.h"
+#include "signalresampler.h"
+
 /**
  * @brief 存储一个单独的信号表 (来自 MAT 文件中的 pX)
  * * CSV 文件将被视为一个只包含单个 SignalTable 的 FileData。
@@ -17,6 +22,10 @@ struct SignalTable
     QStringList headers; // 信号头 (来自 "p1_title2")
     QVector<double> timeData;
     QVector<QVector<double>> valueData;
+    QVector<SignalLod> lods; // 每列一个 min/max 金字塔，加载时构建
+    TableStats stats;                // 时间轴统计，加载时计算
+    QVector<SignalStats> signalStats; // 每列一条统计记录，加载时计算
+    QVector<SignalQuantiles> quantiles; // 每列一组分块分位数摘要，加载时构建
 };
 Q_DECLARE_METATYPE(SignalTable)
 
@@ -28,9 +37,29 @@ struct FileData
 {
     QString filePath; // 原始文件路径 (例如 "my_data.mat")
     QList<SignalTable> tables;
+    TableStats stats; // 所有表的时间轴统计汇总
 };
 Q_DECLARE_METATYPE(FileData)
 
+/**
+ * @brief 派生信号的计算请求 (GUI 线程 -> 工作线程)
+ * * 输入列与表达式引用的信号一一对应，各带自己的时间轴 (隐式共享，不复制数据)。
+ * 所有输入共用同一条时间轴时直接求值，否则先按 axisMode 和 interpolation 重采样到公共时间轴
+ */
+struct DerivedSignalRequest
+{
+    QString name;       // 派生信号名称
+    QString expression; // 表达式文本
+    QVector<QVector<double>> inputKeys;
+    QVector<QVector<double>> inputs;
+
+    SignalResampler::AxisMode axisMode = SignalResampler::UnionAxis;
+    SignalResampler::Interpolation interpolation = SignalResampler::Linear;
+    int referenceInput = 0; // ReferenceAxis 使用的输入
+    double gridStep = 0;    // UniformGrid 的步长
+};
+Q_DECLARE_METATYPE(DerivedSignalRequest)
+
 /**
  * @brief 数据管理器 (运行在工作线程中)
  * * 负责所有耗时的 I/O 和数据处理, 避免阻塞 GUI 线程。
@@ -56,6 +85,13 @@ public slots:
      */
     void loadMatFile(const QString &filePath);
 
+    /**
+     * @brief [槽] 计算派生信号
+     * * 结果作为一个只含单表单列的虚拟文件 ("名称.derived") 通过 loadFinished 送回，
+     * 与普通文件一样构建 LOD、统计和分位数摘要
+     */
+    void computeDerivedSignal(const DerivedSignalRequest &request);
+
 signals:
     /**
      * @brief [信号] 报告加载进度
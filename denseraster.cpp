@@ -0,0 +1,556 @@
+#include "denseraster.h"
+#include "signallod.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DENSERASTER_SSE2
+#endif
+
+/**
+ * @brief [辅助] 区间最小值 (NaN 被忽略)
+ * * SSE2 的 minpd 在任一操作数为 NaN 时返回第二个操作数，累加器放在第二位即可跳过 NaN
+ */
+static inline double reduceMin(const double *v, int n, double acc)
+{
+    int i = 0;
+#ifdef DENSERASTER_SSE2
+    __m128d a0 = _mm_set1_pd(acc);
+    __m128d a1 = a0;
+    for (; i + 4 <= n; i += 4)
+    {
+        a0 = _mm_min_pd(_mm_loadu_pd(v + i), a0);
+        a1 = _mm_min_pd(_mm_loadu_pd(v + i + 2), a1);
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_min_pd(a0, a1));
+    acc = std::min(lanes[0], lanes[1]);
+#endif
+    for (; i < n; ++i)
+    {
+        if (v[i] < acc) // NaN 比较为 false
+            acc = v[i];
+    }
+    return acc;
+}
+
+/**
+ * @brief [辅助] 区间最大值 (NaN 被忽略)
+ */
+static inline double reduceMax(const double *v, int n, double acc)
+{
+    int i = 0;
+#ifdef DENSERASTER_SSE2
+    __m128d a0 = _mm_set1_pd(acc);
+    __m128d a1 = a0;
+    for (; i + 4 <= n; i += 4)
+    {
+        a0 = _mm_max_pd(_mm_loadu_pd(v + i), a0);
+        a1 = _mm_max_pd(_mm_loadu_pd(v + i + 2), a1);
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_max_pd(a0, a1));
+    acc = std::max(lanes[0], lanes[1]);
+#endif
+    for (; i < n; ++i)
+    {
+        if (v[i] > acc)
+            acc = v[i];
+    }
+    return acc;
+}
+
+/**
+ * @brief [辅助] 预乘 ARGB 按 0..255 系数缩放 (与 Qt 内部 BYTE_MUL 相同)
+ */
+static inline quint32 byteMul(quint32 x, quint32 a)
+{
+    quint32 t = (x & 0xff00ff) * a;
+    t = (t + ((t >> 8) & 0xff00ff) + 0x800080) >> 8;
+    t &= 0xff00ff;
+
+    x = ((x >> 8) & 0xff00ff) * a;
+    x = (x + ((x >> 8) & 0xff00ff) + 0x800080);
+    x &= 0xff00ff00;
+    return x | t;
+}
+
+/**
+ * @brief [辅助] 源覆盖混合一个像素
+ */
+static inline void blendPixel(quint32 &dst, quint32 src, quint32 coverage)
+{
+    if (coverage >= 255)
+    {
+        if ((src >> 24) == 255)
+        {
+            dst = src;
+            return;
+        }
+    }
+    else
+    {
+        src = byteMul(src, coverage);
+    }
+    dst = src + byteMul(dst, 255 - (src >> 24));
+}
+
+DenseRaster::Columns DenseRaster::reduce(const double *keys, const double *values, const SignalLod &lod,
+                                         int begin, int end, double keyLower, double keyPerPixel,
+                                         int width, int level, bool exact)
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    Columns columns;
+    columns.lo.fill(inf, qMax(0, width));
+    columns.hi.fill(-inf, qMax(0, width));
+    if (width <= 0 || end <= begin || keyPerPixel <= 0)
+        return columns;
+
+    double *lo = columns.lo.data();
+    double *hi = columns.hi.data();
+    const int bucketSize = level >= 0 ? lod.bucketSize(level) : 0;
+    const int bucketCount = level >= 0 ? lod.bucketCount(level) : 0;
+    const double *mins = level >= 0 ? lod.minData(level) : nullptr;
+    const double *maxs = level >= 0 ? lod.maxData(level) : nullptr;
+
+    // 只聚合落在图像内的样本，视图外的样本不参与
+    int pos = int(std::lower_bound(keys + begin, keys + end, keyLower) - keys);
+    for (int col = 0; col < width && pos < end; ++col)
+    {
+        const double boundary = keyLower + (col + 1) * keyPerPixel;
+        const int stop = int(std::lower_bound(keys + pos, keys + end, boundary) - keys);
+        if (stop <= pos)
+            continue;
+
+        double l = lo[col];
+        double h = hi[col];
+        if (level < 0)
+        {
+            l = reduceMin(values + pos, stop - pos, l);
+            h = reduceMax(values + pos, stop - pos, h);
+        }
+        else if (exact)
+        {
+            // 完整的桶走金字塔，两端不完整的部分用原始数据
+            const int firstFull = (pos + bucketSize - 1) / bucketSize;
+            const int lastFull = qMin(bucketCount, stop / bucketSize);
+            if (firstFull >= lastFull)
+            {
+                l = reduceMin(values + pos, stop - pos, l);
+                h = reduceMax(values + pos, stop - pos, h);
+            }
+            else
+            {
+                const int headEnd = firstFull * bucketSize;
+                const int tailBegin = lastFull * bucketSize;
+                l = reduceMin(values + pos, headEnd - pos, l);
+                h = reduceMax(values + pos, headEnd - pos, h);
+                l = reduceMin(mins + firstFull, lastFull - firstFull, l);
+                h = reduceMax(maxs + firstFull, lastFull - firstFull, h);
+                l = reduceMin(values + tailBegin, stop - tailBegin, l);
+                h = reduceMax(values + tailBegin, stop - tailBegin, h);
+            }
+        }
+        else
+        {
+            // 首样本落在本列的桶整体归入本列
+            int firstBucket = (pos + bucketSize - 1) / bucketSize;
+            int lastBucket = qMin(bucketCount, (stop + bucketSize - 1) / bucketSize);
+            if (lastBucket <= firstBucket)
+            {
+                // 桶比列宽：没有桶起点落在本列时取所在桶，避免列间断开
+                firstBucket = pos / bucketSize;
+                lastBucket = qMin(bucketCount, firstBucket + 1);
+            }
+            if (lastBucket > firstBucket)
+            {
+                l = reduceMin(mins + firstBucket, lastBucket - firstBucket, l);
+                h = reduceMax(maxs + firstBucket, lastBucket - firstBucket, h);
+            }
+        }
+        lo[col] = l;
+        hi[col] = h;
+        pos = stop;
+    }
+    return columns;
+}
+
+/**
+ * @brief [辅助] 每个像素列覆盖的行 (SoA 布局，便于一次处理 4 列)
+ * * [fullBegin, fullEnd) 内的行以 fullAlpha 覆盖；抗锯齿时两端各有一行部分覆盖 (行号 -1 表示没有)。
+ * first/last 为该列受影响的行范围 [first, last)，空列 first >= last。
+ */
+struct SpanCoverage
+{
+    QVector<qint32> fullBegin;
+    QVector<qint32> fullEnd;
+    QVector<qint32> fullAlpha;
+    QVector<qint32> topRow;
+    QVector<qint32> topAlpha;
+    QVector<qint32> bottomRow;
+    QVector<qint32> bottomAlpha;
+    QVector<qint32> first;
+    QVector<qint32> last;
+
+    // 按 4 的倍数分配，补齐的列为空列
+    explicit SpanCoverage(int width)
+    {
+        const int padded = (width + 3) & ~3;
+        fullBegin.fill(0, padded);
+        fullEnd.fill(0, padded);
+        fullAlpha.fill(0, padded);
+        topRow.fill(-1, padded);
+        topAlpha.fill(0, padded);
+        bottomRow.fill(-1, padded);
+        bottomAlpha.fill(0, padded);
+        first.fill(INT_MAX, padded);
+        last.fill(INT_MIN, padded);
+    }
+
+    int alphaAt(int x, int y) const
+    {
+        if (y >= fullBegin.at(x) && y < fullEnd.at(x))
+            return fullAlpha.at(x);
+        if (y == topRow.at(x))
+            return topAlpha.at(x);
+        if (y == bottomRow.at(x))
+            return bottomAlpha.at(x);
+        return 0;
+    }
+};
+
+/**
+ * @brief [辅助] 每列的线段端点按半径 radius 向左右两侧膨胀 (取邻列的并集)
+ */
+static void dilateSpans(const QVector<double> &top, const QVector<double> &bottom, int radius,
+                        QVector<double> &dilatedTop, QVector<double> &dilatedBottom)
+{
+    const int width = top.size();
+    const double inf = std::numeric_limits<double>::infinity();
+    dilatedTop.fill(inf, width);
+    dilatedBottom.fill(-inf, width);
+    for (int x = 0; x < width; ++x)
+    {
+        const int from = qMax(0, x - radius);
+        const int to = qMin(width - 1, x + radius);
+        double t = inf;
+        double b = -inf;
+        for (int k = from; k <= to; ++k)
+        {
+            t = qMin(t, top.at(k));
+            b = qMax(b, bottom.at(k));
+        }
+        dilatedTop[x] = t;
+        dilatedBottom[x] = b;
+    }
+}
+
+/**
+ * @brief [辅助] 把每列的线段 (像素行坐标，上下各延伸 halfWidth) 换算为覆盖的行
+ * @param scale 覆盖率系数 (左右两侧不足一列的线宽部分小于 1)
+ */
+static void buildCoverage(const QVector<double> &top, const QVector<double> &bottom, double halfWidth,
+                          int height, bool antialiased, double scale, SpanCoverage &coverage)
+{
+    for (int x = 0; x < top.size(); ++x)
+    {
+        if (!(top.at(x) <= bottom.at(x)))
+            continue;
+
+        const double t = qBound(-1.0, top.at(x) - halfWidth, height + 1.0);
+        const double b = qBound(-1.0, bottom.at(x) + halfWidth, height + 1.0);
+        int fullBegin = 0;
+        int fullEnd = 0;
+        int topRow = -1;
+        int bottomRow = -1;
+
+        if (!antialiased)
+        {
+            fullBegin = int(std::floor(t + 0.5));
+            fullEnd = qMax(fullBegin + 1, int(std::floor(b + 0.5)));
+        }
+        else
+        {
+            // 两端的行按覆盖率混合，中间整行覆盖
+            const int rowBegin = int(std::floor(t));
+            const int rowEnd = int(std::ceil(b));
+            if (rowEnd - rowBegin <= 1)
+            {
+                topRow = rowBegin;
+                coverage.topAlpha[x] = int(qMin(1.0, b - t) * scale * 255.0 + 0.5);
+            }
+            else
+            {
+                topRow = rowBegin;
+                bottomRow = rowEnd - 1;
+                coverage.topAlpha[x] = int(qMin(1.0, rowBegin + 1.0 - t) * scale * 255.0 + 0.5);
+                coverage.bottomAlpha[x] = int(qMin(1.0, b - bottomRow) * scale * 255.0 + 0.5);
+                fullBegin = rowBegin + 1;
+                fullEnd = rowEnd - 1;
+            }
+        }
+
+        // 裁剪到图像内
+        fullBegin = qMax(0, fullBegin);
+        fullEnd = qMin(height, fullEnd);
+        if (topRow < 0 || topRow >= height)
+            topRow = -1;
+        if (bottomRow < 0 || bottomRow >= height)
+            bottomRow = -1;
+
+        coverage.fullBegin[x] = fullBegin;
+        coverage.fullEnd[x] = fullEnd;
+        coverage.fullAlpha[x] = int(scale * 255.0 + 0.5);
+        coverage.topRow[x] = topRow;
+        coverage.bottomRow[x] = bottomRow;
+
+        int first = fullBegin < fullEnd ? fullBegin : INT_MAX;
+        int last = fullBegin < fullEnd ? fullEnd : INT_MIN;
+        if (topRow >= 0)
+        {
+            first = qMin(first, topRow);
+            last = qMax(last, topRow + 1);
+        }
+        if (bottomRow >= 0)
+        {
+            first = qMin(first, bottomRow);
+            last = qMax(last, bottomRow + 1);
+        }
+        coverage.first[x] = first;
+        coverage.last[x] = last;
+    }
+}
+
+#ifdef DENSERASTER_SSE2
+/**
+ * @brief 相邻 4 列的覆盖信息 (每列一个 32 位通道)，逐行计算前一次性载入
+ */
+struct SpanCoverage4
+{
+    __m128i fullBegin;
+    __m128i fullEnd;
+    __m128i fullAlpha;
+    __m128i topRow;
+    __m128i topAlpha;
+    __m128i bottomRow;
+    __m128i bottomAlpha;
+
+    SpanCoverage4(const SpanCoverage &c, int x)
+        : fullBegin(load(c.fullBegin, x)),
+          fullEnd(load(c.fullEnd, x)),
+          fullAlpha(load(c.fullAlpha, x)),
+          topRow(load(c.topRow, x)),
+          topAlpha(load(c.topAlpha, x)),
+          bottomRow(load(c.bottomRow, x)),
+          bottomAlpha(load(c.bottomAlpha, x))
+    {
+    }
+
+    /**
+     * @brief 第 y 行的覆盖率 (0..255)
+     */
+    __m128i alphaAt(__m128i y) const
+    {
+        // fullBegin <= y < fullEnd
+        const __m128i inFull = _mm_andnot_si128(_mm_cmpgt_epi32(fullBegin, y), _mm_cmpgt_epi32(fullEnd, y));
+        __m128i alpha = _mm_and_si128(inFull, fullAlpha);
+        alpha = _mm_or_si128(alpha, _mm_and_si128(_mm_cmpeq_epi32(y, topRow), topAlpha));
+        alpha = _mm_or_si128(alpha, _mm_and_si128(_mm_cmpeq_epi32(y, bottomRow), bottomAlpha));
+        return alpha;
+    }
+
+    static __m128i load(const QVector<qint32> &v, int x)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(v.constData() + x));
+    }
+};
+
+/**
+ * @brief [辅助] 16 位通道上的 byteMul (与标量版本逐位一致)
+ */
+static inline __m128i byteMul16(__m128i x, __m128i a)
+{
+    __m128i t = _mm_mullo_epi16(x, a);
+    t = _mm_add_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), _mm_set1_epi16(0x80));
+    return _mm_srli_epi16(t, 8);
+}
+
+/**
+ * @brief [辅助] 两个像素 (8 个 16 位通道) 的源覆盖混合
+ * @param alpha 每个像素的覆盖率，复制到该像素的 4 个通道
+ */
+static inline __m128i blend2(__m128i dst, __m128i src, __m128i alpha)
+{
+    src = byteMul16(src, alpha);
+    // 255 - 源 alpha (每个像素的第 3 个通道) 广播到该像素的 4 个通道
+    __m128i inv = _mm_sub_epi16(_mm_set1_epi16(255), src);
+    inv = _mm_shufflehi_epi16(_mm_shufflelo_epi16(inv, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    return _mm_add_epi16(src, byteMul16(dst, inv));
+}
+
+/**
+ * @brief [辅助] 按覆盖率混合相邻 4 个像素
+ * * 全部覆盖且颜色不透明时直接写入，全部未覆盖时跳过
+ */
+static inline void blend4(quint32 *dst, __m128i src4, __m128i src16, bool opaque, __m128i alpha)
+{
+    const __m128i zero = _mm_setzero_si128();
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, zero)) == 0xffff)
+        return;
+    if (opaque && _mm_movemask_epi8(_mm_cmpeq_epi32(alpha, _mm_set1_epi32(255))) == 0xffff)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), src4);
+        return;
+    }
+
+    // a0 a0 a1 a1 a2 a2 a3 a3 (16 位)，再展开为每个像素 4 个通道
+    __m128i alpha16 = _mm_packs_epi32(alpha, alpha);
+    alpha16 = _mm_unpacklo_epi16(alpha16, alpha16);
+    const __m128i alpha01 = _mm_unpacklo_epi32(alpha16, alpha16);
+    const __m128i alpha23 = _mm_unpackhi_epi32(alpha16, alpha16);
+
+    const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst));
+    const __m128i lo = blend2(_mm_unpacklo_epi8(pixels, zero), src16, alpha01);
+    const __m128i hi = blend2(_mm_unpackhi_epi8(pixels, zero), src16, alpha23);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_packus_epi16(lo, hi));
+}
+#endif
+
+void DenseRaster::fillSpans(QImage &image, const Columns &columns, double valueLower, double pixelsPerValue,
+                            const QColor &color, double penWidth, bool antialiased)
+{
+    if (image.format() != QImage::Format_ARGB32_Premultiplied)
+        return;
+
+    const int width = qMin(image.width(), columns.lo.size());
+    const int height = image.height();
+    if (width <= 0 || height <= 0)
+        return;
+
+    const quint32 src = qPremultiply(color.rgba());
+    if ((src >> 24) == 0)
+        return;
+
+    const double inf = std::numeric_limits<double>::infinity();
+    const double *lo = columns.lo.constData();
+    const double *hi = columns.hi.constData();
+
+    // 1. 值空间 -> 像素行 (上小下大)，并补上与前一列的连接
+    QVector<double> top(width, inf);
+    QVector<double> bottom(width, -inf);
+    bool prevValid = false;
+    double prevTop = 0;
+    double prevBottom = 0;
+    for (int x = 0; x < width; ++x)
+    {
+        if (!(lo[x] <= hi[x]))
+        {
+            prevValid = false; // 空列断开连接
+            continue;
+        }
+        const double t = height - (hi[x] - valueLower) * pixelsPerValue;
+        const double b = height - (lo[x] - valueLower) * pixelsPerValue;
+        top[x] = t;
+        bottom[x] = b;
+        if (prevValid)
+        {
+            top[x] = qMin(t, prevBottom);
+            bottom[x] = qMax(b, prevTop);
+        }
+        prevValid = true;
+        prevTop = t;
+        prevBottom = b;
+    }
+
+    // 2. 线宽：垂直方向两端各延伸半个线宽；水平方向按半径膨胀整列，
+    // 抗锯齿时不足一列的剩余线宽 (每侧 edge 列) 作为两侧的部分覆盖
+    const double lineWidth = qMax(1.0, penWidth);
+    const double halfWidth = lineWidth / 2.0;
+    const int radius = antialiased ? int((lineWidth - 1.0) / 2.0) : int((lineWidth - 1.0) / 2.0 + 0.5);
+    const double edge = antialiased ? (lineWidth - (2 * radius + 1)) / 2.0 : 0.0;
+
+    SpanCoverage inner(width);
+    if (radius > 0)
+    {
+        QVector<double> dilatedTop;
+        QVector<double> dilatedBottom;
+        dilateSpans(top, bottom, radius, dilatedTop, dilatedBottom);
+        buildCoverage(dilatedTop, dilatedBottom, halfWidth, height, antialiased, 1.0, inner);
+    }
+    else
+    {
+        buildCoverage(top, bottom, halfWidth, height, antialiased, 1.0, inner);
+    }
+
+    const bool hasEdge = edge * 255.0 >= 0.5;
+    SpanCoverage outer(hasEdge ? width : 0);
+    if (hasEdge)
+    {
+        QVector<double> dilatedTop;
+        QVector<double> dilatedBottom;
+        dilateSpans(top, bottom, radius + 1, dilatedTop, dilatedBottom);
+        buildCoverage(dilatedTop, dilatedBottom, halfWidth, height, antialiased, edge, outer);
+    }
+
+    // 3. 按 4 列一组写入扫描线：组内逐行连续读写 16 字节，
+    // 只遍历组内各列受影响行的并集；不足 4 列的尾部逐像素处理
+    quint32 *bits = reinterpret_cast<quint32 *>(image.bits());
+    const int stride = image.bytesPerLine() / int(sizeof(quint32));
+    int x = 0;
+
+#ifdef DENSERASTER_SSE2
+    const SpanCoverage &bounds = hasEdge ? outer : inner;
+    const bool opaque = (src >> 24) == 255;
+    const __m128i src4 = _mm_set1_epi32(int(src));
+    const __m128i src16 = _mm_unpacklo_epi8(src4, _mm_setzero_si128());
+    for (; x + 4 <= width; x += 4)
+    {
+        const int rowBegin = qMax(0, *std::min_element(bounds.first.constData() + x, bounds.first.constData() + x + 4));
+        const int rowEnd = qMin(height, *std::max_element(bounds.last.constData() + x, bounds.last.constData() + x + 4));
+        if (rowBegin >= rowEnd)
+            continue;
+
+        const SpanCoverage4 inner4(inner, x);
+        const SpanCoverage4 outer4(hasEdge ? outer : inner, x);
+        for (int y = rowBegin; y < rowEnd; ++y)
+        {
+            const __m128i row = _mm_set1_epi32(y);
+            __m128i alpha = inner4.alphaAt(row);
+            // 覆盖率不超过 255，高 16 位为 0，可用 16 位比较取较大者
+            if (hasEdge)
+                alpha = _mm_max_epi16(alpha, outer4.alphaAt(row));
+            blend4(bits + y * stride + x, src4, src16, opaque, alpha);
+        }
+    }
+#endif
+
+    for (; x < width; ++x)
+    {
+        if (hasEdge)
+        {
+            // 外层覆盖的行范围包含内层
+            const int rowBegin = qMax(0, outer.first.at(x));
+            const int rowEnd = qMin(height, outer.last.at(x));
+            for (int y = rowBegin; y < rowEnd; ++y)
+            {
+                const int alpha = qMax(inner.alphaAt(x, y), outer.alphaAt(x, y));
+                if (alpha > 0)
+                    blendPixel(bits[y * stride + x], src, quint32(alpha));
+            }
+            continue;
+        }
+
+        // 无侧边覆盖：两端的行单独混合，中间整段按同一覆盖率写入
+        if (inner.topRow.at(x) >= 0)
+            blendPixel(bits[inner.topRow.at(x) * stride + x], src, quint32(inner.topAlpha.at(x)));
+        if (inner.bottomRow.at(x) >= 0)
+            blendPixel(bits[inner.bottomRow.at(x) * stride + x], src, quint32(inner.bottomAlpha.at(x)));
+        const quint32 fullAlpha = quint32(inner.fullAlpha.at(x));
+        for (int y = inner.fullBegin.at(x); y < inner.fullEnd.at(x); ++y)
+            blendPixel(bits[y * stride + x], src, fullAlpha);
+    }
+}
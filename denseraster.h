@@ -0,0 +1,56 @@
+#ifndef DENSERASTER_H
+#define DENSERASTER_H
+
+#include <QImage>
+#include <QColor>
+#include <QVector>
+
+class SignalLod;
+
+/**
+ * @brief 密集曲线的 CPU 光栅化 (纯软件，不依赖 GPU)
+ * * 当样本数远多于像素列时，一条曲线本质上是每列一段竖直线段加上列间连接。
+ * 这里先按像素列聚合 min/max (SSE2 向量化)，再把线段直接写入 QImage 的扫描线，
+ * 绕过 QPainter 的折线描边。
+ */
+class DenseRaster
+{
+public:
+    /**
+     * @brief 每个像素列的数值范围 (值空间)；空列的 lo > hi
+     */
+    struct Columns
+    {
+        QVector<double> lo;
+        QVector<double> hi;
+    };
+
+    /**
+     * @brief 按像素列聚合原始数据或 LOD 桶
+     * @param keys 升序时间向量
+     * @param values 数值向量
+     * @param lod 对应的金字塔
+     * @param begin/end 参与聚合的样本索引范围
+     * @param keyLower 第 0 列左边缘对应的时间
+     * @param keyPerPixel 每个像素列对应的时间跨度
+     * @param width 像素列数
+     * @param level LOD 级别，-1 表示直接使用原始数据
+     * @param exact 为 true 时列边缘的不完整桶用原始数据补齐；为 false 时整桶归入首列 (更快，允许一列误差)
+     */
+    static Columns reduce(const double *keys, const double *values, const SignalLod &lod,
+                          int begin, int end, double keyLower, double keyPerPixel,
+                          int width, int level, bool exact);
+
+    /**
+     * @brief 把每列的 min/max 线段以“源覆盖”方式混合到图像中
+     * @param image ARGB32_Premultiplied 格式的目标图像 (设备像素)
+     * @param valueLower 图像底边对应的数值
+     * @param pixelsPerValue 每单位数值对应的设备像素数
+     * @param penWidth 线宽 (设备像素)
+     * @param antialiased 为 true 时线段两端及线宽的左右边缘按覆盖率混合
+     */
+    static void fillSpans(QImage &image, const Columns &columns, double valueLower, double pixelsPerValue,
+                          const QColor &color, double penWidth, bool antialiased);
+};
+
+#endif // DENSERASTER_H
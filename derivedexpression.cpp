@@ -0,0 +1,859 @@
+#include "derivedexpression.h"
+
+#include <QCoreApplication>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QtMath>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DERIVEDEXPRESSION_SSE2
+#endif
+
+typedef DerivedExpression::OpCode OpCode;
+typedef DerivedExpression::Instruction Instruction;
+typedef DerivedExpression::Kernel Kernel;
+
+// --- 1. 算子 ---
+// 可向量化的算子同时提供标量和 SSE2 两个 apply 重载，其余只提供标量版本
+
+struct AddOp
+{
+    static double apply(double a, double b) { return a + b; }
+#ifdef DERIVEDEXPRESSION_SSE2
+    static __m128d apply(__m128d a, __m128d b) { return _mm_add_pd(a, b); }
+#endif
+};
+
+struct SubOp
+{
+    static double apply(double a, double b) { return a - b; }
+#ifdef DERIVEDEXPRESSION_SSE2
+    static __m128d apply(__m128d a, __m128d b) { return _mm_sub_pd(a, b); }
+#endif
+};
+
+struct MulOp
+{
+    static double apply(double a, double b) { return a * b; }
+#ifdef DERIVEDEXPRESSION_SSE2
+    static __m128d apply(__m128d a, __m128d b) { return _mm_mul_pd(a, b); }
+#endif
+};
+
+struct DivOp
+{
+    static double apply(double a, double b) { return a / b; }
+#ifdef DERIVEDEXPRESSION_SSE2
+    static __m128d apply(__m128d a, __m128d b) { return _mm_div_pd(a, b); }
+#endif
+};
+
+struct PowOp
+{
+    static double apply(double a, double b) { return std::pow(a, b); }
+};
+
+// min/max 忽略 NaN 操作数 (与 std::fmin/fmax 一致)
+struct MinOp
+{
+    static double apply(double a, double b) { return std::fmin(a, b); }
+};
+
+struct MaxOp
+{
+    static double apply(double a, double b) { return std::fmax(a, b); }
+};
+
+struct Atan2Op
+{
+    static double apply(double a, double b) { return std::atan2(a, b); }
+};
+
+struct CopyOp
+{
+    static double apply(double a) { return a; }
+#ifdef DERIVEDEXPRESSION_SSE2
+    static __m128d apply(__m128d a) { return a; }
+#endif
+};
+
+struct NegOp
+{
+    static double apply(double a) { return -a; }
+#ifdef DERIVEDEXPRESSION_SSE2
+    static __m128d apply(__m128d a) { return _mm_xor_pd(a, _mm_set1_pd(-0.0)); }
+#endif
+};
+
+struct AbsOp
+{
+    static double apply(double a) { return std::fabs(a); }
+#ifdef DERIVEDEXPRESSION_SSE2
+    static __m128d apply(__m128d a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+#endif
+};
+
+struct SqrtOp
+{
+    static double apply(double a) { return std::sqrt(a); }
+#ifdef DERIVEDEXPRESSION_SSE2
+    static __m128d apply(__m128d a) { return _mm_sqrt_pd(a); }
+#endif
+};
+
+struct SquareOp
+{
+    static double apply(double a) { return a * a; }
+#ifdef DERIVEDEXPRESSION_SSE2
+    static __m128d apply(__m128d a) { return _mm_mul_pd(a, a); }
+#endif
+};
+
+#define DERIVED_SCALAR_UNARY_OP(Name, expr)           \
+    struct Name                                       \
+    {                                                 \
+        static double apply(double a) { return expr; } \
+    };
+
+DERIVED_SCALAR_UNARY_OP(ExpOp, std::exp(a))
+DERIVED_SCALAR_UNARY_OP(LogOp, std::log(a))
+DERIVED_SCALAR_UNARY_OP(Log10Op, std::log10(a))
+DERIVED_SCALAR_UNARY_OP(SinOp, std::sin(a))
+DERIVED_SCALAR_UNARY_OP(CosOp, std::cos(a))
+DERIVED_SCALAR_UNARY_OP(TanOp, std::tan(a))
+DERIVED_SCALAR_UNARY_OP(AsinOp, std::asin(a))
+DERIVED_SCALAR_UNARY_OP(AcosOp, std::acos(a))
+DERIVED_SCALAR_UNARY_OP(AtanOp, std::atan(a))
+DERIVED_SCALAR_UNARY_OP(FloorOp, std::floor(a))
+DERIVED_SCALAR_UNARY_OP(CeilOp, std::ceil(a))
+
+#undef DERIVED_SCALAR_UNARY_OP
+
+// --- 2. 分块核函数 ---
+// Broadcast 为 true 的操作数是常量，只读取第 0 个元素；分支在编译期消除
+
+template <bool Broadcast>
+static inline double loadScalar(const double *p, int i)
+{
+    return Broadcast ? p[0] : p[i];
+}
+
+#ifdef DERIVEDEXPRESSION_SSE2
+template <bool Broadcast>
+static inline __m128d loadVector(const double *p, int i)
+{
+    return Broadcast ? _mm_set1_pd(p[0]) : _mm_loadu_pd(p + i);
+}
+#endif
+
+template <class Op, bool BroadcastA, bool BroadcastB>
+static void binaryVectorKernel(const double *a, const double *b, double *dst, int n)
+{
+    int i = 0;
+#ifdef DERIVEDEXPRESSION_SSE2
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(dst + i, Op::apply(loadVector<BroadcastA>(a, i), loadVector<BroadcastB>(b, i)));
+#endif
+    for (; i < n; ++i)
+        dst[i] = Op::apply(loadScalar<BroadcastA>(a, i), loadScalar<BroadcastB>(b, i));
+}
+
+template <class Op, bool BroadcastA, bool BroadcastB>
+static void binaryScalarKernel(const double *a, const double *b, double *dst, int n)
+{
+    for (int i = 0; i < n; ++i)
+        dst[i] = Op::apply(loadScalar<BroadcastA>(a, i), loadScalar<BroadcastB>(b, i));
+}
+
+template <class Op, bool BroadcastA>
+static void unaryVectorKernel(const double *a, const double *, double *dst, int n)
+{
+    int i = 0;
+#ifdef DERIVEDEXPRESSION_SSE2
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(dst + i, Op::apply(loadVector<BroadcastA>(a, i)));
+#endif
+    for (; i < n; ++i)
+        dst[i] = Op::apply(loadScalar<BroadcastA>(a, i));
+}
+
+template <class Op>
+static void unaryScalarKernel(const double *a, const double *, double *dst, int n)
+{
+    for (int i = 0; i < n; ++i)
+        dst[i] = Op::apply(a[i]);
+}
+
+template <class Op>
+static Kernel vectorBinary(bool constA, bool constB)
+{
+    if (constA)
+        return &binaryVectorKernel<Op, true, false>;
+    if (constB)
+        return &binaryVectorKernel<Op, false, true>;
+    return &binaryVectorKernel<Op, false, false>;
+}
+
+template <class Op>
+static Kernel scalarBinary(bool constA, bool constB)
+{
+    if (constA)
+        return &binaryScalarKernel<Op, true, false>;
+    if (constB)
+        return &binaryScalarKernel<Op, false, true>;
+    return &binaryScalarKernel<Op, false, false>;
+}
+
+/**
+ * @brief [辅助函数] 为指令选择核函数 (一元算子的操作数不会是常量，常量已在编译时折叠；
+ * 只有作为根节点的常量经由 OpCopy 广播)
+ */
+static Kernel selectKernel(OpCode op, bool constA, bool constB)
+{
+    switch (op)
+    {
+    case DerivedExpression::OpCopy:
+        return constA ? &unaryVectorKernel<CopyOp, true> : &unaryVectorKernel<CopyOp, false>;
+    case DerivedExpression::OpNeg:
+        return &unaryVectorKernel<NegOp, false>;
+    case DerivedExpression::OpAbs:
+        return &unaryVectorKernel<AbsOp, false>;
+    case DerivedExpression::OpSqrt:
+        return &unaryVectorKernel<SqrtOp, false>;
+    case DerivedExpression::OpSquare:
+        return &unaryVectorKernel<SquareOp, false>;
+    case DerivedExpression::OpExp:
+        return &unaryScalarKernel<ExpOp>;
+    case DerivedExpression::OpLog:
+        return &unaryScalarKernel<LogOp>;
+    case DerivedExpression::OpLog10:
+        return &unaryScalarKernel<Log10Op>;
+    case DerivedExpression::OpSin:
+        return &unaryScalarKernel<SinOp>;
+    case DerivedExpression::OpCos:
+        return &unaryScalarKernel<CosOp>;
+    case DerivedExpression::OpTan:
+        return &unaryScalarKernel<TanOp>;
+    case DerivedExpression::OpAsin:
+        return &unaryScalarKernel<AsinOp>;
+    case DerivedExpression::OpAcos:
+        return &unaryScalarKernel<AcosOp>;
+    case DerivedExpression::OpAtan:
+        return &unaryScalarKernel<AtanOp>;
+    case DerivedExpression::OpFloor:
+        return &unaryScalarKernel<FloorOp>;
+    case DerivedExpression::OpCeil:
+        return &unaryScalarKernel<CeilOp>;
+    case DerivedExpression::OpAdd:
+        return vectorBinary<AddOp>(constA, constB);
+    case DerivedExpression::OpSub:
+        return vectorBinary<SubOp>(constA, constB);
+    case DerivedExpression::OpMul:
+        return vectorBinary<MulOp>(constA, constB);
+    case DerivedExpression::OpDiv:
+        return vectorBinary<DivOp>(constA, constB);
+    case DerivedExpression::OpPow:
+        return scalarBinary<PowOp>(constA, constB);
+    case DerivedExpression::OpMin:
+        return scalarBinary<MinOp>(constA, constB);
+    case DerivedExpression::OpMax:
+        return scalarBinary<MaxOp>(constA, constB);
+    case DerivedExpression::OpAtan2:
+        return scalarBinary<Atan2Op>(constA, constB);
+    default:
+        return nullptr;
+    }
+}
+
+/**
+ * @brief [辅助函数] 对常量操作数求值 (用于编译时折叠，与运行时使用同一套核函数)
+ */
+static double foldConstant(OpCode op, double a, double b)
+{
+    double out = 0;
+    selectKernel(op, false, false)(&a, &b, &out, 1);
+    return out;
+}
+
+static bool isUnary(OpCode op)
+{
+    return op >= DerivedExpression::OpNeg && op <= DerivedExpression::OpCeil;
+}
+
+// --- 3. 语法分析 ---
+
+/**
+ * @brief 语法树节点 (存放在数组中，以下标互相引用)
+ */
+struct ExpressionNode
+{
+    OpCode op;
+    double value;
+    int variable;
+    int left;
+    int right;
+};
+
+/**
+ * @brief 递归下降语法分析器
+ * * sum     := product (('+' | '-') product)*
+ *   product := unary (('*' | '/') unary)*
+ *   unary   := ('-' | '+') unary | power
+ *   power   := primary ('^' unary)?          (右结合，-x^2 = -(x^2))
+ *   primary := number | name | name '(' args ')' | '"' name '"' | '(' sum ')'
+ */
+class ExpressionParser
+{
+public:
+    ExpressionParser(const QString &text, QStringList *variables)
+        : m_text(text),
+          m_pos(0),
+          m_variables(variables)
+    {
+    }
+
+    int parse()
+    {
+        const int root = parseSum();
+        if (root < 0)
+            return -1;
+        skipSpaces();
+        if (m_pos < m_text.size())
+            return fail(QCoreApplication::translate("DerivedExpression", "多余的字符 '%1'").arg(m_text.at(m_pos)));
+        return root;
+    }
+
+    const QVector<ExpressionNode> &nodes() const { return m_nodes; }
+    QString error() const { return m_error; }
+
+private:
+    int parseSum()
+    {
+        int left = parseProduct();
+        while (left >= 0)
+        {
+            skipSpaces();
+            if (accept('+'))
+                left = makeBinary(DerivedExpression::OpAdd, left, parseProduct());
+            else if (accept('-'))
+                left = makeBinary(DerivedExpression::OpSub, left, parseProduct());
+            else
+                break;
+        }
+        return left;
+    }
+
+    int parseProduct()
+    {
+        int left = parseUnary();
+        while (left >= 0)
+        {
+            skipSpaces();
+            if (accept('*'))
+                left = makeBinary(DerivedExpression::OpMul, left, parseUnary());
+            else if (accept('/'))
+                left = makeBinary(DerivedExpression::OpDiv, left, parseUnary());
+            else
+                break;
+        }
+        return left;
+    }
+
+    int parseUnary()
+    {
+        skipSpaces();
+        if (accept('-'))
+            return makeUnary(DerivedExpression::OpNeg, parseUnary());
+        if (accept('+'))
+            return parseUnary();
+        return parsePower();
+    }
+
+    int parsePower()
+    {
+        const int base = parsePrimary();
+        if (base < 0)
+            return -1;
+        skipSpaces();
+        if (accept('^'))
+            return makeBinary(DerivedExpression::OpPow, base, parseUnary());
+        return base;
+    }
+
+    int parsePrimary()
+    {
+        skipSpaces();
+        if (m_pos >= m_text.size())
+            return fail(QCoreApplication::translate("DerivedExpression", "表达式不完整"));
+
+        const QChar c = m_text.at(m_pos);
+        if (c == '(')
+        {
+            ++m_pos;
+            const int inner = parseSum();
+            if (inner < 0)
+                return -1;
+            skipSpaces();
+            if (!accept(')'))
+                return fail(QCoreApplication::translate("DerivedExpression", "缺少 ')'"));
+            return inner;
+        }
+        if (c == '"')
+        {
+            const int end = m_text.indexOf('"', m_pos + 1);
+            if (end < 0)
+                return fail(QCoreApplication::translate("DerivedExpression", "缺少结束的双引号"));
+            const QString name = m_text.mid(m_pos + 1, end - m_pos - 1);
+            m_pos = end + 1;
+            return makeVariable(name);
+        }
+        if (c.isDigit() || (c == '.' && m_pos + 1 < m_text.size() && m_text.at(m_pos + 1).isDigit()))
+            return parseNumber();
+        if (c.isLetter() || c == '_')
+            return parseName();
+
+        return fail(QCoreApplication::translate("DerivedExpression", "无法识别的字符 '%1'").arg(c));
+    }
+
+    int parseNumber()
+    {
+        const int start = m_pos;
+        while (m_pos < m_text.size() && (m_text.at(m_pos).isDigit() || m_text.at(m_pos) == '.'))
+            ++m_pos;
+        if (m_pos < m_text.size() && (m_text.at(m_pos) == 'e' || m_text.at(m_pos) == 'E'))
+        {
+            int p = m_pos + 1;
+            if (p < m_text.size() && (m_text.at(p) == '+' || m_text.at(p) == '-'))
+                ++p;
+            if (p < m_text.size() && m_text.at(p).isDigit())
+            {
+                m_pos = p;
+                while (m_pos < m_text.size() && m_text.at(m_pos).isDigit())
+                    ++m_pos;
+            }
+        }
+
+        bool ok = false;
+        const double value = m_text.mid(start, m_pos - start).toDouble(&ok);
+        if (!ok)
+        {
+            m_pos = start;
+            return fail(QCoreApplication::translate("DerivedExpression", "无效的数字"));
+        }
+        return makeConstant(value);
+    }
+
+    int parseName()
+    {
+        const int start = m_pos;
+        while (m_pos < m_text.size())
+        {
+            const QChar c = m_text.at(m_pos);
+            if (!c.isLetterOrNumber() && c != '_' && c != '.')
+                break;
+            ++m_pos;
+        }
+        const QString name = m_text.mid(start, m_pos - start);
+
+        skipSpaces();
+        if (m_pos < m_text.size() && m_text.at(m_pos) == '(')
+        {
+            ++m_pos;
+            return parseCall(name, start);
+        }
+        if (name == QLatin1String("pi"))
+            return makeConstant(M_PI);
+        return makeVariable(name);
+    }
+
+    int parseCall(const QString &name, int namePos)
+    {
+        static const struct
+        {
+            const char *name;
+            OpCode op;
+            int arity;
+        } functions[] = {
+            {"sqrt", DerivedExpression::OpSqrt, 1},
+            {"abs", DerivedExpression::OpAbs, 1},
+            {"exp", DerivedExpression::OpExp, 1},
+            {"log", DerivedExpression::OpLog, 1},
+            {"log10", DerivedExpression::OpLog10, 1},
+            {"sin", DerivedExpression::OpSin, 1},
+            {"cos", DerivedExpression::OpCos, 1},
+            {"tan", DerivedExpression::OpTan, 1},
+            {"asin", DerivedExpression::OpAsin, 1},
+            {"acos", DerivedExpression::OpAcos, 1},
+            {"atan", DerivedExpression::OpAtan, 1},
+            {"floor", DerivedExpression::OpFloor, 1},
+            {"ceil", DerivedExpression::OpCeil, 1},
+            {"min", DerivedExpression::OpMin, 2},
+            {"max", DerivedExpression::OpMax, 2},
+            {"atan2", DerivedExpression::OpAtan2, 2},
+            {"pow", DerivedExpression::OpPow, 2},
+        };
+
+        for (const auto &function : functions)
+        {
+            if (name != QLatin1String(function.name))
+                continue;
+
+            int args[2] = {-1, -1};
+            for (int i = 0; i < function.arity; ++i)
+            {
+                if (i > 0)
+                {
+                    skipSpaces();
+                    if (!accept(','))
+                        return fail(QCoreApplication::translate("DerivedExpression", "%1 需要 %2 个参数").arg(name).arg(function.arity));
+                }
+                args[i] = parseSum();
+                if (args[i] < 0)
+                    return -1;
+            }
+            skipSpaces();
+            if (!accept(')'))
+                return fail(QCoreApplication::translate("DerivedExpression", "%1 需要 %2 个参数").arg(name).arg(function.arity));
+
+            return function.arity == 1 ? makeUnary(function.op, args[0]) : makeBinary(function.op, args[0], args[1]);
+        }
+
+        m_pos = namePos;
+        return fail(QCoreApplication::translate("DerivedExpression", "未知函数 '%1'").arg(name));
+    }
+
+    // --- 节点构造 (同时做常量折叠和特化) ---
+
+    int addNode(OpCode op, double value, int variable, int left, int right)
+    {
+        ExpressionNode node;
+        node.op = op;
+        node.value = value;
+        node.variable = variable;
+        node.left = left;
+        node.right = right;
+        m_nodes.append(node);
+        return m_nodes.size() - 1;
+    }
+
+    int makeConstant(double value)
+    {
+        return addNode(DerivedExpression::OpConstant, value, -1, -1, -1);
+    }
+
+    int makeVariable(const QString &name)
+    {
+        if (name.trimmed().isEmpty())
+            return fail(QCoreApplication::translate("DerivedExpression", "信号名为空"));
+        int index = m_variables->indexOf(name);
+        if (index < 0)
+        {
+            m_variables->append(name);
+            index = m_variables->size() - 1;
+        }
+        return addNode(DerivedExpression::OpVariable, 0, index, -1, -1);
+    }
+
+    bool isConstant(int node, double *value = nullptr) const
+    {
+        if (m_nodes.at(node).op != DerivedExpression::OpConstant)
+            return false;
+        if (value)
+            *value = m_nodes.at(node).value;
+        return true;
+    }
+
+    int makeUnary(OpCode op, int operand)
+    {
+        if (operand < 0)
+            return -1;
+        double value = 0;
+        if (isConstant(operand, &value))
+            return makeConstant(foldConstant(op, value, 0));
+        return addNode(op, 0, -1, operand, -1);
+    }
+
+    int makeBinary(OpCode op, int left, int right)
+    {
+        if (left < 0 || right < 0)
+            return -1;
+
+        double a = 0;
+        double b = 0;
+        const bool constLeft = isConstant(left, &a);
+        const bool constRight = isConstant(right, &b);
+        if (constLeft && constRight)
+            return makeConstant(foldConstant(op, a, b));
+
+        // x^2、x^0.5、x^1 特化为更便宜的算子
+        if (op == DerivedExpression::OpPow && constRight)
+        {
+            if (b == 2.0)
+                return addNode(DerivedExpression::OpSquare, 0, -1, left, -1);
+            if (b == 0.5)
+                return addNode(DerivedExpression::OpSqrt, 0, -1, left, -1);
+            if (b == 1.0)
+                return left;
+        }
+        return addNode(op, 0, -1, left, right);
+    }
+
+    // --- 词法辅助 ---
+
+    void skipSpaces()
+    {
+        while (m_pos < m_text.size() && m_text.at(m_pos).isSpace())
+            ++m_pos;
+    }
+
+    bool accept(char c)
+    {
+        if (m_pos < m_text.size() && m_text.at(m_pos) == QLatin1Char(c))
+        {
+            ++m_pos;
+            return true;
+        }
+        return false;
+    }
+
+    int fail(const QString &message)
+    {
+        if (m_error.isEmpty())
+            m_error = QCoreApplication::translate("DerivedExpression", "第 %1 个字符: %2").arg(m_pos + 1).arg(message);
+        return -1;
+    }
+
+    QString m_text;
+    int m_pos;
+    QStringList *m_variables;
+    QVector<ExpressionNode> m_nodes;
+    QString m_error;
+};
+
+// --- 4. 代码生成 ---
+
+/**
+ * @brief [辅助函数] 把子树编译为指令，结果放在 depth 号寄存器
+ * * 寄存器按栈深度分配，寄存器数等于最大深度 + 1；信号叶子不占寄存器，直接以输入列为操作数
+ * @return 结果所在的操作数编码 (寄存器 depth 或输入列)
+ */
+static int generate(const QVector<ExpressionNode> &nodes, int index, int depth,
+                    QVector<Instruction> &program, int &registerCount)
+{
+    const ExpressionNode &node = nodes.at(index);
+    if (node.op == DerivedExpression::OpVariable)
+        return -(node.variable + 1);
+
+    Instruction ins;
+    ins.op = node.op;
+    ins.dst = depth;
+    ins.constant = 0;
+
+    if (isUnary(node.op))
+    {
+        ins.a = generate(nodes, node.left, depth, program, registerCount);
+        ins.b = DerivedExpression::kConstantOperand;
+        ins.kernel = selectKernel(node.op, false, false);
+    }
+    else
+    {
+        const ExpressionNode &left = nodes.at(node.left);
+        const ExpressionNode &right = nodes.at(node.right);
+        if (left.op == DerivedExpression::OpConstant)
+        {
+            ins.constant = left.value;
+            ins.a = DerivedExpression::kConstantOperand;
+            ins.b = generate(nodes, node.right, depth, program, registerCount);
+        }
+        else if (right.op == DerivedExpression::OpConstant)
+        {
+            ins.constant = right.value;
+            ins.a = generate(nodes, node.left, depth, program, registerCount);
+            ins.b = DerivedExpression::kConstantOperand;
+        }
+        else
+        {
+            ins.a = generate(nodes, node.left, depth, program, registerCount);
+            // 左操作数占用了 depth 号寄存器时，右操作数使用下一个
+            ins.b = generate(nodes, node.right, ins.a >= 0 ? depth + 1 : depth, program, registerCount);
+        }
+        ins.kernel = selectKernel(node.op, ins.a == DerivedExpression::kConstantOperand,
+                                  ins.b == DerivedExpression::kConstantOperand);
+    }
+
+    registerCount = qMax(registerCount, depth + 1);
+    program.append(ins);
+    return depth;
+}
+
+/**
+ * @brief [辅助函数] 指令操作数对应的数据起始地址
+ */
+static inline const double *operandData(int code, const double *constant, double *registers,
+                                        const QVector<const double *> &inputs, int start)
+{
+    if (code == DerivedExpression::kConstantOperand)
+        return constant;
+    if (code >= 0)
+        return registers + code * DerivedExpression::kBlockSize;
+    return inputs.at(-code - 1) + start;
+}
+
+/**
+ * @brief 一段块对齐的样本区间的求值任务 (在线程池中运行)
+ */
+class DerivedEvaluateJob : public QRunnable
+{
+public:
+    DerivedEvaluateJob(const DerivedExpression &expression, const QVector<const double *> &inputs,
+                       double *out, int begin, int end)
+        : m_expression(expression),
+          m_inputs(inputs),
+          m_out(out),
+          m_begin(begin),
+          m_end(end)
+    {
+    }
+
+    void run() override
+    {
+        m_expression.evaluate(m_inputs, m_out, m_begin, m_end);
+    }
+
+private:
+    const DerivedExpression &m_expression;
+    QVector<const double *> m_inputs;
+    double *m_out;
+    int m_begin;
+    int m_end;
+};
+
+// --- 5. DerivedExpression ---
+
+DerivedExpression::DerivedExpression()
+    : m_registerCount(0),
+      m_valid(false)
+{
+}
+
+bool DerivedExpression::compile(const QString &text, QString *errorMessage)
+{
+    m_text = text;
+    m_variables.clear();
+    m_program.clear();
+    m_registerCount = 0;
+    m_valid = false;
+
+    ExpressionParser parser(text, &m_variables);
+    const int root = parser.parse();
+    if (root < 0)
+    {
+        if (errorMessage)
+            *errorMessage = parser.error();
+        m_variables.clear();
+        return false;
+    }
+
+    const QVector<ExpressionNode> &nodes = parser.nodes();
+    const ExpressionNode &rootNode = nodes.at(root);
+    if (rootNode.op == OpConstant || rootNode.op == OpVariable)
+    {
+        // 根节点是叶子：复制输入列或广播常量
+        Instruction ins;
+        ins.op = OpCopy;
+        ins.dst = 0;
+        ins.constant = rootNode.value;
+        ins.a = rootNode.op == OpConstant ? int(kConstantOperand) : -(rootNode.variable + 1);
+        ins.b = kConstantOperand;
+        ins.kernel = selectKernel(OpCopy, rootNode.op == OpConstant, false);
+        m_program.append(ins);
+        m_registerCount = 1;
+    }
+    else
+    {
+        generate(nodes, root, 0, m_program, m_registerCount);
+    }
+
+    m_valid = true;
+    return true;
+}
+
+bool DerivedExpression::isValid() const
+{
+    return m_valid;
+}
+
+QString DerivedExpression::text() const
+{
+    return m_text;
+}
+
+const QStringList &DerivedExpression::variables() const
+{
+    return m_variables;
+}
+
+void DerivedExpression::evaluate(const QVector<const double *> &inputs, double *out, int begin, int end) const
+{
+    if (!m_valid || end <= begin || inputs.size() < m_variables.size())
+        return;
+
+    // 每个寄存器一块；最后一条指令直接写入输出列
+    QVector<double> registerData(m_registerCount * kBlockSize);
+    double *registers = registerData.data();
+    const int last = m_program.size() - 1;
+
+    for (int start = begin; start < end; start += kBlockSize)
+    {
+        const int n = qMin(int(kBlockSize), end - start);
+        for (int i = 0; i <= last; ++i)
+        {
+            const Instruction &ins = m_program.at(i);
+            double *dst = (i == last) ? out + start : registers + ins.dst * kBlockSize;
+            ins.kernel(operandData(ins.a, &ins.constant, registers, inputs, start),
+                       operandData(ins.b, &ins.constant, registers, inputs, start),
+                       dst, n);
+        }
+    }
+}
+
+QVector<double> DerivedExpression::evaluateColumn(const QVector<QVector<double>> &inputs, int count) const
+{
+    QVector<double> result;
+    if (!m_valid || inputs.size() < m_variables.size() || count <= 0)
+        return result;
+
+    QVector<const double *> data;
+    data.reserve(inputs.size());
+    for (const QVector<double> &column : inputs)
+    {
+        if (column.size() < count)
+            return result;
+        data.append(column.constData());
+    }
+
+    result.resize(count);
+    double *out = result.data();
+
+    // 按块数均分给各线程，区间边界与块对齐
+    const int blocks = (count + kBlockSize - 1) / kBlockSize;
+    const int chunks = qMin(blocks, qMax(1, QThread::idealThreadCount()));
+    if (chunks <= 1)
+    {
+        evaluate(data, out, 0, count);
+        return result;
+    }
+
+    QThreadPool pool;
+    for (int i = 0; i < chunks; ++i)
+    {
+        const int begin = blocks * i / chunks * kBlockSize;
+        const int end = qMin(count, blocks * (i + 1) / chunks * kBlockSize);
+        pool.start(new DerivedEvaluateJob(*this, data, out, begin, end));
+    }
+    pool.waitForDone();
+    return result;
+}
@@ -0,0 +1,118 @@
+#ifndef DERIVEDEXPRESSION_H
+#define DERIVEDEXPRESSION_H
+
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <climits>
+
+/**
+ * @brief 派生信号表达式
+ * * 把 "speed*3.6"、"sqrt(ax^2+ay^2)" 这样的表达式编译为寄存器形式的求值计划：
+ * 常量在编译时折叠，信号直接作为操作数引用 (不复制)，x^2、x^0.5 等特化为专用算子。
+ * 求值按 kBlockSize 个样本分块进行，每个寄存器只是一块大小的缓冲区，
+ * 不产生整列的中间结果；每个算子是对一块连续内存的紧凑循环 (+ - * / sqrt 等使用 SSE2)。
+ *
+ * 语法：数字、+ - * / ^、括号、函数 (sqrt abs exp log log10 sin cos tan asin acos atan
+ * floor ceil min max atan2 pow) 和常量 pi。信号名为标识符，含空格或运算符的信号名用双引号括起来。
+ */
+class DerivedExpression
+{
+public:
+    static const int kBlockSize = 1024;
+
+    DerivedExpression();
+
+    /**
+     * @brief 编译表达式
+     * @param errorMessage 失败时写入错误原因 (含字符位置)
+     */
+    bool compile(const QString &text, QString *errorMessage = nullptr);
+
+    bool isValid() const;
+    QString text() const;
+
+    /**
+     * @brief 表达式引用的信号名 (去重，按首次出现的顺序)
+     */
+    const QStringList &variables() const;
+
+    /**
+     * @brief 在当前线程中分块求值样本区间 [begin, end)
+     * @param inputs 与 variables() 一一对应的数据列起始地址
+     * @param out 输出列起始地址 (写入 out[begin..end))
+     */
+    void evaluate(const QVector<const double *> &inputs, double *out, int begin, int end) const;
+
+    /**
+     * @brief 在线程池中按块区间并行求值整列
+     * @param inputs 与 variables() 一一对应的数据列，长度至少为 count
+     */
+    QVector<double> evaluateColumn(const QVector<QVector<double>> &inputs, int count) const;
+
+    /**
+     * @brief 算子 (同时用于语法树和求值计划)
+     */
+    enum OpCode
+    {
+        // 叶子
+        OpConstant = 0,
+        OpVariable,
+        OpCopy,
+        // 一元
+        OpNeg,
+        OpAbs,
+        OpSqrt,
+        OpSquare,
+        OpExp,
+        OpLog,
+        OpLog10,
+        OpSin,
+        OpCos,
+        OpTan,
+        OpAsin,
+        OpAcos,
+        OpAtan,
+        OpFloor,
+        OpCeil,
+        // 二元
+        OpAdd,
+        OpSub,
+        OpMul,
+        OpDiv,
+        OpPow,
+        OpMin,
+        OpMax,
+        OpAtan2
+    };
+
+    /**
+     * @brief 对一块连续样本执行一个算子：dst[i] = op(a[i], b[i])，常量操作数只读取 a[0] 或 b[0]
+     */
+    typedef void (*Kernel)(const double *a, const double *b, double *dst, int n);
+
+    /**
+     * @brief 求值计划中的一条指令
+     * * 操作数编码：>= 0 为寄存器序号，< 0 为输入列 -(k+1)，kConstantOperand 表示使用 constant
+     */
+    struct Instruction
+    {
+        OpCode op;
+        Kernel kernel; // 编译时按算子和常量操作数位置选定
+        int dst;
+        int a;
+        int b;
+        double constant;
+    };
+
+    static const int kConstantOperand = INT_MIN;
+
+private:
+    QString m_text;
+    QStringList m_variables;
+    QVector<Instruction> m_program; // 最后一条指令写入 0 号寄存器，即输出
+    int m_registerCount;
+    bool m_valid;
+};
+
+#endif // DERIVEDEXPRESSION_H
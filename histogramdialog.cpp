@@ -0,0 +1,96 @@
+#include "histogramdialog.h"
+#include "qcustomplot.h"
+
+#include <QSpinBox>
+#include <QLabel>
+#include <QFormLayout>
+#include <QVBoxLayout>
+#include <QtNumeric>
+
+HistogramDialog::HistogramDialog(const QString &title, const QuantileDigest &digest, QWidget *parent)
+    : QDialog(parent), m_digest(digest)
+{
+    setWindowTitle(title);
+    setAttribute(Qt::WA_DeleteOnClose);
+
+    //  1. 创建控件
+    m_plot = new QCustomPlot(this);
+    m_plot->setMinimumSize(480, 300);
+    m_plot->xAxis->setLabel(tr("数值"));
+    m_plot->yAxis->setLabel(tr("样本数"));
+
+    m_bars = new QCPBars(m_plot->xAxis, m_plot->yAxis);
+    m_bars->setPen(QPen(QColor("#0072bd")));
+    m_bars->setBrush(QColor(0, 114, 189, 120));
+
+    m_binSpinBox = new QSpinBox(this);
+    m_binSpinBox->setRange(2, 1000);
+    m_binSpinBox->setValue(50);
+
+    m_summaryLabel = new QLabel(this);
+    m_summaryLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    //  2. 布局
+    QFormLayout *formLayout = new QFormLayout;
+    formLayout->addRow(tr("箱数:"), m_binSpinBox);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->addWidget(m_plot, 1);
+    mainLayout->addLayout(formLayout);
+    mainLayout->addWidget(m_summaryLabel);
+
+    //  3. 连接
+    connect(m_binSpinBox, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &HistogramDialog::rebuildBins);
+
+    if (m_digest.isEmpty())
+    {
+        m_summaryLabel->setText(tr("区间内没有有限值样本"));
+    }
+    else
+    {
+        m_summaryLabel->setText(tr("样本数: %1    P50: %2    P95: %3    P99: %4")
+                                    .arg(qint64(m_digest.count()))
+                                    .arg(m_digest.quantile(0.50), 0, 'g', 6)
+                                    .arg(m_digest.quantile(0.95), 0, 'g', 6)
+                                    .arg(m_digest.quantile(0.99), 0, 'g', 6));
+    }
+    rebuildBins();
+}
+
+/**
+ * @brief [槽] 在 [min, max] 上等宽分箱，每箱样本数 = count·(CDF(右边界) - CDF(左边界))
+ */
+void HistogramDialog::rebuildBins()
+{
+    QVector<double> centers;
+    QVector<double> counts;
+
+    if (!m_digest.isEmpty())
+    {
+        const int bins = m_binSpinBox->value();
+        const double lo = m_digest.min();
+        double width = (m_digest.max() - lo) / bins;
+        // 所有样本相同时退化为单根柱
+        const int used = width > 0 ? bins : 1;
+        if (width <= 0)
+            width = 1.0;
+
+        centers.reserve(used);
+        counts.reserve(used);
+        double previous = 0.0;
+        for (int i = 0; i < used; ++i)
+        {
+            const double right = (i + 1 == used) ? m_digest.max() : lo + width * (i + 1);
+            const double current = (i + 1 == used) ? 1.0 : m_digest.cdf(right);
+            centers.append(lo + width * (i + 0.5));
+            counts.append(qMax(0.0, current - previous) * m_digest.count());
+            previous = current;
+        }
+        m_bars->setWidth(width);
+    }
+
+    m_bars->setData(centers, counts, true);
+    m_plot->rescaleAxes();
+    m_plot->yAxis->setRangeLower(0);
+    m_plot->replot();
+}
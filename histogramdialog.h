@@ -0,0 +1,47 @@
+#ifndef HISTOGRAMDIALOG_H
+#define HISTOGRAMDIALOG_H
+
+#include <QDialog>
+
+#include "signalquantiles.h"
+
+// 向前声明
+class QCustomPlot;
+class QCPBars;
+class QSpinBox;
+class QLabel;
+
+/**
+ * @brief 信号直方图对话框 (非模态)
+ * * 直方图由分块分位数摘要的累积分布在各箱边界处的差值得到，不需要遍历区间内的全部样本；
+ * 改变箱数只需重新求值 CDF。
+ */
+class HistogramDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param title 窗口标题 (信号名称及区间)
+     * @param digest 要显示的样本区间的摘要
+     * @param parent 父窗口
+     */
+    HistogramDialog(const QString &title, const QuantileDigest &digest, QWidget *parent = nullptr);
+
+private slots:
+    /**
+     * @brief [槽] 箱数变化时重新分箱
+     */
+    void rebuildBins();
+
+private:
+    QuantileDigest m_digest;
+
+    QCustomPlot *m_plot;
+    QCPBars *m_bars;
+    QSpinBox *m_binSpinBox;
+    QLabel *m_summaryLabel;
+};
+
+#endif // HISTOGRAMDIALOG_H
@@ -0,0 +1,146 @@
+#include "interactionquality.h"
+#include "qcustomplot.h"
+#include "signalgraph.h"
+#include "renderscheduler.h"
+#include "plotrasterizer.h"
+
+#include <QTimer>
+
+InteractionQuality::InteractionQuality(QList<QCustomPlot *> *plotWidgets, RenderScheduler *scheduler,
+                                       PlotRasterizer *rasterizer, QObject *parent)
+    : QObject(parent),
+      m_plotWidgets(plotWidgets),
+      m_scheduler(scheduler),
+      m_rasterizer(rasterizer),
+      m_idleTimer(nullptr),
+      m_interacting(false)
+{
+    m_idleTimer = new QTimer(this);
+    m_idleTimer->setSingleShot(true);
+    m_idleTimer->setInterval(m_settings.idleDelayMs);
+    connect(m_idleTimer, &QTimer::timeout, this, &InteractionQuality::onIdleTimeout);
+}
+
+InteractionQuality::~InteractionQuality()
+{
+}
+
+InteractionQuality::Settings InteractionQuality::settings() const
+{
+    return m_settings;
+}
+
+void InteractionQuality::setSettings(const Settings &settings)
+{
+    m_settings = settings;
+    m_settings.idleDelayMs = qMax(0, m_settings.idleDelayMs);
+    m_settings.draftLodFactor = qMax(1.0, m_settings.draftLodFactor);
+    m_idleTimer->setInterval(m_settings.idleDelayMs);
+
+    // 禁用或参数变化时立即回到完整质量，下次交互按新参数进入草稿
+    if (m_interacting)
+    {
+        m_idleTimer->stop();
+        onIdleTimeout();
+    }
+}
+
+bool InteractionQuality::isInteracting() const
+{
+    return m_interacting;
+}
+
+void InteractionQuality::attachPlot(QCustomPlot *plot)
+{
+    if (!plot || m_attachedPlots.contains(plot))
+        return;
+
+    m_attachedPlots.insert(plot);
+    connect(plot, &QCustomPlot::mouseMove, this, &InteractionQuality::onPlotMouseMove);
+    connect(plot, &QCustomPlot::mouseWheel, this, &InteractionQuality::onPlotMouseWheel);
+    connect(plot, &QObject::destroyed, this, &InteractionQuality::onPlotDestroyed);
+}
+
+/**
+ * @brief [槽] 鼠标移动：仅按下左键且处于平移状态时视为交互
+ * * 拖动游标时 CursorManager 会关闭 iRangeDrag，因此不会误判
+ */
+void InteractionQuality::onPlotMouseMove(QMouseEvent *event)
+{
+    QCustomPlot *plot = qobject_cast<QCustomPlot *>(sender());
+    if (!plot || !(event->buttons() & Qt::LeftButton) || !plot->interactions().testFlag(QCP::iRangeDrag))
+        return;
+
+    noteInteraction();
+}
+
+/**
+ * @brief [槽] 滚轮缩放
+ */
+void InteractionQuality::onPlotMouseWheel(QWheelEvent *event)
+{
+    Q_UNUSED(event);
+    QCustomPlot *plot = qobject_cast<QCustomPlot *>(sender());
+    if (!plot || !plot->interactions().testFlag(QCP::iRangeZoom))
+        return;
+
+    noteInteraction();
+}
+
+/**
+ * @brief [槽] 空闲超时：恢复完整质量并统一重绘
+ */
+void InteractionQuality::onIdleTimeout()
+{
+    if (!m_interacting)
+        return;
+
+    m_interacting = false;
+    applyQuality(false);
+    emit interactingChanged(false);
+}
+
+void InteractionQuality::onPlotDestroyed(QObject *object)
+{
+    m_attachedPlots.remove(static_cast<QCustomPlot *>(object));
+}
+
+/**
+ * @brief [辅助] 记录一次交互：首次进入草稿模式，并重新开始空闲计时
+ * * QCustomPlot 先发出鼠标信号再处理平移/缩放，因此本次交互引起的重绘已是草稿质量
+ */
+void InteractionQuality::noteInteraction()
+{
+    if (!m_settings.enabled)
+        return;
+
+    m_idleTimer->start();
+    if (m_interacting)
+        return;
+
+    m_interacting = true;
+    applyQuality(true);
+    emit interactingChanged(true);
+}
+
+/**
+ * @brief [辅助] 切换所有子图的曲线与离屏渲染质量
+ */
+void InteractionQuality::applyQuality(bool draft)
+{
+    for (QCustomPlot *plot : *m_plotWidgets)
+    {
+        for (int i = 0; i < plot->graphCount(); ++i)
+        {
+            if (SignalGraph *graph = qobject_cast<SignalGraph *>(plot->graph(i)))
+                graph->setDraftMode(draft, m_settings.draftLodFactor, m_settings.draftAntialiasing);
+        }
+
+        // 进入草稿时由交互本身触发重绘；退出时补一次完整质量的重绘
+        if (!draft)
+            m_scheduler->requestReplot(plot);
+    }
+
+    if (m_rasterizer)
+        m_rasterizer->setDraftMode(draft, m_settings.draftLodFactor);
+}
@@ -0,0 +1,74 @@
+#ifndef INTERACTIONQUALITY_H
+#define INTERACTIONQUALITY_H
+
+#include <QObject>
+#include <QList>
+#include <QSet>
+
+// 向前声明
+class QCustomPlot;
+class QMouseEvent;
+class QWheelEvent;
+class QTimer;
+class RenderScheduler;
+class PlotRasterizer;
+
+/**
+ * @brief 交互感知的渲染质量控制
+ * * 用户拖拽平移或滚轮缩放时，所有子图切换为草稿质量 (更粗的 LOD、无抗锯齿，
+ * 离屏渲染只做粗略任务)；最后一次交互后经过短暂空闲，再统一恢复完整质量并重绘一次。
+ * 拖动游标不算作交互 (此时数据图层不重绘)。
+ */
+class InteractionQuality : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 可配置的阈值
+     */
+    struct Settings
+    {
+        bool enabled = true;
+        int idleDelayMs = 150;          // 最后一次交互后恢复完整质量的延迟
+        double draftLodFactor = 4.0;    // 草稿 LOD 的桶宽 (像素)
+        bool draftAntialiasing = false; // 草稿绘制是否抗锯齿
+    };
+
+    explicit InteractionQuality(QList<QCustomPlot *> *plotWidgets, RenderScheduler *scheduler,
+                                PlotRasterizer *rasterizer, QObject *parent = nullptr);
+    ~InteractionQuality();
+
+    Settings settings() const;
+    void setSettings(const Settings &settings);
+
+    bool isInteracting() const;
+
+    /**
+     * @brief 监听子图的鼠标交互 (在 setupPlotInteractions 中调用)
+     */
+    void attachPlot(QCustomPlot *plot);
+
+signals:
+    void interactingChanged(bool interacting);
+
+private slots:
+    void onPlotMouseMove(QMouseEvent *event);
+    void onPlotMouseWheel(QWheelEvent *event);
+    void onIdleTimeout();
+    void onPlotDestroyed(QObject *object);
+
+private:
+    void noteInteraction();
+    void applyQuality(bool draft);
+
+    QList<QCustomPlot *> *m_plotWidgets;
+    RenderScheduler *m_scheduler;
+    PlotRasterizer *m_rasterizer;
+    QTimer *m_idleTimer;
+    Settings m_settings;
+    bool m_interacting;
+    QSet<QCustomPlot *> m_attachedPlots;
+};
+
+#endif // INTERACTIONQUALITY_H
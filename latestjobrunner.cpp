@@ -0,0 +1,120 @@
+#include "latestjobrunner.h"
+
+#include <QThreadPool>
+#include <QRunnable>
+
+/**
+ * @brief 包装任务：运行结束后通知调度器 (在线程池中运行)
+ */
+class TrackedJob : public QRunnable
+{
+public:
+    TrackedJob(LatestJobRunner *runner, QRunnable *job)
+        : m_runner(runner),
+          m_job(job)
+    {
+    }
+
+    ~TrackedJob()
+    {
+        delete m_job;
+    }
+
+    void run() override
+    {
+        m_job->run();
+        emit m_runner->jobFinished();
+    }
+
+private:
+    LatestJobRunner *m_runner;
+    QRunnable *m_job;
+};
+
+LatestJobRunner::LatestJobRunner(const JobFactory &factory, QObject *parent)
+    : QObject(parent),
+      m_factory(factory),
+      m_pool(nullptr),
+      m_generation(0),
+      m_validFrom(0),
+      m_running(false),
+      m_pending(false)
+{
+    // 单线程即可：同一时刻最多只有一个任务
+    m_pool = new QThreadPool(this);
+    m_pool->setMaxThreadCount(1);
+
+    connect(this, &LatestJobRunner::jobFinished, this, &LatestJobRunner::onJobFinished, Qt::QueuedConnection);
+}
+
+LatestJobRunner::~LatestJobRunner()
+{
+    cancelAndWait();
+}
+
+int LatestJobRunner::request()
+{
+    m_generation++;
+    if (m_running)
+        m_pending = true;
+    else
+        start();
+    return m_generation;
+}
+
+void LatestJobRunner::invalidate()
+{
+    m_validFrom = ++m_generation;
+    m_pending = false;
+}
+
+bool LatestJobRunner::isCurrent(int generation) const
+{
+    return generation >= m_validFrom;
+}
+
+bool LatestJobRunner::isLatest(int generation) const
+{
+    return generation == m_generation;
+}
+
+bool LatestJobRunner::isRunning() const
+{
+    return m_running;
+}
+
+void LatestJobRunner::startUntracked(QRunnable *job)
+{
+    m_pool->start(job);
+}
+
+void LatestJobRunner::cancelAndWait()
+{
+    m_pool->clear();
+    m_pool->waitForDone();
+}
+
+/**
+ * @brief [辅助] 按最新状态创建并提交任务
+ */
+void LatestJobRunner::start()
+{
+    m_pending = false;
+    QRunnable *job = m_factory(m_generation);
+    if (!job)
+        return;
+
+    job->setAutoDelete(false);
+    m_running = true;
+    m_pool->start(new TrackedJob(this, job));
+}
+
+/**
+ * @brief [槽] 任务结束；期间有新请求时立即再提交一次
+ */
+void LatestJobRunner::onJobFinished()
+{
+    m_running = false;
+    if (m_pending)
+        start();
+}
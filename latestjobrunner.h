@@ -0,0 +1,84 @@
+#ifndef LATESTJOBRUNNER_H
+#define LATESTJOBRUNNER_H
+
+#include <QObject>
+#include <functional>
+
+// 向前声明
+class QThreadPool;
+class QRunnable;
+
+/**
+ * @brief 单工作线程的任务调度：运行期间的新请求只保留最新一次
+ * * 同一时刻最多运行一个任务；任务运行期间的请求只记为待处理，任务结束后按当时的
+ * 最新状态再创建一次，因此拖拽、连续输入等高频请求不会堆积。
+ * 每次请求分配递增的编号，结果送回 GUI 线程后由调用方借助 isCurrent()/isLatest() 丢弃过期结果。
+ * 任务结束的通知在任务自身排队发出的结果之后到达。
+ */
+class LatestJobRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 按当前状态创建任务 (在 GUI 线程中调用)
+     * @param generation 本次任务的编号
+     * @return 没有需要计算的内容时返回 nullptr
+     */
+    typedef std::function<QRunnable *(int generation)> JobFactory;
+
+    explicit LatestJobRunner(const JobFactory &factory, QObject *parent = nullptr);
+    ~LatestJobRunner();
+
+    /**
+     * @brief 请求一次新任务；已有任务在运行时只标记待处理
+     * @return 本次请求的编号
+     */
+    int request();
+
+    /**
+     * @brief 之前的请求全部作废：编号前进，待处理标记清除，运行中任务的结果视为过期
+     */
+    void invalidate();
+
+    /**
+     * @brief 结果是否产生于最近一次 invalidate() 之后
+     */
+    bool isCurrent(int generation) const;
+
+    /**
+     * @brief 结果是否对应最近一次请求
+     */
+    bool isLatest(int generation) const;
+
+    bool isRunning() const;
+
+    /**
+     * @brief 在同一工作线程中运行不参与合并的任务 (例如索引构建)
+     */
+    void startUntracked(QRunnable *job);
+
+    /**
+     * @brief 取消排队的任务并等待运行中的任务结束 (在所有者析构时调用)
+     */
+    void cancelAndWait();
+
+signals:
+    // 工作线程 -> GUI 线程 (排队连接)
+    void jobFinished();
+
+private slots:
+    void onJobFinished();
+
+private:
+    void start();
+
+    JobFactory m_factory;
+    QThreadPool *m_pool;
+    int m_generation;
+    int m_validFrom; // 不早于此编号的结果有效
+    bool m_running;
+    bool m_pending;
+};
+
+#endif // LATESTJOBRUNNER_H
@@ -3,8 +3,12 @@
 #include "signaltreedelegate.h"
 #include "signalpropertiesdialog.h"
 #include "replaymanager.h"
+#include "signalgraph.h"
+#include "histogramdialog.h"
+#include "derivedexpression.h"
 
 #include <QMenuBar>
+#include <QStatusBar>
 #include <QMenu>
 #include <QAction>
 #include <QFileDialog>
@@ -15,8 +19,8 @@
 #include <QProgressDialog>
 #include <QDockWidget>
 #include <QTreeView>
-#include <QStandardItemModel>
-#include <QStandardItem>
+#include <QTableView>
+#include <QHeaderView>
 #include <QWidget>
 #include <QGridLayout>
 #include <QPainter>
@@ -34,8 +38,13 @@
 #include <QCursor>
 #include <QFormLayout>
 #include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QCheckBox>
 #include <QDialogButtonBox>
 #include <QLineEdit>
+#include <QComboBox>
+#include <QLabel>
+#include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QDragEnterEvent>
 #include <QDropEvent>
@@ -44,9 +53,14 @@
 #include <QDomDocument>
 #include <QColor>
 #include <QMap>
+#include <QtNumeric>
+#include <algorithm>
 #include "quazip/quazip.h"
 #include "quazip/quazipfile.h"
 
+// 游标读数面板可见时，每个子图上保留数值标签的曲线数量
+static const int kReadoutPlotLabelLimit = 5;
+
 // 自定义流式布局图例类
 class FlowLegend : public QCPLegend
 {
@@ -128,42 +142,6 @@ private:
     }
 };
 
-/**
- * @brief [辅助函数] 递归地在 QStandardItemModel 中按名称查找信号条目
- * @param parentItem 开始搜索的父项 (初始调用时传入 invisibleRootItem)
- * @param name 要查找的信号名称 (item->text())
- * @return 找到的 QStandardItem，如果未找到则返回 nullptr
- */
-static QStandardItem *findItemByName_Recursive(QStandardItem *parentItem, const QString &name)
-{
-    if (!parentItem)
-        return nullptr;
-
-    for (int r = 0; r < parentItem->rowCount(); ++r)
-    {
-        QStandardItem *child = parentItem->child(r);
-        if (!child)
-            continue;
-
-        if (child->data(IsSignalItemRole).toBool())
-        {
-            // 是信号条目，检查名称
-            if (child->text() == name)
-            {
-                return child;
-            }
-        }
-        else
-        {
-            // 是文件或表条目，递归搜索其子项
-            QStandardItem *found = findItemByName_Recursive(child, name);
-            if (found)
-                return found;
-        }
-    }
-    return nullptr;
-}
-
 static bool isSupportedFile(const QString &filePath)
 {
     return filePath.endsWith(".csv", Qt::CaseInsensitive) ||
@@ -176,15 +154,28 @@ MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent),
       m_dataThread(nullptr),
       m_dataManager(nullptr),
+      m_plotGrid(nullptr),
       m_plotContainer(nullptr),
       m_signalDock(nullptr),
       m_signalTree(nullptr),
+      m_cursorReadoutDock(nullptr),
+      m_cursorReadoutView(nullptr),
+      m_cursorReadoutModel(nullptr),
+      m_cursorReadoutUpdatePending(false),
+      m_rangeStatsDock(nullptr),
+      m_rangeStatsView(nullptr),
+      m_rangeStatsModel(nullptr),
       m_signalTreeModel(nullptr),
+      m_signalSearchModeBox(nullptr),
+      m_signalSearchStatus(nullptr),
+      m_signalSearch(nullptr),
+      m_sparklineCache(nullptr),
       m_progressDialog(nullptr),
       m_activePlot(nullptr),
       m_lastMousePlot(nullptr),
       m_loadFileAction(nullptr),
       m_importViewAction(nullptr),
+      m_newDerivedSignalAction(nullptr),
       m_layout1x1Action(nullptr),
       m_layout1x2Action(nullptr),
       m_layout2x1Action(nullptr),
@@ -201,6 +192,12 @@ MainWindow::MainWindow(QWidget *parent)
       m_replayAction(nullptr),
       m_exportAllAction(nullptr),
       m_cursorGroup(nullptr),
+      m_snapAllAction(nullptr),
+      m_snapActivePlotAction(nullptr),
+      m_snapSignalAction(nullptr),
+      m_snapNoneAction(nullptr),
+      m_snapGroup(nullptr),
+      m_duplicateNameGroup(nullptr),
       m_fitViewAction(nullptr),
       m_fitViewTimeAction(nullptr),
       m_fitViewYAction(nullptr),
@@ -210,17 +207,36 @@ MainWindow::MainWindow(QWidget *parent)
       m_customColsSpinBox(nullptr),
       m_cursorManager(nullptr),
       m_replayManager(nullptr),
+      m_renderScheduler(nullptr),
+      m_plotRasterizer(nullptr),
+      m_interactionQuality(nullptr),
+      m_signalRegistry(nullptr),
       m_openGLAction(nullptr),
+      m_renderStatsAction(nullptr),
+      m_offscreenRenderAction(nullptr),
+      m_interactionQualityAction(nullptr),
       m_yAxisGroup(nullptr),
-      m_colorIndex(0)
+      m_colorIndex(0),
+      m_plotBatchDepth(0)
 {
     setupDataManagerThread();
 
-    m_plotContainer = new QWidget(this);
-    m_plotContainer->setLayout(new QGridLayout());
-    setCentralWidget(m_plotContainer);
+    // 子图网格放在滚动区域中，大布局时只有视口内的子图参与重绘
+    m_plotGrid = new PlotGridArea(this);
+    m_plotContainer = m_plotGrid->container();
+    setCentralWidget(m_plotGrid);
+
+    m_renderScheduler = new RenderScheduler(this);
+    connect(m_renderScheduler, &RenderScheduler::frameRendered, this, &MainWindow::onFrameRendered);
+    connect(m_plotGrid, &PlotGridArea::cellOnScreenChanged, this, &MainWindow::onPlotCellOnScreenChanged);
+
+    m_plotRasterizer = new PlotRasterizer(m_renderScheduler, this);
+    m_interactionQuality = new InteractionQuality(&m_plotWidgets, m_renderScheduler, m_plotRasterizer, this);
 
     m_cursorManager = new CursorManager(&m_plotWidgets, this);
+    m_cursorManager->setRenderScheduler(m_renderScheduler);
+
+    m_signalRegistry = new SignalRegistry(this);
 
     createActions();
 
@@ -254,6 +270,7 @@ MainWindow::MainWindow(QWidget *parent)
     m_colorList << QColor("#ff13a6"); // 亮粉
     m_colorList << QColor("#fe330a"); // 亮红
     m_colorList << QColor("#22b573"); // 蓝绿
+    m_signalTreeModel->setColorList(m_colorList);
 
     // 5. 设置初始布局
     setupPlotLayout(2, 1);
@@ -293,6 +310,7 @@ void MainWindow::setupDataManagerThread()
 
     connect(this, &MainWindow::requestLoadCsv, m_dataManager, &DataManager::loadCsvFile, Qt::QueuedConnection);
     connect(this, &MainWindow::requestLoadMat, m_dataManager, &DataManager::loadMatFile, Qt::QueuedConnection);
+    connect(this, &MainWindow::requestDerivedSignal, m_dataManager, &DataManager::computeDerivedSignal, Qt::QueuedConnection);
 
     connect(m_dataManager, &DataManager::loadProgress, this, &MainWindow::showLoadProgress, Qt::QueuedConnection);
     connect(m_dataManager, &DataManager::loadFinished, this, &MainWindow::onDataLoadFinished, Qt::QueuedConnection);
@@ -321,6 +339,11 @@ void MainWindow::createActions()
     m_importViewAction = new QAction(tr("&Import View..."), this);
     connect(m_importViewAction, &QAction::triggered, this, &MainWindow::on_actionImportView_triggered);
 
+    // 派生信号
+    m_newDerivedSignalAction = new QAction(tr("新建派生信号..."), this);
+    m_newDerivedSignalAction->setStatusTip(tr("由已加载信号和常量的表达式计算新信号"));
+    connect(m_newDerivedSignalAction, &QAction::triggered, this, &MainWindow::on_actionNewDerivedSignal_triggered);
+
     // 替换布局菜单
     m_layout1x1Action = new QAction(tr("1x1 Layout"), this);
     m_layout1x1Action->setData(QPoint(1, 1));
@@ -402,6 +425,48 @@ void MainWindow::createActions()
     m_cursorGroup->addAction(m_cursorDoubleAction);
     connect(m_cursorGroup, &QActionGroup::triggered, m_cursorManager, &CursorManager::onCursorActionTriggered);
 
+    // 游标吸附模式
+    m_snapAllAction = new QAction(tr("吸附到所有信号"), this);
+    m_snapAllAction->setToolTip(tr("游标吸附到任一子图上可见信号的最近采样时刻"));
+    m_snapAllAction->setData(int(CursorManager::SnapAllSignals));
+    m_snapAllAction->setCheckable(true);
+    m_snapAllAction->setChecked(true);
+
+    m_snapActivePlotAction = new QAction(tr("吸附到当前子图"), this);
+    m_snapActivePlotAction->setData(int(CursorManager::SnapActivePlot));
+    m_snapActivePlotAction->setCheckable(true);
+
+    m_snapSignalAction = new QAction(tr("吸附到指定信号"), this);
+    m_snapSignalAction->setToolTip(tr("在曲线右键菜单中选择目标信号"));
+    m_snapSignalAction->setData(int(CursorManager::SnapSignal));
+    m_snapSignalAction->setCheckable(true);
+
+    m_snapNoneAction = new QAction(tr("不吸附"), this);
+    m_snapNoneAction->setData(int(CursorManager::SnapNone));
+    m_snapNoneAction->setCheckable(true);
+
+    m_snapGroup = new QActionGroup(this);
+    m_snapGroup->addAction(m_snapAllAction);
+    m_snapGroup->addAction(m_snapActivePlotAction);
+    m_snapGroup->addAction(m_snapSignalAction);
+    m_snapGroup->addAction(m_snapNoneAction);
+    connect(m_snapGroup, &QActionGroup::triggered, this, &MainWindow::onSnapModeTriggered);
+
+    // 导入视图时同名信号的解析策略
+    QAction *preferNewestAction = new QAction(tr("优先最近加载的文件"), this);
+    preferNewestAction->setData(int(SignalRegistry::PreferNewestFile));
+    preferNewestAction->setCheckable(true);
+    preferNewestAction->setChecked(true); // 默认选中
+
+    QAction *preferOldestAction = new QAction(tr("优先最早加载的文件"), this);
+    preferOldestAction->setData(int(SignalRegistry::PreferOldestFile));
+    preferOldestAction->setCheckable(true);
+
+    m_duplicateNameGroup = new QActionGroup(this);
+    m_duplicateNameGroup->addAction(preferNewestAction);
+    m_duplicateNameGroup->addAction(preferOldestAction);
+    connect(m_duplicateNameGroup, &QActionGroup::triggered, this, &MainWindow::onDuplicateNamePolicyTriggered);
+
     m_replayAction = new QAction(tr("重放"), this);
     m_replayAction->setCheckable(true);
     connect(m_replayAction, &QAction::toggled, this, &MainWindow::onReplayActionToggled);
@@ -440,6 +505,29 @@ void MainWindow::createActions()
     m_openGLAction->setChecked(false); // 默认关闭
     connect(m_openGLAction, &QAction::toggled, this, &MainWindow::onOpenGLActionToggled);
 
+    // 渲染统计 (调试用)
+    m_renderStatsAction = new QAction(tr("显示渲染统计"), this);
+    m_renderStatsAction->setToolTip(tr("在状态栏显示帧耗时与重绘合并情况。"));
+    m_renderStatsAction->setCheckable(true);
+    m_renderStatsAction->setChecked(false);
+    connect(m_renderStatsAction, &QAction::toggled, this, [this](bool checked)
+            {
+        m_renderScheduler->resetFrameStats();
+        if (!checked)
+            statusBar()->clearMessage(); });
+
+    // 后台离屏渲染
+    m_offscreenRenderAction = new QAction(tr("后台渲染 (离屏)"), this);
+    m_offscreenRenderAction->setToolTip(tr("在后台线程中将曲线光栅化为图像，界面只负责合成，密集数据下交互更流畅。"));
+    m_offscreenRenderAction->setCheckable(true);
+    m_offscreenRenderAction->setChecked(false);
+    connect(m_offscreenRenderAction, &QAction::toggled, m_plotRasterizer, &PlotRasterizer::setEnabled);
+
+    // 交互期间的草稿质量
+    m_interactionQualityAction = new QAction(tr("交互渲染质量..."), this);
+    m_interactionQualityAction->setToolTip(tr("拖拽/缩放期间使用较粗的 LOD 且不抗锯齿，停止操作后恢复完整质量"));
+    connect(m_interactionQualityAction, &QAction::triggered, this, &MainWindow::onInteractionQualitySettings);
+
     m_clearAllPlotsAction = new QAction(tr("Clear All Plots"), this);
     m_clearAllPlotsAction->setToolTip(tr("Remove all signals from all plots"));
     m_clearAllPlotsAction->setIcon(style()->standardIcon(QStyle::SP_DialogDiscardButton));
@@ -452,6 +540,7 @@ void MainWindow::createMenus()
     QMenu *fileMenu = menuBar()->addMenu(tr("&文件"));
     fileMenu->addAction(m_loadFileAction);
     fileMenu->addAction(m_importViewAction);
+    fileMenu->addAction(m_newDerivedSignalAction);
     fileMenu->addSeparator();
     fileMenu->addAction(m_exportAllAction);
 
@@ -479,6 +568,14 @@ void MainWindow::createMenus()
     {
         viewMenu->addAction(m_replayManager->getDockWidget()->toggleViewAction());
     }
+    if (m_cursorReadoutDock)
+    {
+        viewMenu->addAction(m_cursorReadoutDock->toggleViewAction());
+    }
+    if (m_rangeStatsDock)
+    {
+        viewMenu->addAction(m_rangeStatsDock->toggleViewAction());
+    }
     // 添加视图菜单项
     viewMenu->addSeparator();
     viewMenu->addAction(m_fitViewAction);
@@ -499,6 +596,15 @@ void MainWindow::createMenus()
     // 创建 "设置" 菜单
     QMenu *settingsMenu = menuBar()->addMenu(tr("&设置"));
     settingsMenu->addAction(m_openGLAction);
+    settingsMenu->addAction(m_renderStatsAction);
+    settingsMenu->addAction(m_offscreenRenderAction);
+    settingsMenu->addAction(m_interactionQualityAction);
+
+    QMenu *snapMenu = settingsMenu->addMenu(tr("游标吸附"));
+    snapMenu->addActions(m_snapGroup->actions());
+
+    QMenu *duplicateNameMenu = settingsMenu->addMenu(tr("导入视图时的同名信号"));
+    duplicateNameMenu->addActions(m_duplicateNameGroup->actions());
 }
 
 void MainWindow::createToolBars()
@@ -548,11 +654,32 @@ void MainWindow::createDocks()
     m_signalSearchBox->setClearButtonEnabled(true);
     dockLayout->addWidget(m_signalSearchBox);
 
+    // 搜索模式与匹配数量
+    QHBoxLayout *searchOptionsLayout = new QHBoxLayout();
+    searchOptionsLayout->setSpacing(4);
+    m_signalSearchModeBox = new QComboBox(dockWidget);
+    m_signalSearchModeBox->addItem(tr("包含"), SignalSearch::Substring);
+    m_signalSearchModeBox->addItem(tr("通配符"), SignalSearch::Wildcard);
+    m_signalSearchModeBox->addItem(tr("正则"), SignalSearch::Regex);
+    m_signalSearchModeBox->setToolTip(tr("包含: 名称包含输入文本\n通配符: 整个名称匹配 * 和 ?\n正则: 名称中包含正则表达式的匹配"));
+    m_signalSearchStatus = new QLabel(dockWidget);
+    searchOptionsLayout->addWidget(m_signalSearchModeBox);
+    searchOptionsLayout->addWidget(m_signalSearchStatus, 1);
+    dockLayout->addLayout(searchOptionsLayout);
+
+    m_signalSearch = new SignalSearch(this);
+
     m_signalTree = new QTreeView(dockWidget);
-    m_signalTreeModel = new QStandardItemModel(m_signalDock);
+    m_signalTreeModel = new SignalTreeModel(m_signalDock);
     m_signalTree->setModel(m_signalTreeModel);
     m_signalTree->setHeaderHidden(true);
-    m_signalTree->setItemDelegate(new SignalTreeDelegate(m_signalTree));
+
+    // 预览缩略图在工作线程中按可见行分批计算
+    m_sparklineCache = new SparklineCache(m_signalRegistry, this);
+    SignalTreeDelegate *delegate = new SignalTreeDelegate(m_signalTree);
+    delegate->setSparklineCache(m_sparklineCache);
+    m_signalTree->setItemDelegate(delegate);
+    connect(m_sparklineCache, &SparklineCache::sparklinesReady, m_signalTree->viewport(), static_cast<void (QWidget::*)()>(&QWidget::update));
 
     // 设置缩进宽度，默认通常为20，这里减小为10以减少层级缩进感
     m_signalTree->setIndentation(8);
@@ -569,99 +696,337 @@ void MainWindow::createDocks()
     m_signalDock->setFeatures(QDockWidget::DockWidgetClosable | QDockWidget::DockWidgetMovable);
     addDockWidget(Qt::LeftDockWidgetArea, m_signalDock);
 
-    connect(m_signalTreeModel, &QStandardItemModel::itemChanged, this, &MainWindow::onSignalItemChanged);
+    connect(m_signalTreeModel, &SignalTreeModel::signalCheckChanged, this, &MainWindow::onSignalCheckChanged);
     connect(m_signalTree, &QTreeView::doubleClicked, this, &MainWindow::onSignalItemDoubleClicked);
 
     // 连接右键菜单
     m_signalTree->setContextMenuPolicy(Qt::CustomContextMenu);
     connect(m_signalTree, &QTreeView::customContextMenuRequested, this, &MainWindow::onSignalTreeContextMenu);
 
-    // 连接搜索框信号
-    connect(m_signalSearchBox, &QLineEdit::textChanged, this, &MainWindow::onSignalSearchChanged);
+    // 连接搜索框信号 (查询经防抖后在工作线程中执行)
+    connect(m_signalSearchBox, &QLineEdit::textChanged, m_signalSearch, &SignalSearch::setQuery);
+    connect(m_signalSearchModeBox, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, [this](int index)
+            { m_signalSearch->setMode(static_cast<SignalSearch::Mode>(m_signalSearchModeBox->itemData(index).toInt())); });
+    connect(m_signalSearch, &SignalSearch::resultReady, this, &MainWindow::onSignalSearchResult);
+    // 过滤生效期间视图追加加载的行也需要按结果隐藏
+    connect(m_signalTreeModel, &QAbstractItemModel::rowsInserted, this, &MainWindow::onSignalRowsInserted);
 
     if (m_replayManager && m_replayManager->getDockWidget())
     {
         addDockWidget(Qt::BottomDockWidgetArea, m_replayManager->getDockWidget());
     }
+
+    // 游标读数面板 (默认隐藏)
+    m_cursorReadoutDock = new QDockWidget(tr("游标读数"), this);
+    m_cursorReadoutModel = new CursorReadoutModel(m_cursorReadoutDock);
+    m_cursorReadoutView = new QTableView(m_cursorReadoutDock);
+    m_cursorReadoutView->setModel(m_cursorReadoutModel);
+    m_cursorReadoutView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_cursorReadoutView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_cursorReadoutView->setWordWrap(false);
+    m_cursorReadoutView->verticalHeader()->hide();
+    // 固定行高：视图无需逐行测量，数千行时滚动依然流畅
+    m_cursorReadoutView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    m_cursorReadoutView->verticalHeader()->setDefaultSectionSize(m_cursorReadoutView->fontMetrics().height() + 4);
+    m_cursorReadoutView->horizontalHeader()->setSectionResizeMode(CursorReadoutModel::NameColumn, QHeaderView::Stretch);
+    m_cursorReadoutDock->setWidget(m_cursorReadoutView);
+    m_cursorReadoutDock->setFeatures(QDockWidget::DockWidgetClosable | QDockWidget::DockWidgetMovable);
+    addDockWidget(Qt::RightDockWidgetArea, m_cursorReadoutDock);
+    m_cursorReadoutDock->hide();
+
+    connect(m_cursorManager, &CursorManager::cursorKeyChanged, m_cursorReadoutModel, &CursorReadoutModel::setCursorKey);
+    connect(m_cursorManager, &CursorManager::modeChanged, this, [this](CursorManager::CursorMode mode)
+            {
+        int count = 0;
+        if (mode == CursorManager::SingleCursor)
+            count = 1;
+        else if (mode == CursorManager::DoubleCursor)
+            count = 2;
+        m_cursorReadoutModel->setCursorCount(count);
+        updateRangeStatsActive(); });
+    // 面板可见时，子图上只保留前几条曲线的数值标签
+    connect(m_cursorReadoutDock, &QDockWidget::visibilityChanged, this, [this](bool visible)
+            { m_cursorManager->setMaxValueLabels(visible ? kReadoutPlotLabelLimit : -1); });
+
+    // 区间统计面板 (默认隐藏，与游标读数面板叠放)
+    m_rangeStatsDock = new QDockWidget(tr("区间统计"), this);
+    m_rangeStatsModel = new RangeStatsModel(m_rangeStatsDock);
+    m_rangeStatsView = new QTableView(m_rangeStatsDock);
+    m_rangeStatsView->setModel(m_rangeStatsModel);
+    m_rangeStatsView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_rangeStatsView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_rangeStatsView->setWordWrap(false);
+    m_rangeStatsView->verticalHeader()->hide();
+    m_rangeStatsView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    m_rangeStatsView->verticalHeader()->setDefaultSectionSize(m_rangeStatsView->fontMetrics().height() + 4);
+    m_rangeStatsView->horizontalHeader()->setSectionResizeMode(RangeStatsModel::NameColumn, QHeaderView::Stretch);
+    m_rangeStatsDock->setWidget(m_rangeStatsView);
+    m_rangeStatsDock->setFeatures(QDockWidget::DockWidgetClosable | QDockWidget::DockWidgetMovable);
+    addDockWidget(Qt::RightDockWidgetArea, m_rangeStatsDock);
+    tabifyDockWidget(m_cursorReadoutDock, m_rangeStatsDock);
+    m_rangeStatsDock->hide();
+
+    connect(m_cursorManager, &CursorManager::cursorKeyChanged, m_rangeStatsModel, &RangeStatsModel::setCursorKey);
+    connect(m_rangeStatsDock, &QDockWidget::visibilityChanged, this, &MainWindow::updateRangeStatsActive);
+}
+
+/**
+ * @brief [辅助] 区间统计只在双游标模式且面板可见时计算
+ */
+void MainWindow::updateRangeStatsActive()
+{
+    m_rangeStatsModel->setActive(m_rangeStatsDock->isVisible() && m_cursorManager->getMode() == CursorManager::DoubleCursor);
+}
+
+/**
+ * @brief [辅助] 合并多次曲线变更，在事件循环空闲时统一刷新游标读数条目
+ */
+void MainWindow::scheduleCursorReadoutUpdate()
+{
+    if (m_cursorReadoutUpdatePending)
+        return;
+    m_cursorReadoutUpdatePending = true;
+    QTimer::singleShot(0, this, &MainWindow::updateCursorReadoutEntries);
+}
+
+/**
+ * @brief [辅助] 按子图和曲线顺序收集所有已绘制的信号 (同一信号只出现一次)
+ */
+void MainWindow::updateCursorReadoutEntries()
+{
+    m_cursorReadoutUpdatePending = false;
+
+    QVector<RangeStatsModel::Entry> entries;
+    QSet<SignalHandle> seen;
+    for (int plotIndex = 0; plotIndex < m_plotCells.size(); ++plotIndex)
+    {
+        // 已创建的子图按曲线顺序；尚未创建的单元格按句柄顺序取映射中的信号
+        QList<SignalHandle> handles;
+        if (QCustomPlot *plot = m_plotCells.at(plotIndex).plot)
+        {
+            for (int i = 0; i < plot->graphCount(); ++i)
+            {
+                if (SignalGraph *graph = qobject_cast<SignalGraph *>(plot->graph(i)))
+                    handles.append(m_signalRegistry->handleOf(graph));
+            }
+        }
+        else
+        {
+            handles = m_plotSignalMap.value(plotIndex).values();
+            std::sort(handles.begin(), handles.end());
+        }
+
+        for (SignalHandle handle : handles)
+        {
+            if (handle == InvalidSignalHandle || seen.contains(handle))
+                continue;
+
+            const SignalLocation loc = getSignalData(handle);
+            if (!loc.table || loc.signalIndex < 0 || loc.signalIndex >= loc.table->valueData.size())
+                continue;
+            seen.insert(handle);
+
+            RangeStatsModel::Entry entry;
+            entry.uniqueID = m_signalRegistry->uniqueID(handle);
+            entry.name = loc.name;
+            entry.color = loc.pen.color();
+            entry.keys = loc.table->timeData;
+            entry.values = loc.table->valueData.at(loc.signalIndex);
+            entry.lod = loc.table->lods.value(loc.signalIndex);
+            if (loc.signalIndex < loc.table->quantiles.size())
+                entry.quantiles = loc.table->quantiles.at(loc.signalIndex);
+            entries.append(entry);
+        }
+    }
+    // 游标读数只需要基本条目 (数据向量隐式共享)
+    m_cursorReadoutModel->setEntries(QVector<CursorReadoutModel::Entry>(entries.begin(), entries.end()));
+    m_rangeStatsModel->setEntries(entries);
 }
 
+/**
+ * @brief 按几何位置建立子图网格
+ * * 已有的单元格 (连同子图、曲线、缓冲和 GL 上下文) 按索引复用，只重新放入新的网格位置；
+ * 新增的单元格只创建边框，子图在单元格首次进入视口时才创建 (见 onPlotCellOnScreenChanged)，
+ * 因此行列很多时启动开销和内存只与可见的单元格数量有关。多出的单元格才会被销毁。
+ * 复用子图的曲线与 m_plotSignalMap 对齐，只增删有差异的曲线
+ */
 void MainWindow::setupPlotLayout(const QList<QRect> &geometries)
 {
-    clearPlotLayout();
+    QGridLayout *grid = m_plotGrid->gridLayout();
+
+    int rows = 1;
+    int cols = 1;
+    for (const QRect &geo : geometries)
+    {
+        rows = qMax(rows, geo.y() + geo.height());
+        cols = qMax(cols, geo.x() + geo.width());
+    }
+    m_plotGrid->setGridSize(rows, cols);
 
-    QGridLayout *grid = qobject_cast<QGridLayout *>(m_plotContainer->layout());
-    if (!grid)
-        grid = new QGridLayout(m_plotContainer);
+    // 1. 销毁多余的单元格，并从网格中取出保留的单元格 (控件不删除)
+    releasePlotCells(geometries.size());
 
-    // 设置边距
-    grid->setSpacing(0);
-    grid->setContentsMargins(0, 0, 0, 0);
+    QLayoutItem *item;
+    while ((item = grid->takeAt(0)) != nullptr)
+        delete item;
 
+    // 已创建的子图共享同一 X 范围
     QCPRange sharedXRange;
-    bool hasSharedXRange = false;
+    const bool hasSharedXRange = !m_plotWidgets.isEmpty();
+    if (hasSharedXRange)
+        sharedXRange = m_plotWidgets.first()->xAxis->range();
 
-    // 1. 创建组件
+    QList<QWidget *> cellFrames;
     for (int i = 0; i < geometries.size(); ++i)
     {
         const QRect &geo = geometries[i];
-        int plotIndex = i;
 
-        QFrame *plotFrame = new QFrame(m_plotContainer);
-        plotFrame->setFrameShape(QFrame::NoFrame);
-        plotFrame->setStyleSheet("QFrame { border: 2px solid transparent; }"); // 使用样式表管理边框
+        if (i >= m_plotCells.size())
+        {
+            // 2. 新建单元格 (只有边框)
+            QFrame *frame = new QFrame(m_plotContainer);
+            frame->setFrameShape(QFrame::NoFrame);
+            frame->setStyleSheet("QFrame { border: 2px solid transparent; }"); // 使用样式表管理边框
 
-        QVBoxLayout *frameLayout = new QVBoxLayout(plotFrame);
-        frameLayout->setContentsMargins(0, 0, 0, 0);
+            QVBoxLayout *frameLayout = new QVBoxLayout(frame);
+            frameLayout->setContentsMargins(0, 0, 0, 0);
 
-        QCustomPlot *plot = new QCustomPlot(plotFrame);
-        if (i == 0)
-            m_yAxisGroup = new QCPMarginGroup(plot);
+            PlotCell cell;
+            cell.frame = frame;
+            m_plotCells.append(cell);
+        }
 
-        frameLayout->addWidget(plot);
-        grid->addWidget(plotFrame, geo.y(), geo.x(), geo.height(), geo.width());
-        m_plotWidgets.append(plot);
+        const PlotCell &cell = m_plotCells.at(i);
+        grid->addWidget(cell.frame, geo.y(), geo.x(), geo.height(), geo.width());
+        cellFrames.append(cell.frame);
 
-        // 2. 恢复信号 (持久化数据)
-        if (m_plotSignalMap.contains(plotIndex))
-        {
-            const QSet<QString> &signalIDs = m_plotSignalMap.value(plotIndex);
-            for (const QString &uniqueID : signalIDs)
-            {
-                SignalLocation loc = getSignalDataFromID(uniqueID);
-                if (loc.table)
-                {
-                    setupGraphInstance(plot, uniqueID, loc);
-                }
-            }
+        QCustomPlot *plot = cell.plot;
+        if (!plot)
+            continue;
 
+        // 3. 复用的子图：恢复/对齐信号 (持久化数据)
+        const bool changed = syncPlotGraphs(plot, i);
+        if (changed && plot->graphCount() > 0)
             plot->rescaleAxes();
-            if (!hasSharedXRange && plot->graphCount() > 0)
-            {
-                sharedXRange = plot->xAxis->range();
-                hasSharedXRange = true;
-            }
-            else if (hasSharedXRange)
-            {
-                plot->xAxis->setRange(sharedXRange);
-            }
-        }
-        else if (hasSharedXRange)
+
+        if (hasSharedXRange)
         {
+            // 复用的子图已连接 X 轴同步，这里不应再次触发
+            QSignalBlocker blocker(plot->xAxis);
             plot->xAxis->setRange(sharedXRange);
         }
 
-        setupPlotInteractions(plot);
+        if (changed)
+            configurePlotLegend(plot, m_legendPosGroup->checkedAction() ? m_legendPosGroup->checkedAction()->data().toInt() : 1);
+        m_renderScheduler->requestReplot(plot);
     }
 
-    // 恢复活动状态
-    if (!m_plotWidgets.isEmpty())
+    // 恢复活动状态 (活动子图被保留时不变，否则立即创建第一个单元格的子图)
+    if (!m_plotCells.isEmpty())
     {
-        setActivePlot(m_plotWidgets.first());
+        setActivePlot(m_plotWidgets.contains(m_activePlot) ? m_activePlot : ensureCellPlot(0));
     }
 
+    m_plotGrid->setCells(cellFrames);
+    scheduleCursorReadoutUpdate();
+
     QTimer::singleShot(0, this, &MainWindow::updateCursorsForLayoutChange);
 }
 
+/**
+ * @brief [辅助] 返回单元格的子图，尚未创建时立即创建
+ * * 曲线按 m_plotSignalMap 恢复，X 轴与已有子图对齐；游标开启时补建游标图元
+ */
+QCustomPlot *MainWindow::ensureCellPlot(int plotIndex)
+{
+    PlotCell &cell = m_plotCells[plotIndex];
+    if (cell.plot)
+        return cell.plot;
+
+    QCustomPlot *plot = new QCustomPlot(cell.frame);
+    if (!m_yAxisGroup)
+        m_yAxisGroup = new QCPMarginGroup(plot);
+    cell.frame->layout()->addWidget(plot);
+    cell.frame->layout()->activate();
+    cell.plot = plot;
+
+    // m_plotWidgets 保持单元格顺序
+    int position = 0;
+    for (int i = 0; i < plotIndex; ++i)
+    {
+        if (m_plotCells.at(i).plot)
+            ++position;
+    }
+    const bool hasSharedXRange = !m_plotWidgets.isEmpty();
+    const QCPRange sharedXRange = hasSharedXRange ? m_plotWidgets.first()->xAxis->range() : QCPRange();
+    m_plotWidgets.insert(position, plot);
+
+    if (syncPlotGraphs(plot, plotIndex) && plot->graphCount() > 0)
+        plot->rescaleAxes();
+    if (hasSharedXRange)
+        plot->xAxis->setRange(sharedXRange);
+
+    setupPlotInteractions(plot);
+
+    // 在视口外创建 (例如导出全部视图) 时与其他离屏子图一样暂停重绘
+    m_renderScheduler->setPlotSuspended(plot, !m_plotGrid->isOnScreen(cell.frame));
+
+    if (m_cursorManager->getMode() != CursorManager::NoCursor)
+        updateCursorsForLayoutChange();
+
+    return plot;
+}
+
+/**
+ * @brief [辅助] 子图所在单元格的布局索引 (即 m_plotSignalMap 的键)
+ */
+int MainWindow::plotIndexOf(QCustomPlot *plot) const
+{
+    if (!plot)
+        return -1;
+
+    for (int i = 0; i < m_plotCells.size(); ++i)
+    {
+        if (m_plotCells.at(i).plot == plot)
+            return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief [辅助] 使子图上的曲线与 m_plotSignalMap 中该索引的信号集合一致
+ * @return 是否增删了曲线
+ */
+bool MainWindow::syncPlotGraphs(QCustomPlot *plot, int plotIndex)
+{
+    const QSet<SignalHandle> handles = m_plotSignalMap.value(plotIndex);
+    bool changed = false;
+
+    for (int g = plot->graphCount() - 1; g >= 0; --g)
+    {
+        QCPGraph *graph = plot->graph(g);
+        if (!handles.contains(m_signalRegistry->handleOf(graph)))
+        {
+            plot->removeGraph(graph);
+            changed = true;
+        }
+    }
+
+    for (SignalHandle handle : handles)
+    {
+        if (getGraph(plot, handle))
+            continue;
+
+        SignalLocation loc = getSignalData(handle);
+        if (loc.table)
+        {
+            setupGraphInstance(plot, handle, loc);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
 void MainWindow::setupPlotLayout(int rows, int cols)
 {
     QList<QRect> geometries;
@@ -829,8 +1194,10 @@ void MainWindow::setupPlotInteractions(QCustomPlot *plot)
         plot->legend->setSelectableParts(QCPLegend::spItems);
     }
 
-    // 根据 m_openGLAction 的状态设置 OpenGL
-    plot->setOpenGl(m_openGLAction->isChecked());
+    // OpenGL 上下文按 m_openGLAction 的状态在子图进入视口时创建 (见 onPlotCellOnScreenChanged)
+
+    m_plotRasterizer->attachPlot(plot);
+    m_interactionQuality->attachPlot(plot);
 
     QFont axisFont = plot->font();           // 从绘图控件获取基础字体
     axisFont.setPointSize(7);                // 将字号设置为 7
@@ -849,6 +1216,12 @@ void MainWindow::setupPlotInteractions(QCustomPlot *plot)
 
     connect(plot, &QCustomPlot::mousePress, this, &MainWindow::onPlotClicked);
 
+    // "跟随 Y" 在每次实际重绘前适配，重绘已由调度器按帧合并
+    connect(plot, &QCustomPlot::beforeReplot, this, &MainWindow::onPlotBeforeReplot);
+
+    // 悬停高亮最接近的曲线
+    connect(plot, &QCustomPlot::mouseMove, this, &MainWindow::onPlotMouseHover);
+
     // 连接新的鼠标事件处理器
     connect(plot, &QCustomPlot::mousePress, m_cursorManager, &CursorManager::onPlotMousePress);
     connect(plot, &QCustomPlot::mouseMove, m_cursorManager, &CursorManager::onPlotMouseMove);
@@ -874,34 +1247,34 @@ void MainWindow::setupPlotInteractions(QCustomPlot *plot)
     connect(plot, &QCustomPlot::customContextMenuRequested, this, &MainWindow::onLegendContextMenu);
 }
 
-void MainWindow::clearPlotLayout()
+/**
+ * @brief [辅助] 销毁索引 >= keepCount 的单元格，其余单元格保持不变
+ * * 游标图元随子图一起删除，CursorManager/PlotRasterizer 等在 destroyed 信号中清理记录
+ */
+void MainWindow::releasePlotCells(int keepCount)
 {
-    m_cursorManager->clearCursors();
-
-    if (m_yAxisGroup)
+    if (keepCount <= 0 && m_yAxisGroup)
     {
         delete m_yAxisGroup;
         m_yAxisGroup = nullptr;
     }
 
-    // 清理布局
-    QLayout *layout = m_plotContainer->layout();
-    if (layout)
+    QGridLayout *grid = m_plotGrid->gridLayout();
+    while (m_plotCells.size() > qMax(0, keepCount))
     {
-        QLayoutItem *item;
-        while ((item = layout->takeAt(0)) != nullptr)
+        const PlotCell cell = m_plotCells.takeLast();
+        if (QCustomPlot *plot = cell.plot)
         {
-            if (item->widget())
-            {
-                item->widget()->deleteLater();
-            }
-            delete item;
+            m_plotWidgets.removeOne(plot);
+            if (plot == m_activePlot)
+                m_activePlot = nullptr;
+            if (plot == m_lastMousePlot)
+                m_lastMousePlot = nullptr;
         }
-    }
 
-    m_plotWidgets.clear();
-    m_activePlot = nullptr;
-    m_lastMousePlot = nullptr;
+        grid->removeWidget(cell.frame);
+        cell.frame->deleteLater();
+    }
 }
 
 void MainWindow::onDataLoadFinished(const FileData &data)
@@ -928,15 +1301,7 @@ void MainWindow::onDataLoadFinished(const FileData &data)
     m_fileDataMap.insert(filename, data);
 
     //  填充信号树
-    {
-        QSignalBlocker blocker(m_signalTreeModel);
-        populateSignalTree(data);
-    }
-
-    m_signalTree->reset();
-
-    // 默认展开所有条目
-    m_signalTree->expandAll();
+    populateSignalTree(data);
 
     updateReplayManagerRange();
 }
@@ -953,26 +1318,47 @@ void MainWindow::removeFile(const QString &filename)
     if (!m_fileDataMap.remove(filename))
         return;
 
+    scheduleCursorReadoutUpdate();
+
     m_cursorManager->clearCursors();
 
+    // 文件的句柄是连续区间
+    SignalHandle firstHandle = InvalidSignalHandle;
+    int handleCount = 0;
+    m_signalRegistry->fileHandles(filename, &firstHandle, &handleCount);
+
     QString prefix = filename + "/";
     bool anyPlotChanged = false;
 
-    // 1. 批量清理子图
-    for (int i = 0; i < m_plotWidgets.size(); ++i)
+    // 1. 批量清理子图 (尚未创建子图的单元格只清理映射)
+    for (int i = 0; i < m_plotCells.size(); ++i)
     {
-        QCustomPlot *plot = m_plotWidgets.at(i);
-        QSet<QString> &signalSet = m_plotSignalMap[i];
+        QCustomPlot *plot = m_plotCells.at(i).plot;
+        QSet<SignalHandle> &signalSet = m_plotSignalMap[i];
+        if (!plot)
+        {
+            QMutableSetIterator<SignalHandle> handleIt(signalSet);
+            while (handleIt.hasNext())
+            {
+                const SignalHandle handle = handleIt.next();
+                if (handle >= firstHandle && handle < firstHandle + handleCount)
+                {
+                    handleIt.remove();
+                    anyPlotChanged = true;
+                }
+            }
+            continue;
+        }
 
         QList<QCPGraph *> graphsToDelete;
         for (int j = 0; j < plot->graphCount(); ++j)
         {
             QCPGraph *graph = plot->graph(j);
-            QString graphID = graph->property("id").toString();
-            if (graphID.startsWith(prefix))
+            SignalHandle handle = m_signalRegistry->handleOf(graph);
+            if (handle >= firstHandle && handle < firstHandle + handleCount)
             {
                 graphsToDelete.append(graph);
-                signalSet.remove(graphID);
+                signalSet.remove(handle);
             }
         }
 
@@ -983,29 +1369,29 @@ void MainWindow::removeFile(const QString &filename)
 
             int legendMode = m_legendPosGroup->checkedAction() ? m_legendPosGroup->checkedAction()->data().toInt() : 1;
             configurePlotLegend(plot, legendMode);
-            plot->replot();
+            m_renderScheduler->requestReplot(plot);
             anyPlotChanged = true;
         }
     }
 
-    // 2. 清理内部ID映射
-    QMutableHashIterator<QString, QStandardItem *> it(m_uniqueIdMap);
-    while (it.hasNext())
+    // 2. 移除文件节点及其搜索索引
+    m_signalTreeModel->removeFile(filename);
+    m_signalSearch->removeFile(filename);
+    m_sparklineCache->removeRange(firstHandle, handleCount);
+    m_signalRegistry->unregisterFile(filename);
+    m_hiddenTreeNodes.remove(filename);
+    QMutableSetIterator<QString> nodeIt(m_hiddenTreeNodes);
+    while (nodeIt.hasNext())
     {
-        it.next();
-        if (it.key().startsWith(prefix))
-            it.remove();
+        if (nodeIt.next().startsWith(prefix))
+            nodeIt.remove();
     }
-
-    // 3. 移除文件节点
-    QList<QStandardItem *> items = m_signalTreeModel->findItems(filename);
-    for (QStandardItem *item : items)
+    QMutableHashIterator<QString, QBitArray> rowsIt(m_hiddenSignalRows);
+    while (rowsIt.hasNext())
     {
-        if (item->data(IsFileItemRole).toBool() && item->parent() == nullptr)
-        {
-            m_signalTreeModel->removeRow(item->row());
-            break;
-        }
+        rowsIt.next();
+        if (rowsIt.key().startsWith(prefix))
+            rowsIt.remove();
     }
 
     if (anyPlotChanged)
@@ -1038,75 +1424,178 @@ void MainWindow::onDeleteFileAction()
 }
 
 /**
- * @brief 将指定ID的信号添加到指定的子图中
- * @param uniqueID 要添加的信号ID
+ * @brief 将指定句柄的信号添加到指定的子图中
+ * @param handle 要添加的信号句柄
  * @param plot 目标 QCustomPlot
  */
-void MainWindow::addSignalToPlot(const QString &uniqueID, QCustomPlot *plot, bool replot)
+void MainWindow::addSignalToPlot(SignalHandle handle, QCustomPlot *plot, bool replot)
 {
-    int plotIndex = m_plotWidgets.indexOf(plot);
+    int plotIndex = plotIndexOf(plot);
     if (plotIndex == -1)
         return;
 
-    if (m_plotSignalMap.value(plotIndex).contains(uniqueID))
+    addSignalToCell(handle, plotIndex, replot);
+}
+
+/**
+ * @brief 将指定句柄的信号添加到指定索引的单元格
+ * * 单元格的子图尚未创建时只记录到 m_plotSignalMap，创建子图时再生成曲线
+ * @param plotIndex 单元格的布局索引
+ */
+void MainWindow::addSignalToCell(SignalHandle handle, int plotIndex, bool replot)
+{
+    if (plotIndex < 0 || plotIndex >= m_plotCells.size())
+        return;
+
+    if (m_plotSignalMap.value(plotIndex).contains(handle))
         return;
 
-    SignalLocation loc = getSignalDataFromID(uniqueID);
+    SignalLocation loc = getSignalData(handle);
     if (!loc.table || loc.signalIndex < 0 || loc.signalIndex >= loc.table->valueData.size())
         return;
 
-    setupGraphInstance(plot, uniqueID, loc);
+    QCustomPlot *plot = m_plotCells.at(plotIndex).plot;
+    if (plot)
+        setupGraphInstance(plot, handle, loc);
 
     // 更新映射
-    m_plotSignalMap[plotIndex].insert(uniqueID);
+    m_plotSignalMap[plotIndex].insert(handle);
+    scheduleCursorReadoutUpdate();
+
+    // 仅在需要时刷新 (批量作用域内推迟到作用域结束)
+    if (plot && replot)
+        markPlotEdited(plot, true);
+}
+
+/**
+ * @brief 从指定的子图中移除指定句柄的信号
+ * @param handle 要移除的信号句柄
+ * @param plot 目标 QCustomPlot
+ */
+void MainWindow::removeSignalFromPlot(SignalHandle handle, QCustomPlot *plot)
+{
+    int plotIndex = plotIndexOf(plot);
+    if (plotIndex == -1)
+        return;
 
-    // 仅在需要时刷新
-    if (replot)
+    if (!m_plotSignalMap.value(plotIndex).contains(handle))
     {
-        plot->rescaleAxes();
+        return;
+    }
 
-        int legendMode = m_legendPosGroup->checkedAction() ? m_legendPosGroup->checkedAction()->data().toInt() : 1;
-        configurePlotLegend(plot, legendMode);
+    QCPGraph *graph = getGraph(plot, handle);
+    if (graph)
+    {
+        // 游标管理器监听曲线销毁，自动回收对应的 tracer
+        plot->removeGraph(graph);
 
-        plot->replot();
+        m_plotSignalMap[plotIndex].remove(handle);
+        scheduleCursorReadoutUpdate();
 
-        if (m_cursorManager->getMode() != CursorManager::NoCursor)
-        {
-            m_cursorManager->setupCursors(); // 暂时保留，作为必须的权衡，但应考虑优化 CursorManager
-            m_cursorManager->updateAllCursors();
-        }
+        markPlotEdited(plot, false);
     }
 }
 
 /**
- * @brief 从指定的子图中移除指定ID的信号
- * @param uniqueID 要移除的信号ID
- * @param plot 目标 QCustomPlot
+ * @brief 勾选/取消勾选某个文件或表节点下的全部信号 (在一个批量作用域内完成)
+ * @param parent 文件或表节点
+ * @param checked 目标勾选状态
  */
-void MainWindow::removeSignalFromPlot(const QString &uniqueID, QCustomPlot *plot)
+void MainWindow::setChildSignalsChecked(const QModelIndex &parent, bool checked)
 {
-    int plotIndex = m_plotWidgets.indexOf(plot);
-    if (plotIndex == -1)
+    if (!parent.isValid())
         return;
 
-    if (!m_plotSignalMap.value(plotIndex).contains(uniqueID))
+    if (checked && !m_activePlot)
     {
+        QMessageBox::information(this, tr("No Plot Selected"), tr("Please click on a plot to activate it before adding a signal."));
         return;
     }
 
-    QCPGraph *graph = getGraph(plot, uniqueID);
-    if (graph)
+    PlotBatchScope batch(this);
+
+    const QVector<SignalHandle> handles = m_signalTreeModel->signalHandles(parent);
+    for (SignalHandle handle : handles)
+    {
+        // 被搜索过滤掉的信号不参与 (包括尚未加载到视图的行)
+        if (m_signalFilter.active)
+        {
+            const QBitArray matches = m_signalFilter.rows.value(m_signalRegistry->tablePrefix(handle));
+            const int row = m_signalRegistry->location(handle).column;
+            if (row < 0 || row >= matches.size() || !matches.testBit(row))
+                continue;
+        }
+
+        m_signalTreeModel->setChecked(handle, checked, true); // 经由 onSignalCheckChanged 添加/移除
+    }
+}
+
+MainWindow::PlotBatchScope::PlotBatchScope(MainWindow *window)
+    : m_window(window)
+{
+    m_window->beginPlotBatch();
+}
+
+MainWindow::PlotBatchScope::~PlotBatchScope()
+{
+    m_window->endPlotBatch();
+}
+
+void MainWindow::beginPlotBatch()
+{
+    m_plotBatchDepth++;
+}
+
+void MainWindow::endPlotBatch()
+{
+    if (m_plotBatchDepth <= 0 || --m_plotBatchDepth > 0)
+        return;
+
+    QHash<QCustomPlot *, bool> plots;
+    plots.swap(m_batchEditedPlots);
+    if (!plots.isEmpty())
+        refreshEditedPlots(plots);
+}
+
+/**
+ * @brief [辅助] 记录子图的曲线集合已改变
+ * @param rescale 是否需要重新适配坐标轴 (添加信号时)
+ */
+void MainWindow::markPlotEdited(QCustomPlot *plot, bool rescale)
+{
+    if (m_plotBatchDepth > 0)
     {
-        m_cursorManager->clearCursors();
+        m_batchEditedPlots[plot] = m_batchEditedPlots.value(plot, false) || rescale;
+        return;
+    }
 
-        plot->removeGraph(graph);
+    QHash<QCustomPlot *, bool> plots;
+    plots.insert(plot, rescale);
+    refreshEditedPlots(plots);
+}
+
+/**
+ * @brief [辅助] 曲线集合改变后刷新坐标轴、图例和游标，并请求重绘
+ * * 游标只重建一次，与受影响的子图数量和信号数量无关
+ */
+void MainWindow::refreshEditedPlots(const QHash<QCustomPlot *, bool> &plots)
+{
+    int legendMode = m_legendPosGroup->checkedAction() ? m_legendPosGroup->checkedAction()->data().toInt() : 1;
 
-        m_plotSignalMap[plotIndex].remove(uniqueID);
+    for (auto it = plots.constBegin(); it != plots.constEnd(); ++it)
+    {
+        QCustomPlot *plot = it.key();
+        if (!m_plotWidgets.contains(plot))
+            continue;
 
-        int legendMode = m_legendPosGroup->checkedAction() ? m_legendPosGroup->checkedAction()->data().toInt() : 1;
+        if (it.value())
+            plot->rescaleAxes();
         configurePlotLegend(plot, legendMode);
+        m_renderScheduler->requestReplot(plot);
+    }
 
-        plot->replot();
+    if (m_cursorManager->getMode() != CursorManager::NoCursor)
+    {
         m_cursorManager->setupCursors();
         m_cursorManager->updateAllCursors();
     }
@@ -1154,14 +1643,14 @@ void MainWindow::onPlotClicked()
     if (!clickedPlot->plottableAt(pos, true))
     {
         clickedPlot->deselectAll();
-        clickedPlot->replot();
+        m_renderScheduler->requestReplot(clickedPlot);
     }
 
     // 切换选中样式
     if (m_activePlot && clickedPlot != m_activePlot)
     {
         m_activePlot->deselectAll();
-        m_activePlot->replot();
+        m_renderScheduler->requestReplot(m_activePlot);
     }
 
     setActivePlot(clickedPlot);
@@ -1175,42 +1664,98 @@ void MainWindow::onOpenGLActionToggled(bool checked)
 {
     for (QCustomPlot *plot : m_plotWidgets)
     {
-        if (plot)
+        // 视口外的子图不持有 GL 上下文，滚入视口时再按此设置创建
+        if (plot && m_plotGrid->isOnScreen(plot->parentWidget()))
         {
             plot->setOpenGl(checked);
-            plot->replot();
+            m_renderScheduler->requestReplot(plot);
         }
     }
 }
 
 /**
- * @brief [槽] 当子图中的选择发生用户更改时调用
+ * @brief [槽] 单元格滚入/滚出视口
+ * * 单元格首次进入视口时创建子图；离屏子图暂停重绘并释放 OpenGL 上下文，
+ * 坐标范围、曲线和游标状态照常同步，重新进入视口时补绘一次
  */
-void MainWindow::onPlotSelectionChanged()
+void MainWindow::onPlotCellOnScreenChanged(QWidget *cell, bool onScreen)
 {
-    QCustomPlot *plot = qobject_cast<QCustomPlot *>(sender());
-    if (!plot)
-        return;
-
-    QList<QCPGraph *> selectedGraphs = plot->selectedGraphs();
-    QList<QCPAbstractLegendItem *> selectedLegendItems = plot->legend->selectedItems();
-
-    if (!selectedGraphs.isEmpty() && selectedLegendItems.isEmpty()) // 选中了曲线
+    int plotIndex = -1;
+    for (int i = 0; i < m_plotCells.size(); ++i)
     {
-        for (QCPGraph *graph : selectedGraphs)
+        if (m_plotCells.at(i).frame == cell)
         {
-            if (QCPPlottableLegendItem *item = plot->legend->itemWithPlottable(graph))
-            {
-                item->setSelected(true);
-            }
+            plotIndex = i;
+            break;
         }
     }
-    else if (!selectedLegendItems.isEmpty() && selectedGraphs.isEmpty()) // 选中了图例
+    if (plotIndex == -1)
+        return;
+
+    QCustomPlot *plot = m_plotCells.at(plotIndex).plot;
+    if (!plot)
     {
-        for (QCPAbstractLegendItem *item : selectedLegendItems)
-        {
-            if (QCPPlottableLegendItem *pli = qobject_cast<QCPPlottableLegendItem *>(item))
-            {
+        if (!onScreen)
+            return;
+        plot = ensureCellPlot(plotIndex);
+    }
+
+    m_renderScheduler->setPlotSuspended(plot, !onScreen);
+
+    if (m_openGLAction->isChecked() && plot->openGl() != onScreen)
+    {
+        plot->setOpenGl(onScreen);
+        if (onScreen)
+            m_renderScheduler->requestReplot(plot);
+    }
+}
+
+/**
+ * @brief [槽] 渲染调度器完成一帧后调用，按需在状态栏显示统计
+ */
+void MainWindow::onFrameRendered(const RenderScheduler::FrameStats &stats)
+{
+    if (!m_renderStatsAction || !m_renderStatsAction->isChecked())
+        return;
+
+    statusBar()->showMessage(tr("帧: %1  请求: %2  重绘: %3  跳过: %4  耗时: %5 ms (平均 %6, 最大 %7)")
+                                 .arg(stats.frames)
+                                 .arg(stats.requests)
+                                 .arg(stats.replots)
+                                 .arg(stats.skipped)
+                                 .arg(stats.lastFrameMs, 0, 'f', 2)
+                                 .arg(stats.avgFrameMs, 0, 'f', 2)
+                                 .arg(stats.maxFrameMs, 0, 'f', 2));
+}
+
+/**
+ * @brief [槽] 当子图中的选择发生用户更改时调用
+ */
+void MainWindow::onPlotSelectionChanged()
+{
+    QCustomPlot *plot = qobject_cast<QCustomPlot *>(sender());
+    if (!plot)
+        return;
+
+    QList<QCPGraph *> selectedGraphs = plot->selectedGraphs();
+    QList<QCPAbstractLegendItem *> selectedLegendItems = plot->legend->selectedItems();
+
+    if (!selectedGraphs.isEmpty() && selectedLegendItems.isEmpty()) // 选中了曲线
+    {
+        for (QCPGraph *graph : selectedGraphs)
+        {
+            if (QCPPlottableLegendItem *item = plot->legend->itemWithPlottable(graph))
+            {
+                item->setSelected(true);
+            }
+        }
+    }
+    else if (!selectedLegendItems.isEmpty() && selectedGraphs.isEmpty()) // 选中了图例
+    {
+        for (QCPAbstractLegendItem *item : selectedLegendItems)
+        {
+            if (QCPPlottableLegendItem *pli = qobject_cast<QCPPlottableLegendItem *>(item))
+            {
                 if (QCPGraph *graph = qobject_cast<QCPGraph *>(pli->plottable()))
                 {
                     QCPDataSelection selection = QCPDataSelection(graph->data()->dataRange());
@@ -1232,18 +1777,18 @@ void MainWindow::onPlotSelectionChanged()
     if (!graph)
         return;
 
-    QString uniqueID = graph->property("id").toString();
-    if (uniqueID.isEmpty())
+    SignalHandle handle = m_signalRegistry->handleOf(graph);
+    if (handle == InvalidSignalHandle)
         return;
 
-    QStandardItem *item = m_uniqueIdMap.value(uniqueID, nullptr);
-    if (!item)
+    QModelIndex index = m_signalTreeModel->indexForHandle(handle);
+    if (!index.isValid())
         return;
 
     {
         QSignalBlocker blocker(m_signalTree);
-        m_signalTree->scrollTo(item->index(), QAbstractItemView::PositionAtCenter);
-        m_signalTree->setCurrentIndex(item->index());
+        m_signalTree->scrollTo(index, QAbstractItemView::PositionAtCenter);
+        m_signalTree->setCurrentIndex(index);
     }
 }
 
@@ -1258,23 +1803,8 @@ void MainWindow::on_actionClearAllPlots_triggered()
 
     m_cursorManager->clearCursors();
 
-    {
-        const QSignalBlocker blocker(m_signalTreeModel);
-
-        // 遍历当前记录在案的所有信号映射
-        for (auto it = m_plotSignalMap.begin(); it != m_plotSignalMap.end(); ++it)
-        {
-            const QSet<QString> &signalIDs = it.value();
-            for (const QString &uniqueID : signalIDs)
-            {
-                QStandardItem *item = m_uniqueIdMap.value(uniqueID, nullptr);
-                if (item)
-                {
-                    item->setCheckState(Qt::Unchecked);
-                }
-            }
-        }
-    }
+    // 取消勾选所有信号 (不触发添加/移除)
+    m_signalTreeModel->setCheckedSignals(QSet<SignalHandle>());
 
     // 3. 清空所有子图的 Graph 对象
     int legendMode = m_legendPosGroup->checkedAction() ? m_legendPosGroup->checkedAction()->data().toInt() : 1;
@@ -1286,10 +1816,11 @@ void MainWindow::on_actionClearAllPlots_triggered()
 
         plot->clearGraphs();
         configurePlotLegend(plot, legendMode);
-        plot->replot();
+        m_renderScheduler->requestReplot(plot);
     }
 
     m_plotSignalMap.clear();
+    scheduleCursorReadoutUpdate();
 
     m_cursorManager->setupCursors();
     m_cursorManager->updateAllCursors();
@@ -1394,140 +1925,70 @@ void MainWindow::populateSignalTree(const FileData &data)
 {
     QString filename = QFileInfo(data.filePath).fileName();
 
-    QStandardItem *fileItem = new QStandardItem(filename);
-    fileItem->setEditable(false);
-    fileItem->setCheckable(false); // 文件条目本身不可勾选
-    fileItem->setData(filename, FileNameRole);
-    fileItem->setData(true, IsFileItemRole);
-    fileItem->setData(false, IsSignalItemRole);
-    m_signalTreeModel->appendRow(fileItem);
-
-    // 遍历所有表 (对于 CSV，只有一个表)
-    for (int t_idx = 0; t_idx < data.tables.size(); ++t_idx)
+    if (m_colorList.isEmpty()) // 安全检查
     {
-        const SignalTable &table = data.tables.at(t_idx);
-
-        // 如果只有一个表，并且其名称与文件名相同，则跳过创建表节点
-        bool skipTableNode = (data.tables.size() == 1 && table.name == QFileInfo(filename).completeBaseName());
-
-        QStandardItem *parentItem = fileItem;
-        if (!skipTableNode)
-        {
-            QStandardItem *tableItem = new QStandardItem(table.name);
-            tableItem->setEditable(false);
-            tableItem->setCheckable(false);
-            tableItem->setData(filename, FileNameRole);
-            tableItem->setData(false, IsFileItemRole);
-            tableItem->setData(false, IsSignalItemRole);
-            fileItem->appendRow(tableItem);
-            parentItem = tableItem; // 信号将附加到表条目
-        }
-
-        // 格式: "filename/tablename/"
-        QString idPrefix = filename + "/" + table.name + "/";
-
-        // 使用表中的 headers
-        for (int i = 0; i < table.headers.count(); ++i)
-        {
-            QString signalName = table.headers[i].trimmed();
-            if (signalName.isEmpty())
-                signalName = tr("Signal %1").arg(i + 1);
-
-            QStandardItem *item = new QStandardItem(signalName);
-            item->setEditable(false);
-            item->setCheckable(true);
-            item->setCheckState(Qt::Unchecked);
-
-            QString uniqueID = idPrefix + QString::number(i);
-
-            item->setData(uniqueID, UniqueIdRole);
-            item->setData(false, IsFileItemRole);
-            item->setData(true, IsSignalItemRole);
-            item->setData(filename, FileNameRole);
-
-            if (m_colorList.isEmpty()) // 安全检查
-            {
-                m_colorList << Qt::black;
-            }
-
-            QColor color = m_colorList.at(m_colorIndex);
-            m_colorIndex = (m_colorIndex + 1) % m_colorList.size();
-
-            // 将默认宽度为 2  QPen pen(color, 2); 宽度2绘制密集线段会卡
-            QPen pen(color, 1);
+        m_colorList << Qt::black;
+        m_signalTreeModel->setColorList(m_colorList);
+    }
 
-            item->setData(QVariant::fromValue(pen), PenDataRole);
+    // 信号条目由模型按需生成，这里只登记文件并推进颜色序号
+    SignalHandle firstHandle = m_signalRegistry->registerFile(filename, data);
+    int signalCount = m_signalTreeModel->addFile(filename, data, firstHandle, m_colorIndex);
+    m_colorIndex = (m_colorIndex + signalCount) % m_colorList.size();
 
-            parentItem->appendRow(item); // 添加到父条目 (文件或表)
+    // 在工作线程中为新文件建立搜索索引
+    m_signalSearch->addFile(filename, data);
 
-            m_uniqueIdMap.insert(uniqueID, item);
-        }
+    // 展开文件和表节点；大表的信号行由视图滚动时分批加载
+    QModelIndex fileIndex = m_signalTreeModel->index(m_signalTreeModel->rowCount() - 1, 0);
+    m_signalTree->expand(fileIndex);
+    for (int row = 0; row < m_signalTreeModel->rowCount(fileIndex); ++row)
+    {
+        QModelIndex child = m_signalTreeModel->index(row, 0, fileIndex);
+        if (!child.data(IsSignalItemRole).toBool())
+            m_signalTree->expand(child);
     }
 }
 
 void MainWindow::updateSignalTreeChecks()
 {
-    QSignalBlocker blocker(m_signalTreeModel);
-
-    // 1. 获取当前活动子图的信号集合
-    int activePlotIndex = m_plotWidgets.indexOf(m_activePlot);
-    const QSet<QString> &activeSignals = m_plotSignalMap.value(activePlotIndex);
-
-    // 2. 遍历所有已加载的信号条目
-    for (auto it = m_uniqueIdMap.constBegin(); it != m_uniqueIdMap.constEnd(); ++it)
-    {
-        QStandardItem *item = it.value();
-        QString uniqueID = it.key();
-
-        // 3. 检查该信号是否在当前活动子图中
-        bool shouldBeChecked = activeSignals.contains(uniqueID);
-        Qt::CheckState newState = shouldBeChecked ? Qt::Checked : Qt::Unchecked;
-
-        // 4. 仅在状态实际改变时才调用 setCheckState (虽然信号被阻塞，但这能减少 Model 内部的变更标记处理)
-        if (item->checkState() != newState)
-        {
-            item->setCheckState(newState);
-        }
-    }
+    // 勾选状态与当前活动子图的信号集合保持一致
+    int activePlotIndex = plotIndexOf(m_activePlot);
+    m_signalTreeModel->setCheckedSignals(m_plotSignalMap.value(activePlotIndex));
 }
 
-void MainWindow::onSignalItemChanged(QStandardItem *item)
+void MainWindow::onSignalCheckChanged(SignalHandle handle, bool checked)
 {
-    if (!item || !item->data(IsSignalItemRole).toBool())
+    if (handle == InvalidSignalHandle)
         return;
 
     if (m_fileDataMap.isEmpty())
     {
-        if (item->checkState() == Qt::Checked)
+        if (checked)
         {
-            item->setCheckState(Qt::Unchecked);
+            m_signalTreeModel->setChecked(handle, false);
         }
         return;
     }
 
-    int plotIndex = m_plotWidgets.indexOf(m_activePlot);
+    int plotIndex = plotIndexOf(m_activePlot);
     if (!m_activePlot || plotIndex == -1)
     {
-        if (item->checkState() == Qt::Checked)
+        if (checked)
         {
-            QSignalBlocker blocker(m_signalTreeModel);
-            item->setCheckState(Qt::Unchecked);
+            m_signalTreeModel->setChecked(handle, false);
             QMessageBox::information(this, tr("No Plot Selected"), tr("Please click on a plot to activate it before adding a signal."));
         }
         return;
     }
 
-    QString uniqueID = item->data(UniqueIdRole).toString();
-    if (uniqueID.isEmpty())
-        return;
-
-    if (item->checkState() == Qt::Checked)
+    if (checked)
     {
-        addSignalToPlot(uniqueID, m_activePlot);
+        addSignalToPlot(handle, m_activePlot);
     }
     else
     {
-        removeSignalFromPlot(uniqueID, m_activePlot);
+        removeSignalFromPlot(handle, m_activePlot);
     }
 }
 
@@ -1535,9 +1996,8 @@ void MainWindow::onSignalItemDoubleClicked(const QModelIndex &index)
 {
     if (!index.isValid())
         return;
-    QStandardItem *item = m_signalTreeModel->itemFromIndex(index);
     // 1. 检查是否为信号条目
-    if (!item || !item->data(IsSignalItemRole).toBool())
+    if (!index.data(IsSignalItemRole).toBool())
         return;
 
     // 2. 检查点击位置
@@ -1562,8 +2022,8 @@ void MainWindow::onSignalItemDoubleClicked(const QModelIndex &index)
     }
 
     // 3. 如果点击在预览线上，则打开新对话框
-    QString uniqueID = item->data(UniqueIdRole).toString();
-    QPen currentPen = item->data(PenDataRole).value<QPen>();
+    SignalHandle handle = index.data(SignalHandleRole).toInt();
+    QPen currentPen = index.data(PenDataRole).value<QPen>();
 
     // 使用新的自定义对话框
     SignalPropertiesDialog dialog(currentPen, this);
@@ -1574,20 +2034,13 @@ void MainWindow::onSignalItemDoubleClicked(const QModelIndex &index)
 
     QPen newPen = dialog.getSelectedPen(); // 获取包含所有属性的新 QPen
 
-    item->setData(QVariant::fromValue(newPen), PenDataRole);
+    m_signalTreeModel->setSignalPen(handle, newPen);
 
     // 更新所有图表中该信号的画笔
-    for (QCustomPlot *plot : m_plotWidgets)
+    for (QCPGraph *graph : m_signalRegistry->graphs(handle))
     {
-        for (int i = 0; i < plot->graphCount(); ++i)
-        {
-            QCPGraph *graph = plot->graph(i);
-            if (graph && graph->property("id").toString() == uniqueID)
-            {
-                graph->setPen(newPen);
-                graph->parentPlot()->replot();
-            }
-        }
+        graph->setPen(newPen);
+        m_renderScheduler->requestReplot(graph->parentPlot());
     }
 }
 
@@ -1598,21 +2051,307 @@ void MainWindow::onSignalTreeContextMenu(const QPoint &pos)
     if (!index.isValid())
         return;
 
-    QStandardItem *item = m_signalTreeModel->itemFromIndex(index);
+    QMenu contextMenu(this);
 
-    if (!item || !item->data(IsFileItemRole).toBool())
-        return; // 只在文件条目上显示菜单
+    // 信号条目：直方图
+    if (index.data(IsSignalItemRole).toBool())
+    {
+        const SignalHandle handle = index.data(SignalHandleRole).toInt();
+        QAction *histogramAction = contextMenu.addAction(tr("直方图..."));
+        connect(histogramAction, &QAction::triggered, [this, handle]()
+                { showSignalHistogram(handle); });
+        contextMenu.exec(m_signalTree->viewport()->mapToGlobal(pos));
+        return;
+    }
 
-    QString filename = item->data(FileNameRole).toString();
+    // 其余只在文件和表条目上显示菜单
+    if (!m_signalTreeModel->hasChildren(index))
+        return;
 
-    QMenu contextMenu(this);
-    QAction *deleteAction = contextMenu.addAction(tr("Remove '%1'").arg(filename));
-    deleteAction->setData(filename); // 将文件名存储在动作中
+    QPersistentModelIndex node(index);
+    QAction *checkAllAction = contextMenu.addAction(tr("Check All Signals"));
+    connect(checkAllAction, &QAction::triggered, [this, node]()
+            { setChildSignalsChecked(node, true); });
+    QAction *uncheckAllAction = contextMenu.addAction(tr("Uncheck All Signals"));
+    connect(uncheckAllAction, &QAction::triggered, [this, node]()
+            { setChildSignalsChecked(node, false); });
+
+    if (index.data(IsFileItemRole).toBool())
+    {
+        QString filename = index.data(FileNameRole).toString();
+
+        contextMenu.addSeparator();
+        QAction *deleteAction = contextMenu.addAction(tr("Remove '%1'").arg(filename));
+        deleteAction->setData(filename); // 将文件名存储在动作中
+
+        connect(deleteAction, &QAction::triggered, this, &MainWindow::onDeleteFileAction);
+    }
 
-    connect(deleteAction, &QAction::triggered, this, &MainWindow::onDeleteFileAction);
     contextMenu.exec(m_signalTree->viewport()->mapToGlobal(pos));
 }
 
+/**
+ * @brief [辅助] 打开信号的直方图
+ * * 双游标模式下只统计两游标之间的样本，否则统计整条信号；
+ * 分布来自加载时构建的分块分位数摘要，打开后不随游标更新。
+ */
+void MainWindow::showSignalHistogram(SignalHandle handle)
+{
+    const SignalRegistry::Location loc = m_signalRegistry->location(handle);
+    if (!loc.table || loc.column < 0 || loc.column >= loc.table->quantiles.size())
+        return;
+
+    const SignalQuantiles &quantiles = loc.table->quantiles.at(loc.column);
+    const QVector<double> &values = loc.table->valueData.at(loc.column);
+    QString title = m_signalTreeModel->signalName(handle);
+
+    QuantileDigest digest;
+    if (m_cursorManager->getMode() == CursorManager::DoubleCursor)
+    {
+        const double key1 = qMin(m_cursorManager->cursorKey(1), m_cursorManager->cursorKey(2));
+        const double key2 = qMax(m_cursorManager->cursorKey(1), m_cursorManager->cursorKey(2));
+        const QVector<double> &keys = loc.table->timeData;
+        const int n = qMin(keys.size(), values.size());
+        const double *t = keys.constData();
+        const int begin = int(std::lower_bound(t, t + n, key1) - t);
+        const int end = int(std::upper_bound(t, t + n, key2) - t);
+        digest = quantiles.rangeDigest(values, begin, end);
+        title += tr(" [%1, %2]").arg(key1).arg(key2);
+    }
+    else
+    {
+        digest = quantiles.total();
+    }
+
+    HistogramDialog *dialog = new HistogramDialog(tr("直方图 - %1").arg(title), digest, this);
+    dialog->show();
+}
+
+/**
+ * @brief [槽] 新建派生信号
+ * * 表达式在 GUI 线程中编译以便立即报告语法错误，求值在数据线程中分块并行进行；
+ * 引用的信号来自不同时间轴时，先按所选方式重采样到公共时间轴
+ */
+void MainWindow::on_actionNewDerivedSignal_triggered()
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle(tr("新建派生信号"));
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(&dialog);
+    QFormLayout *formLayout = new QFormLayout;
+
+    QLineEdit *nameEdit = new QLineEdit(&dialog);
+    nameEdit->setPlaceholderText(tr("例如 speed_kmh"));
+    QLineEdit *expressionEdit = new QLineEdit(&dialog);
+    expressionEdit->setPlaceholderText(tr("例如 speed*3.6 或 sqrt(ax^2+ay^2)"));
+    expressionEdit->setMinimumWidth(360);
+
+    QLabel *hintLabel = new QLabel(tr("支持 + - * / ^、括号、常量 pi 和函数 sqrt abs exp log log10 sin cos tan "
+                                      "asin acos atan floor ceil min max atan2 pow。\n"
+                                      "含空格或运算符的信号名用双引号括起来，例如 \"Engine Speed\"。"),
+                                   &dialog);
+    hintLabel->setWordWrap(true);
+
+    // 跨表 (不同时间轴) 时的对齐方式
+    QComboBox *axisBox = new QComboBox(&dialog);
+    axisBox->addItem(tr("所有时间轴的并集"), int(SignalResampler::UnionAxis));
+    axisBox->addItem(tr("参考信号的时间轴"), int(SignalResampler::ReferenceAxis));
+    axisBox->addItem(tr("均匀网格"), int(SignalResampler::UniformGrid));
+
+    QComboBox *interpolationBox = new QComboBox(&dialog);
+    interpolationBox->addItem(tr("线性"), int(SignalResampler::Linear));
+    interpolationBox->addItem(tr("零阶保持"), int(SignalResampler::ZeroOrderHold));
+    interpolationBox->addItem(tr("最近邻"), int(SignalResampler::Nearest));
+
+    // 参考信号的候选项随表达式引用的信号更新，尽量保留之前的选择
+    QComboBox *referenceBox = new QComboBox(&dialog);
+    referenceBox->setEnabled(false);
+    connect(expressionEdit, &QLineEdit::textChanged, referenceBox, [referenceBox](const QString &text)
+            {
+                DerivedExpression expression;
+                if (!expression.compile(text))
+                    return;
+                const QString current = referenceBox->currentText();
+                referenceBox->clear();
+                referenceBox->addItems(expression.variables());
+                referenceBox->setCurrentIndex(qMax(0, expression.variables().indexOf(current)));
+            });
+
+    QDoubleSpinBox *stepSpinBox = new QDoubleSpinBox(&dialog);
+    stepSpinBox->setDecimals(6);
+    stepSpinBox->setRange(0.0, 1e6);
+    stepSpinBox->setSpecialValueText(tr("自动 (最小中位采样间隔)"));
+    stepSpinBox->setEnabled(false);
+    connect(axisBox, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), &dialog, [axisBox, referenceBox, stepSpinBox]()
+            {
+                const int mode = axisBox->currentData().toInt();
+                referenceBox->setEnabled(mode == SignalResampler::ReferenceAxis);
+                stepSpinBox->setEnabled(mode == SignalResampler::UniformGrid);
+            });
+
+    formLayout->addRow(tr("名称:"), nameEdit);
+    formLayout->addRow(tr("表达式:"), expressionEdit);
+    formLayout->addRow(tr("时间轴对齐:"), axisBox);
+    formLayout->addRow(tr("参考信号:"), referenceBox);
+    formLayout->addRow(tr("插值:"), interpolationBox);
+    formLayout->addRow(tr("网格步长:"), stepSpinBox);
+
+    QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    connect(buttonBox, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttonBox, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+
+    mainLayout->addLayout(formLayout);
+    mainLayout->addWidget(hintLabel);
+    mainLayout->addWidget(buttonBox);
+
+    // 输入有误时保留内容重新打开对话框
+    while (dialog.exec() == QDialog::Accepted)
+    {
+        // 名称会成为虚拟文件名的一部分，不能含路径分隔符
+        QString name = nameEdit->text().trimmed();
+        name.replace('/', '_');
+        name.replace('\\', '_');
+
+        DerivedExpression expression;
+        QString error;
+        QVector<SignalRegistry::Location> inputs;
+        bool resolved = false;
+        if (name.isEmpty())
+            error = tr("请输入名称");
+        else if (expression.compile(expressionEdit->text(), &error))
+            resolved = resolveDerivedInputs(expression.variables(), &inputs, &error);
+
+        if (!resolved)
+        {
+            QMessageBox::warning(this, tr("派生信号"), error);
+            continue;
+        }
+
+        DerivedSignalRequest request;
+        request.name = name;
+        request.expression = expressionEdit->text().trimmed();
+        request.axisMode = static_cast<SignalResampler::AxisMode>(axisBox->currentData().toInt());
+        request.interpolation = static_cast<SignalResampler::Interpolation>(interpolationBox->currentData().toInt());
+        // inputs 与 variables() 一一对应，参考信号的序号即其在 variables() 中的位置
+        request.referenceInput = qMax(0, expression.variables().indexOf(referenceBox->currentText()));
+        request.gridStep = stepSpinBox->value();
+        QVector<const double *> axisIds;
+        double start = -qInf();
+        double end = qInf();
+        for (const SignalRegistry::Location &input : inputs)
+        {
+            request.inputKeys.append(input.table->timeData);
+            request.inputs.append(input.table->valueData.at(input.column));
+
+            // 自动步长：各输入表中最小的中位采样间隔
+            const double medianDt = input.table->stats.medianDt;
+            if (stepSpinBox->value() <= 0 && medianDt > 0 && (request.gridStep <= 0 || medianDt < request.gridStep))
+                request.gridStep = medianDt;
+
+            if (!axisIds.contains(input.table->timeData.constData()))
+                axisIds.append(input.table->timeData.constData());
+            if (!input.table->timeData.isEmpty())
+            {
+                start = qMax(start, input.table->timeData.first());
+                end = qMin(end, input.table->timeData.last());
+            }
+        }
+
+        // 与数据线程相同，只有一条时间轴时无需对齐，网格步长不起作用
+        if (request.axisMode == SignalResampler::UniformGrid && axisIds.size() > 1)
+        {
+            if (request.gridStep <= 0)
+            {
+                QMessageBox::warning(this, tr("派生信号"), tr("无法自动确定网格步长，请手动输入"));
+                continue;
+            }
+            // 与数据线程的预算一致：网格、各输入和输出列
+            const int maxPoints = SignalResampler::maxGridPoints(request.inputs.size() + 2);
+            if (SignalResampler::gridPointCount(start, end, request.gridStep) > maxPoints)
+            {
+                QMessageBox::warning(this, tr("派生信号"),
+                                     tr("网格步长 %1 过小：公共时间范围内的网格将超过 %2 个点")
+                                         .arg(request.gridStep)
+                                         .arg(maxPoints));
+                continue;
+            }
+        }
+
+        statusBar()->showMessage(tr("正在计算派生信号 %1...").arg(name), 3000);
+        emit requestDerivedSignal(request);
+        return;
+    }
+}
+
+/**
+ * @brief [辅助] 把表达式引用的信号名解析为数据列
+ * * 同名信号按导入视图的同名策略排序，优先选第一个包含全部信号的表 (无需重采样)；
+ * 没有这样的表时各信号分别按同名策略解析，由数据线程对齐时间轴
+ */
+bool MainWindow::resolveDerivedInputs(const QStringList &names, QVector<SignalRegistry::Location> *inputs,
+                                      QString *errorMessage) const
+{
+    inputs->clear();
+    if (names.isEmpty())
+    {
+        *errorMessage = tr("表达式至少需要引用一个信号");
+        return false;
+    }
+
+    QVector<SignalHandle> candidates = m_signalRegistry->handlesForName(names.first());
+    if (candidates.isEmpty())
+    {
+        *errorMessage = tr("找不到信号 '%1'").arg(names.first());
+        return false;
+    }
+    if (m_signalRegistry->duplicateNamePolicy() == SignalRegistry::PreferNewestFile)
+        std::reverse(candidates.begin(), candidates.end());
+
+    for (SignalHandle candidate : candidates)
+    {
+        const SignalRegistry::Location first = m_signalRegistry->location(candidate);
+        if (!first.table)
+            continue;
+
+        QVector<SignalRegistry::Location> found;
+        found.append(first);
+        for (int i = 1; i < names.size(); ++i)
+        {
+            for (SignalHandle handle : m_signalRegistry->handlesForName(names.at(i)))
+            {
+                const SignalRegistry::Location loc = m_signalRegistry->location(handle);
+                if (loc.table == first.table)
+                {
+                    found.append(loc);
+                    break;
+                }
+            }
+            if (found.size() != i + 1)
+                break;
+        }
+
+        if (found.size() == names.size())
+        {
+            *inputs = found;
+            return true;
+        }
+    }
+
+    // 不在同一张表中：分别解析
+    for (const QString &name : names)
+    {
+        const SignalRegistry::Location loc = m_signalRegistry->location(m_signalRegistry->handleForName(name));
+        if (!loc.table)
+        {
+            inputs->clear();
+            *errorMessage = tr("找不到信号 '%1'").arg(name);
+            return false;
+        }
+        inputs->append(loc);
+    }
+    return true;
+}
+
 /**
  * @brief 响应重放按钮切换
  */
@@ -1626,36 +2365,46 @@ void MainWindow::onReplayActionToggled(bool checked)
     }
 }
 
+/**
+ * @brief [槽] 切换游标吸附模式
+ */
+void MainWindow::onSnapModeTriggered(QAction *action)
+{
+    m_cursorManager->setSnapMode(static_cast<CursorManager::SnapMode>(action->data().toInt()));
+}
+
+/**
+ * @brief [槽] 切换导入视图时同名信号的解析策略
+ */
+void MainWindow::onDuplicateNamePolicyTriggered(QAction *action)
+{
+    m_signalRegistry->setDuplicateNamePolicy(static_cast<SignalRegistry::DuplicateNamePolicy>(action->data().toInt()));
+}
+
 /**
  * @brief  获取全局时间范围
  */
 QCPRange MainWindow::getGlobalTimeRange() const
 {
-    if (m_fileDataMap.isEmpty())
-        return QCPRange(0, 1);
-
+    // 各文件的时间范围在加载时已汇总，这里只遍历文件
     bool first = true;
     QCPRange totalRange;
-    for (const FileData &data : m_fileDataMap.values())
+    for (auto it = m_fileDataMap.constBegin(); it != m_fileDataMap.constEnd(); ++it)
     {
-        for (const SignalTable &table : data.tables)
+        const TableStats &stats = it.value().stats;
+        if (qIsNaN(stats.timeMin) || qIsNaN(stats.timeMax))
+            continue;
+
+        if (first)
         {
-            if (!table.timeData.isEmpty())
-            {
-                if (first)
-                {
-                    totalRange.lower = table.timeData.first();
-                    totalRange.upper = table.timeData.last();
-                    first = false;
-                }
-                else
-                {
-                    if (table.timeData.first() < totalRange.lower)
-                        totalRange.lower = table.timeData.first();
-                    if (table.timeData.last() > totalRange.upper)
-                        totalRange.upper = table.timeData.last();
-                }
-            }
+            totalRange.lower = stats.timeMin;
+            totalRange.upper = stats.timeMax;
+            first = false;
+        }
+        else
+        {
+            totalRange.lower = qMin(totalRange.lower, stats.timeMin);
+            totalRange.upper = qMax(totalRange.upper, stats.timeMax);
         }
     }
 
@@ -1670,21 +2419,15 @@ QCPRange MainWindow::getGlobalTimeRange() const
  */
 double MainWindow::getSmallestTimeStep() const
 {
-    // 查找所有文件中的最小步长
+    // 查找所有文件中的最小正步长 (加载时已按文件汇总)
     double minStep = -1.0;
 
-    for (const FileData &data : m_fileDataMap.values())
+    for (auto it = m_fileDataMap.constBegin(); it != m_fileDataMap.constEnd(); ++it)
     {
-        for (const SignalTable &table : data.tables)
+        const double step = it.value().stats.minDt;
+        if (step > 0 && (minStep == -1.0 || step < minStep))
         {
-            if (table.timeData.size() >= 2)
-            {
-                double step = table.timeData.at(1) - table.timeData.at(0);
-                if (step > 0 && (minStep == -1.0 || step < minStep))
-                {
-                    minStep = step;
-                }
-            }
+            minStep = step;
         }
     }
 
@@ -1692,35 +2435,16 @@ double MainWindow::getSmallestTimeStep() const
 }
 
 /**
- * @brief  从 m_plotGraphMap 中安全地获取一个 QCPGraph*
+ * @brief  从信号注册表中获取信号在子图上的 QCPGraph*
  * @param plot QCustomPlot 控件
- * @param uniqueID 信号的唯一ID ("filename/tablename/signalindex")
+ * @param handle 信号句柄
  * @return 如果找到则返回 QCPGraph*，否则返回 nullptr
  */
-QCPGraph *MainWindow::getGraph(QCustomPlot *plot, const QString &uniqueID) const
+QCPGraph *MainWindow::getGraph(QCustomPlot *plot, SignalHandle handle) const
 {
     if (!plot)
         return nullptr;
-    for (int i = 0; i < plot->graphCount(); ++i)
-    {
-        QCPGraph *graph = plot->graph(i);
-        if (graph && graph->property("id").toString() == uniqueID)
-        {
-            return graph;
-        }
-    }
-    return nullptr;
-}
-
-/**
- * @brief  从 QStandardItem 构建 UniqueID
- */
-QString MainWindow::getUniqueID(QStandardItem *item) const
-{
-    if (!item || !item->data(IsSignalItemRole).toBool())
-        return QString();
-
-    return item->data(UniqueIdRole).toString();
+    return m_signalRegistry->graph(plot, handle);
 }
 
 /**
@@ -1730,6 +2454,8 @@ void MainWindow::updateCursorsForLayoutChange()
 {
     if (m_cursorManager->getMode() != CursorManager::NoCursor)
     {
+        // 复用的子图保留游标图元，新子图补建，已删除子图的记录被清理
+        m_cursorManager->setupCursors();
         m_cursorManager->updateAllCursors();
     }
 }
@@ -1743,19 +2469,18 @@ void MainWindow::onDeleteSignalAction()
     if (!action)
         return;
 
-    QString uniqueID = action->data().toString();
-    if (uniqueID.isEmpty())
+    bool ok = false;
+    SignalHandle handle = action->data().toInt(&ok);
+    if (!ok)
         return;
 
-    QStandardItem *itemToUncheck = m_uniqueIdMap.value(uniqueID, nullptr);
-
-    if (itemToUncheck)
+    if (m_signalTreeModel->contains(handle))
     {
-        itemToUncheck->setCheckState(Qt::Unchecked);
+        m_signalTreeModel->setChecked(handle, false, true);
     }
     else
     {
-        qWarning() << "onDeleteSignalAction: Could not find item in tree model for ID" << uniqueID;
+        qWarning() << "onDeleteSignalAction: Could not find item in tree model for handle" << handle;
     }
 }
 
@@ -1773,92 +2498,148 @@ void MainWindow::onDeleteSubplotAction()
     if (!m_plotSignalMap.contains(plotIndex))
         return;
 
-    const QSet<QString> signalIDsCopy = m_plotSignalMap.value(plotIndex);
+    const QSet<SignalHandle> handlesCopy = m_plotSignalMap.value(plotIndex);
 
-    if (signalIDsCopy.isEmpty())
+    if (handlesCopy.isEmpty())
         return;
 
-    qDebug() << "Clearing subplot index" << plotIndex << "- removing" << signalIDsCopy.size() << "signals.";
+    qDebug() << "Clearing subplot index" << plotIndex << "- removing" << handlesCopy.size() << "signals.";
 
-    for (const QString &uniqueID : signalIDsCopy)
+    for (SignalHandle handle : handlesCopy)
     {
-        QStandardItem *itemToUncheck = m_uniqueIdMap.value(uniqueID, nullptr);
-
-        // 如果找到了，并且它当前被选中，则取消勾选它
-        if (itemToUncheck && itemToUncheck->checkState() == Qt::Checked)
-        {
-            itemToUncheck->setCheckState(Qt::Unchecked);
-        }
+        // 如果它当前被选中，则取消勾选它
+        m_signalTreeModel->setChecked(handle, false, true);
     }
 }
 
 /**
  * @brief [槽] 当信号搜索框中的文本更改时调用
  */
-void MainWindow::onSignalSearchChanged(const QString &text)
+void MainWindow::onSignalSearchResult(const SignalSearchResult &result)
 {
-    QString query = text.trimmed().toLower();
-    QStandardItem *root = m_signalTreeModel->invisibleRootItem();
-
-    // 递归地遍历所有项并设置它们的隐藏状态
-    for (int i = 0; i < root->rowCount(); ++i)
+    // 正则表达式无效时保留上一次的过滤结果
+    if (!result.error.isEmpty())
     {
-        filterSignalTree(root->child(i), query);
+        m_signalSearchStatus->setText(tr("正则表达式无效: %1").arg(result.error));
+        return;
     }
 
-    // 如果在搜索，展开所有内容以显示匹配项
-    if (!query.isEmpty())
-    {
-        m_signalTree->expandAll();
-    }
+    m_signalSearchStatus->setText(result.active ? tr("%1 个信号匹配").arg(result.matchCount) : QString());
+
+    m_signalFilter = result;
+    applySignalFilter();
 }
 
 /**
- * @brief [辅助函数] 递归地过滤信号树。
- * @param item 当前要检查的 QStandardItem
- * @param query 小写的搜索查询
- * @return true 如果此项或其任何子项匹配查询，则返回
+ * @brief [槽] 视图追加加载信号行时，按当前搜索结果隐藏新行
  */
-bool MainWindow::filterSignalTree(QStandardItem *item, const QString &query)
+void MainWindow::onSignalRowsInserted(const QModelIndex &parent, int first, int last)
 {
-    if (!item)
-        return false;
+    if (parent.isValid())
+        updateHiddenSignalRows(parent, first, last);
+}
 
-    // 1. 检查此项是否匹配
-    bool selfMatches = item->text().toLower().contains(query);
+/**
+ * @brief [辅助函数] 把当前搜索结果应用到信号树
+ * * 只对可见性发生变化的行调用 setRowHidden；匹配的节点被展开，
+ * 匹配行所在的批次会被加载到视图，以免被前面隐藏的行挡住无法滚动到
+ */
+void MainWindow::applySignalFilter()
+{
+    const bool active = m_signalFilter.active;
 
-    // 2. 检查是否有任何子项匹配
-    bool childrenMatch = false;
-    for (int i = 0; i < item->rowCount(); ++i)
+    for (int f = 0; f < m_signalTreeModel->rowCount(); ++f)
     {
-        if (filterSignalTree(item->child(i), query))
+        QModelIndex fileIndex = m_signalTreeModel->index(f, 0);
+        const QString filename = fileIndex.data(FileNameRole).toString();
+
+        // 扁平文件的信号直接挂在文件节点下
+        QList<QModelIndex> signalParents;
+        if (!m_signalTreeModel->tablePrefix(fileIndex).isEmpty())
         {
-            childrenMatch = true;
+            signalParents << fileIndex;
+        }
+        else
+        {
+            for (int t = 0; t < m_signalTreeModel->rowCount(fileIndex); ++t)
+                signalParents << m_signalTreeModel->index(t, 0, fileIndex);
         }
-    }
 
-    // 3. 决定可见性
-    bool visible = selfMatches || childrenMatch;
+        bool fileVisible = !active || m_signalFilter.nodes.contains(filename);
+        for (const QModelIndex &parent : signalParents)
+        {
+            const QString prefix = m_signalTreeModel->tablePrefix(parent);
+            const QBitArray matches = m_signalFilter.rows.value(prefix);
 
-    // 4. 如果查询为空，所有项都可见
-    if (query.isEmpty())
-    {
-        visible = true;
+            if (active && !matches.isEmpty())
+            {
+                int lastMatch = matches.size() - 1;
+                while (!matches.testBit(lastMatch))
+                    --lastMatch;
+                m_signalTreeModel->fetchUpTo(parent, lastMatch);
+            }
+
+            updateHiddenSignalRows(parent, 0, m_signalTreeModel->rowCount(parent) - 1);
+
+            const bool tableVisible = !active || !matches.isEmpty() || m_signalFilter.nodes.contains(prefix);
+            if (parent != fileIndex)
+                setTreeNodeHidden(parent, prefix, !tableVisible);
+            if (active && !matches.isEmpty())
+                m_signalTree->expand(parent);
+
+            fileVisible = fileVisible || tableVisible;
+        }
+
+        setTreeNodeHidden(fileIndex, filename, !fileVisible);
+        if (active && fileVisible)
+            m_signalTree->expand(fileIndex);
     }
+}
+
+/**
+ * @brief [辅助函数] 按当前搜索结果更新一段信号行的隐藏状态 (只处理变化的行)
+ */
+void MainWindow::updateHiddenSignalRows(const QModelIndex &parent, int first, int last)
+{
+    const QString prefix = m_signalTreeModel->tablePrefix(parent);
+    if (prefix.isEmpty() || last < first)
+        return;
+
+    auto it = m_hiddenSignalRows.find(prefix);
+    if (!m_signalFilter.active && (it == m_hiddenSignalRows.end() || it.value().count(true) == 0))
+        return; // 没有过滤，也没有被隐藏的行
 
-    // 5. 在视图中设置行隐藏
-    QModelIndex parentIndex = item->parent() ? item->parent()->index() : QModelIndex();
-    m_signalTree->setRowHidden(item->row(), parentIndex, !visible);
+    if (it == m_hiddenSignalRows.end())
+        it = m_hiddenSignalRows.insert(prefix, QBitArray());
+    QBitArray &hidden = it.value();
+    if (hidden.size() <= last)
+        hidden.resize(last + 1);
 
-    return visible;
+    const QBitArray matches = m_signalFilter.rows.value(prefix);
+    for (int row = first; row <= last; ++row)
+    {
+        const bool hide = m_signalFilter.active && (row >= matches.size() || !matches.testBit(row));
+        if (hidden.testBit(row) != hide)
+        {
+            hidden.setBit(row, hide);
+            m_signalTree->setRowHidden(row, parent, hide);
+        }
+    }
 }
 
 /**
- * @brief [辅助] 在信号树中通过信号名称查找条目
+ * @brief [辅助函数] 设置文件或表节点的隐藏状态 (仅在变化时调用 setRowHidden)
  */
-QStandardItem *MainWindow::findItemBySignalName(const QString &name)
+void MainWindow::setTreeNodeHidden(const QModelIndex &index, const QString &key, bool hidden)
 {
-    return findItemByName_Recursive(m_signalTreeModel->invisibleRootItem(), name);
+    if (m_hiddenTreeNodes.contains(key) == hidden)
+        return;
+
+    if (hidden)
+        m_hiddenTreeNodes.insert(key);
+    else
+        m_hiddenTreeNodes.remove(key);
+    m_signalTree->setRowHidden(index.row(), index.parent(), hidden);
 }
 
 /**
@@ -1871,7 +2652,7 @@ void MainWindow::on_actionToggleLegend_toggled(bool checked)
         if (plot && plot->legend)
         {
             plot->legend->setVisible(checked);
-            plot->replot();
+            m_renderScheduler->requestReplot(plot);
         }
     }
 }
@@ -1883,32 +2664,18 @@ void MainWindow::on_actionToggleLegend_toggled(bool checked)
  */
 void MainWindow::applyImportedView(const LayoutInfo &layout, const QList<SignalInfo> &signalList)
 {
-    {
-        const QSignalBlocker blocker(m_signalTreeModel);
-
-        QList<int> plotIndices = m_plotSignalMap.keys();
-        for (int plotIndex : plotIndices)
-        {
-            const QSet<QString> signalIDsCopy = m_plotSignalMap.value(plotIndex);
-            for (const QString &uniqueID : signalIDsCopy)
-            {
-                QStandardItem *item = m_uniqueIdMap.value(uniqueID, nullptr);
-                if (item)
-                {
-                    item->setCheckState(Qt::Unchecked);
-                }
-            }
-        }
-    }
+    // 1. 取消勾选所有信号 (不触发添加/移除)
+    m_signalTreeModel->setCheckedSignals(QSet<SignalHandle>());
 
     m_plotSignalMap.clear();
+    scheduleCursorReadoutUpdate();
 
     // 2. 设置新布局
     qDebug() << "Applying layout:" << layout.rows << "rows," << layout.cols << "cols";
     setupPlotLayout(layout.rows, layout.cols);
 
     // 确保我们有足够多的子图
-    if (m_plotWidgets.isEmpty())
+    if (m_plotCells.isEmpty())
     {
         QMessageBox::warning(this, tr("Import Error"), tr("Failed to create plot layout."));
         return;
@@ -1917,7 +2684,7 @@ void MainWindow::applyImportedView(const LayoutInfo &layout, const QList<SignalI
     // 3. 遍历信号列表并应用设置 (包含索引转换)
     const int numRows = layout.rows;
     const int numCols = layout.cols;
-    const int totalPlots = m_plotWidgets.size();
+    const int totalPlots = m_plotCells.size();
 
     if (numRows <= 0 || numCols <= 0 || totalPlots == 0)
     {
@@ -1927,22 +2694,18 @@ void MainWindow::applyImportedView(const LayoutInfo &layout, const QList<SignalI
 
     for (const SignalInfo &sig : signalList)
     {
-        // 在树中查找信号
-        QStandardItem *item = findItemBySignalName(sig.name);
-        if (!item)
+        // 按名称索引查找信号 (重名时按设置的策略选择文件)
+        SignalHandle handle = m_signalRegistry->handleForName(sig.name);
+        if (handle == InvalidSignalHandle)
         {
             qWarning() << "Import View: Could not find signal in tree:" << sig.name;
             continue;
         }
 
-        QString uniqueID = item->data(UniqueIdRole).toString();
-        if (uniqueID.isEmpty())
-            continue;
-
         // 更新颜色
-        QPen currentPen = item->data(PenDataRole).value<QPen>();
+        QPen currentPen = m_signalTreeModel->signalPen(handle);
         currentPen.setColor(sig.color);
-        item->setData(QVariant::fromValue(currentPen), PenDataRole);
+        m_signalTreeModel->setSignalPen(handle, currentPen);
 
         // 遍历该信号应在的子图 ID
         for (int sdiPlotId : sig.plotIds)
@@ -1965,13 +2728,9 @@ void MainWindow::applyImportedView(const LayoutInfo &layout, const QList<SignalI
 
             if (plotIndex >= 0 && plotIndex < totalPlots)
             {
-                QCustomPlot *targetPlot = m_plotWidgets.at(plotIndex);
-                addSignalToPlot(uniqueID, targetPlot, false);
-
-                {
-                    const QSignalBlocker blocker(m_signalTreeModel);
-                    item->setCheckState(Qt::Checked);
-                }
+                // 尚未创建子图的单元格只记录信号，进入视口时再生成曲线
+                addSignalToCell(handle, plotIndex, false);
+                m_signalTreeModel->setChecked(handle, true);
             }
         }
     }
@@ -1981,7 +2740,7 @@ void MainWindow::applyImportedView(const LayoutInfo &layout, const QList<SignalI
     {
         plot->rescaleAxes();
         configurePlotLegend(plot, legendMode);
-        plot->replot();
+        m_renderScheduler->requestReplot(plot);
     }
 
     updateSignalTreeChecks();
@@ -2036,7 +2795,7 @@ void MainWindow::onXAxisRangeChanged(const QCPRange &newRange)
             QSignalBlocker blocker(plot->xAxis);
             plot->xAxis->setRange(newRange);
 
-            plot->replot();
+            m_renderScheduler->requestReplot(plot);
         }
     }
 
@@ -2047,6 +2806,62 @@ void MainWindow::onXAxisRangeChanged(const QCPRange &newRange)
     }
 }
 
+/**
+ * @brief [槽] 子图即将重绘：开启 "跟随 Y" 的子图按当前 X 视野重新适配 Y 轴
+ * * 由重绘驱动而非 onXAxisRangeChanged，因此每帧最多计算一次；
+ * 借助 SignalGraph 的 LOD 范围查询，开销为 O(曲线数 * log n)
+ */
+void MainWindow::onPlotBeforeReplot()
+{
+    QCustomPlot *plot = qobject_cast<QCustomPlot *>(sender());
+    if (!plot || !plot->property("followY").toBool())
+        return;
+
+    fitPlotYRange(plot, plot->xAxis->range());
+}
+
+/**
+ * @brief [槽] 鼠标悬停：高亮光标下最接近的信号曲线
+ * * plottableAt 对每条曲线调用 selectTest，SignalGraph 的 LOD 命中测试
+ * 只检查容差内的像素列，因此密集数据下也可以逐次鼠标移动执行
+ */
+void MainWindow::onPlotMouseHover(QMouseEvent *event)
+{
+    QCustomPlot *plot = qobject_cast<QCustomPlot *>(sender());
+    if (!plot)
+        return;
+
+    // 拖拽平移或拖动游标期间不做命中测试
+    QCPGraph *graph = nullptr;
+    if (event->buttons() == Qt::NoButton)
+        graph = qobject_cast<SignalGraph *>(plot->plottableAt(event->pos(), false));
+
+    setHoveredGraph(graph);
+}
+
+/**
+ * @brief [辅助] 切换悬停高亮的曲线，仅在目标变化时重绘相关子图
+ */
+void MainWindow::setHoveredGraph(QCPGraph *graph)
+{
+    if (m_hoveredGraph.data() == graph)
+        return;
+
+    if (SignalGraph *previous = qobject_cast<SignalGraph *>(m_hoveredGraph.data()))
+    {
+        previous->setHighlighted(false);
+        m_renderScheduler->requestReplot(previous->parentPlot());
+    }
+
+    m_hoveredGraph = graph;
+
+    if (SignalGraph *current = qobject_cast<SignalGraph *>(graph))
+    {
+        current->setHighlighted(true);
+        m_renderScheduler->requestReplot(current->parentPlot());
+    }
+}
+
 void MainWindow::on_actionLayoutCustom_triggered()
 {
     // 1. 创建对话框
@@ -2086,6 +2901,59 @@ void MainWindow::on_actionLayoutCustom_triggered()
     }
 }
 
+/**
+ * @brief [槽] 配置交互期间的草稿渲染阈值
+ */
+void MainWindow::onInteractionQualitySettings()
+{
+    InteractionQuality::Settings settings = m_interactionQuality->settings();
+
+    QDialog dialog(this);
+    dialog.setWindowTitle(tr("交互渲染质量"));
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(&dialog);
+    QFormLayout *formLayout = new QFormLayout;
+
+    QCheckBox *enabledBox = new QCheckBox(tr("交互时使用草稿质量"), &dialog);
+    enabledBox->setChecked(settings.enabled);
+
+    QSpinBox *idleSpinBox = new QSpinBox(&dialog);
+    idleSpinBox->setRange(0, 2000);
+    idleSpinBox->setSingleStep(50);
+    idleSpinBox->setSuffix(tr(" ms"));
+    idleSpinBox->setValue(settings.idleDelayMs);
+
+    QDoubleSpinBox *lodSpinBox = new QDoubleSpinBox(&dialog);
+    lodSpinBox->setRange(1.0, 64.0);
+    lodSpinBox->setDecimals(1);
+    lodSpinBox->setSuffix(tr(" px"));
+    lodSpinBox->setValue(settings.draftLodFactor);
+
+    QCheckBox *antialiasBox = new QCheckBox(tr("草稿抗锯齿"), &dialog);
+    antialiasBox->setChecked(settings.draftAntialiasing);
+
+    formLayout->addRow(enabledBox);
+    formLayout->addRow(tr("恢复完整质量的空闲延迟:"), idleSpinBox);
+    formLayout->addRow(tr("草稿 LOD 桶宽:"), lodSpinBox);
+    formLayout->addRow(antialiasBox);
+
+    QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    connect(buttonBox, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttonBox, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+
+    mainLayout->addLayout(formLayout);
+    mainLayout->addWidget(buttonBox);
+
+    if (dialog.exec() != QDialog::Accepted)
+        return;
+
+    settings.enabled = enabledBox->isChecked();
+    settings.idleDelayMs = idleSpinBox->value();
+    settings.draftLodFactor = lodSpinBox->value();
+    settings.draftAntialiasing = antialiasBox->isChecked();
+    m_interactionQuality->setSettings(settings);
+}
+
 /**
  * @brief [重写] 当文件被拖入窗口时调用
  */
@@ -2138,12 +3006,16 @@ bool MainWindow::eventFilter(QObject *watched, QEvent *event)
     QCustomPlot *targetPlot = qobject_cast<QCustomPlot *>(watched);
     if (m_plotWidgets.contains(targetPlot))
     {
+        // 鼠标离开子图时取消悬停高亮 (不拦截事件)
+        if (event->type() == QEvent::Leave && m_hoveredGraph && m_hoveredGraph->parentPlot() == targetPlot)
+            setHoveredGraph(nullptr);
+
         // 2. 处理拖动进入事件 (DragEnter)
         if (event->type() == QEvent::DragEnter)
         {
             QDragEnterEvent *dragEvent = static_cast<QDragEnterEvent *>(event);
 
-            // 检查 MimeData 是否来自 QStandardItemModel (即我们的树视图)
+            // 检查 MimeData 是否来自信号树模型 (即我们的树视图)
             if (dragEvent->mimeData()->hasFormat("application/x-qabstractitemmodeldatalist"))
             {
                 // 可选：更严格的检查，确保它是一个信号条目
@@ -2156,7 +3028,7 @@ bool MainWindow::eventFilter(QObject *watched, QEvent *event)
                     stream >> r >> c >> data; // 只读取第一个条目进行检查
 
                     // 如果它是一个信号条目 (而不是文件或表)，则接受拖动
-                    if (data.contains(UniqueIdRole) && data.value(IsSignalItemRole).toBool())
+                    if (data.contains(SignalHandleRole) && data.value(IsSignalItemRole).toBool())
                     {
                         dragEvent->acceptProposedAction();
                         return true;
@@ -2171,10 +3043,13 @@ bool MainWindow::eventFilter(QObject *watched, QEvent *event)
             QByteArray encoded = dropEvent->mimeData()->data("application/x-qabstractitemmodeldatalist");
             QDataStream stream(&encoded, QIODevice::ReadOnly);
 
-            int targetPlotIndex = m_plotWidgets.indexOf(targetPlot);
+            int targetPlotIndex = plotIndexOf(targetPlot);
             if (targetPlotIndex == -1)
                 return true;
 
+            // 多选拖放：所有条目添加完成后只刷新/重建游标一次
+            PlotBatchScope batch(this);
+
             // 循环处理所有被拖拽的条目
             while (!stream.atEnd())
             {
@@ -2182,27 +3057,26 @@ bool MainWindow::eventFilter(QObject *watched, QEvent *event)
                 QMap<int, QVariant> data;
                 stream >> r >> c >> data; // 读取每个条目的数据
 
-                if (data.contains(UniqueIdRole) && data.value(IsSignalItemRole).toBool())
+                if (data.contains(SignalHandleRole) && data.value(IsSignalItemRole).toBool())
                 {
-                    QString uniqueID = data.value(UniqueIdRole).toString();
-                    QStandardItem *item = m_uniqueIdMap.value(uniqueID, nullptr);
-                    if (!item)
+                    SignalHandle handle = data.value(SignalHandleRole).toInt();
+                    if (!m_signalTreeModel->contains(handle))
                         continue;
 
-                    bool alreadyOnPlot = m_plotSignalMap.value(targetPlotIndex).contains(uniqueID);
+                    bool alreadyOnPlot = m_plotSignalMap.value(targetPlotIndex).contains(handle);
 
                     // 2. 如果不在，则添加它
                     if (!alreadyOnPlot)
                     {
                         setActivePlot(targetPlot);
 
-                        if (item->checkState() == Qt::Unchecked)
+                        if (!m_signalTreeModel->isChecked(handle))
                         {
-                            item->setCheckState(Qt::Checked);
+                            m_signalTreeModel->setChecked(handle, true, true);
                         }
                         else
                         {
-                            addSignalToPlot(uniqueID, targetPlot);
+                            addSignalToPlot(handle, targetPlot);
                         }
                     }
                 }
@@ -2238,8 +3112,10 @@ void MainWindow::onLegendClick(QCPLegend *legend, QCPAbstractLegendItem *item, Q
         {
             // 切换可见性
             plottable->setVisible(!plottable->visible());
+            // 隐藏的曲线不参与游标吸附
+            m_cursorManager->refreshTimeIndex();
 
-            plottable->parentPlot()->replot();
+            m_renderScheduler->requestReplot(plottable->parentPlot());
         }
     }
 }
@@ -2258,16 +3134,23 @@ void MainWindow::onLegendContextMenu(const QPoint &pos)
 
     if (graph)
     {
-        QString uniqueID = graph->property("id").toString();
-        if (uniqueID.isEmpty())
+        SignalHandle handle = m_signalRegistry->handleOf(graph);
+        if (handle == InvalidSignalHandle)
             return;
 
         // 创建上下文菜单
         QMenu contextMenu(this);
         QAction *deleteAction = contextMenu.addAction(tr("Delete '%1'").arg(graph->name()));
-        deleteAction->setData(uniqueID);
+        deleteAction->setData(handle);
         connect(deleteAction, &QAction::triggered, this, &MainWindow::onDeleteSignalAction);
 
+        QAction *snapAction = contextMenu.addAction(tr("Snap Cursors to '%1'").arg(graph->name()));
+        connect(snapAction, &QAction::triggered, this, [this, graph]()
+                {
+            m_cursorManager->setSnapGraph(graph);
+            m_cursorManager->setSnapMode(CursorManager::SnapSignal);
+            m_snapSignalAction->setChecked(true); });
+
         // 在全局坐标位置显示菜单
         contextMenu.exec(plot->mapToGlobal(pos));
         return;
@@ -2286,14 +3169,14 @@ void MainWindow::onLegendContextMenu(const QPoint &pos)
         if (!graph)
             return;
 
-        QString uniqueID = graph->property("id").toString();
-        if (uniqueID.isEmpty())
+        SignalHandle handle = m_signalRegistry->handleOf(graph);
+        if (handle == InvalidSignalHandle)
             return;
 
         // 创建上下文菜单
         QMenu contextMenu(this);
         QAction *deleteAction = contextMenu.addAction(tr("Delete '%1'").arg(graph->name()));
-        deleteAction->setData(uniqueID);
+        deleteAction->setData(handle);
 
         connect(deleteAction, &QAction::triggered, this, &MainWindow::onDeleteSignalAction);
 
@@ -2302,7 +3185,7 @@ void MainWindow::onLegendContextMenu(const QPoint &pos)
     else if (qobject_cast<QCPAxisRect *>(el) || qobject_cast<QCPLegend *>(el))
     {
         // 找到此 plot 对应的 plotIndex
-        int plotIndex = m_plotWidgets.indexOf(plot);
+        int plotIndex = plotIndexOf(plot);
         if (plotIndex == -1)
             return;
 
@@ -2318,6 +3201,17 @@ void MainWindow::onLegendContextMenu(const QPoint &pos)
         connect(exportAction, &QAction::triggered, [this, plot]()
                 { this->exportPlot(plot); });
 
+        contextMenu.addSeparator();
+
+        QAction *followYAction = contextMenu.addAction(tr("Follow Y (Auto-Fit While Panning)"));
+        followYAction->setCheckable(true);
+        followYAction->setChecked(plot->property("followY").toBool());
+        connect(followYAction, &QAction::toggled, [this, plot](bool checked)
+                {
+            plot->setProperty("followY", checked);
+            if (checked)
+                m_renderScheduler->requestReplot(plot); });
+
         contextMenu.exec(plot->mapToGlobal(pos));
     }
 }
@@ -2423,7 +3317,8 @@ void MainWindow::configurePlotLegend(QCustomPlot *plot, int mode)
     for (int i = 0; i < plot->graphCount(); ++i)
         plot->graph(i)->addToLegend(plot->legend);
 
-    plot->replot();
+    // 经由调度器重绘，滚出视口 (已暂停) 的子图推迟到重新可见时再绘制
+    m_renderScheduler->requestReplot(plot);
 }
 
 /**
@@ -2441,49 +3336,21 @@ void MainWindow::onLegendPositionChanged(QAction *action)
     }
 }
 
-SignalLocation MainWindow::getSignalDataFromID(const QString &uniqueID) const
+/**
+ * @brief [辅助] 由信号句柄取得数据列、名称和画笔
+ */
+SignalLocation MainWindow::getSignalData(SignalHandle handle) const
 {
     SignalLocation loc;
 
-    QStandardItem *item = m_uniqueIdMap.value(uniqueID, nullptr);
-    if (!item)
-        return loc;
-
-    loc.name = item->text();
-    loc.pen = item->data(PenDataRole).value<QPen>();
-
-    // 2. 解析 ID
-    QStringList parts = uniqueID.split('/');
-    if (parts.size() < 2)
-        return loc;
-
-    QString filename = parts[0];
-    if (!m_fileDataMap.contains(filename))
+    const SignalRegistry::Location data = m_signalRegistry->location(handle);
+    if (!data.table || !m_signalTreeModel->contains(handle))
         return loc;
-    const FileData &fileData = m_fileDataMap.value(filename);
 
-    if (parts.size() == 2) // CSV: "filename/index"
-    {
-        if (!fileData.tables.isEmpty())
-        {
-            loc.table = &fileData.tables.first();
-            loc.signalIndex = parts[1].toInt();
-        }
-    }
-    else if (parts.size() == 3) // MAT: "filename/tablename/index"
-    {
-        QString tablename = parts[1];
-        int idx = parts[2].toInt();
-        for (const auto &table : fileData.tables)
-        {
-            if (table.name == tablename)
-            {
-                loc.table = &table;
-                loc.signalIndex = idx;
-                break;
-            }
-        }
-    }
+    loc.table = data.table;
+    loc.signalIndex = data.column;
+    loc.name = m_signalTreeModel->signalName(handle);
+    loc.pen = m_signalTreeModel->signalPen(handle);
     return loc;
 }
 
@@ -2580,6 +3447,30 @@ void MainWindow::performFitView(bool fitX, bool fitY, FitTarget target)
             }
         }
 
+        // 尚未创建子图的单元格：取信号所在表的时间范围 (加载时已统计)
+        for (int plotIndex = 0; plotIndex < m_plotCells.size(); ++plotIndex)
+        {
+            if (m_plotCells.at(plotIndex).plot)
+                continue;
+            for (SignalHandle handle : m_plotSignalMap.value(plotIndex))
+            {
+                const SignalRegistry::Location loc = m_signalRegistry->location(handle);
+                if (!loc.table || qIsNaN(loc.table->stats.timeMin) || qIsNaN(loc.table->stats.timeMax))
+                    continue;
+
+                const QCPRange r(loc.table->stats.timeMin, loc.table->stats.timeMax);
+                if (!hasXRange)
+                {
+                    globalXRange = r;
+                    hasXRange = true;
+                }
+                else
+                {
+                    globalXRange.expand(r);
+                }
+            }
+        }
+
         if (!hasXRange)
             globalXRange = QCPRange(0, 10);
     }
@@ -2600,72 +3491,81 @@ void MainWindow::performFitView(bool fitX, bool fitY, FitTarget target)
         {
             // 确定 Y 轴计算的参考 X 范围
             QCPRange searchXRange = fitX ? globalXRange : plot->xAxis->range();
+            fitPlotYRange(plot, searchXRange);
+        }
+        m_renderScheduler->requestReplot(plot);
+    }
 
-            QCPRange foundYRange;
-            bool hasY = false;
+    // 如果缩放了 X 轴，手动触发一次游标更新 (因为我们屏蔽了信号)
+    if (fitX)
+    {
+        if (!targets.isEmpty())
+            onXAxisRangeChanged(targets.first()->xAxis->range());
+    }
+}
 
-            for (int i = 0; i < plot->graphCount(); ++i)
-            {
-                QCPGraph *graph = plot->graph(i);
-                if (!graph)
-                    continue;
+/**
+ * @brief [辅助] 按给定 X 范围内的数据适配单个子图的 Y 轴 (含 5% 边距)
+ */
+void MainWindow::fitPlotYRange(QCustomPlot *plot, const QCPRange &searchXRange)
+{
+    QCPRange foundYRange;
+    bool hasY = false;
 
-                bool found = false;
-                // 获取在当前 X 视野内的 Y 范围
-                QCPRange r = graph->getValueRange(found, QCP::sdBoth, searchXRange);
-                if (found)
-                {
-                    if (!hasY)
-                    {
-                        foundYRange = r;
-                        hasY = true;
-                    }
-                    else
-                    {
-                        foundYRange.expand(r);
-                    }
-                }
-            }
+    for (int i = 0; i < plot->graphCount(); ++i)
+    {
+        QCPGraph *graph = plot->graph(i);
+        if (!graph)
+            continue;
 
-            if (hasY)
+        bool found = false;
+        // 获取在当前 X 视野内的 Y 范围 (SignalGraph 走 LOD 索引，O(log n))
+        QCPRange r = graph->getValueRange(found, QCP::sdBoth, searchXRange);
+        if (found)
+        {
+            if (!hasY)
             {
-                // 添加 5% 边距
-                double size = foundYRange.size();
-                if (size == 0.0)
-                    size = 1.0; // 防止单一直线的情况
-                double margin = size * 0.05;
-                // 特殊处理：如果值本身是0且范围也是0 (例如全0信号)
-                if (margin == 0.05 && foundYRange.center() == 0.0)
-                    margin = 0.5;
-
-                foundYRange.lower -= margin;
-                foundYRange.upper += margin;
-                plot->yAxis->setRange(foundYRange);
+                foundYRange = r;
+                hasY = true;
             }
             else
             {
-                plot->yAxis->setRange(0, 1); // 默认范围
+                foundYRange.expand(r);
             }
         }
-
-        plot->replot();
     }
 
-    // 如果缩放了 X 轴，手动触发一次游标更新 (因为我们屏蔽了信号)
-    if (fitX)
+    if (hasY)
     {
-        if (!targets.isEmpty())
-            onXAxisRangeChanged(targets.first()->xAxis->range());
+        // 添加 5% 边距
+        double size = foundYRange.size();
+        if (size == 0.0)
+            size = 1.0; // 防止单一直线的情况
+        double margin = size * 0.05;
+        // 特殊处理：如果值本身是0且范围也是0 (例如全0信号)
+        if (margin == 0.05 && foundYRange.center() == 0.0)
+            margin = 0.5;
+
+        foundYRange.lower -= margin;
+        foundYRange.upper += margin;
+        plot->yAxis->setRange(foundYRange);
+    }
+    else
+    {
+        plot->yAxis->setRange(0, 1); // 默认范围
     }
 }
 
-void MainWindow::setupGraphInstance(QCustomPlot *plot, const QString &uniqueID, const SignalLocation &loc)
+void MainWindow::setupGraphInstance(QCustomPlot *plot, SignalHandle handle, const SignalLocation &loc)
 {
-    QCPGraph *graph = plot->addGraph();
+    // SignalGraph 构造时即注册到 plot (等同 addGraph)
+    SignalGraph *graph = new SignalGraph(plot->xAxis, plot->yAxis);
     graph->setName(loc.name);
-    graph->setData(loc.table->timeData, loc.table->valueData[loc.signalIndex]);
+    // 表在加载时已按时间排序，QCP 容器与快速路径使用同一顺序
+    graph->setData(loc.table->timeData, loc.table->valueData[loc.signalIndex], true);
+    graph->setSignalSource(loc.table->timeData, loc.table->valueData[loc.signalIndex], loc.table->lods.value(loc.signalIndex));
     graph->setPen(loc.pen);
-    graph->setProperty("id", uniqueID);
+    m_signalRegistry->bindGraph(handle, graph);
 
     // 统一应用性能修复和样式设置
     if (graph->selectionDecorator())
@@ -2745,6 +3645,19 @@ void MainWindow::on_actionExportAll_triggered()
         fileName += ".png";
     }
 
+    // 尚未进入过视口的单元格先创建子图；离屏子图的缓冲可能已过期，抓取前补绘
+    QSet<QCustomPlot *> createdPlots;
+    for (int i = 0; i < m_plotCells.size(); ++i)
+    {
+        if (!m_plotCells.at(i).plot)
+            createdPlots.insert(ensureCellPlot(i));
+    }
+    for (QCustomPlot *plot : m_plotWidgets)
+    {
+        if (createdPlots.contains(plot) || m_renderScheduler->isPlotSuspended(plot))
+            plot->replot(QCustomPlot::rpImmediateRefresh);
+    }
+
     QPixmap pixmap = m_plotContainer->grab();
     bool success = pixmap.save(fileName, nullptr, 100);
 
@@ -7,12 +7,23 @@
 #include <QMap>
 #include <QVector>
 #include <QSet>
+#include <QPointer>
 #include <QDomDocument>
 
 // Local Headers
 #include "datamanager.h"
 #include "cursormanager.h"
 #include "replaymanager.h"
+#include "renderscheduler.h"
+#include "plotrasterizer.h"
+#include "interactionquality.h"
+#include "plotgridarea.h"
+#include "cursorreadoutmodel.h"
+#include "rangestatsmodel.h"
+#include "signalregistry.h"
+#include "signaltreemodel.h"
+#include "signalsearch.h"
+#include "sparklinecache.h"
 
 // Forward Declarations
 class QCustomPlot;
@@ -24,24 +35,16 @@ class QCPMarginGroup;
 class QCPItemLine;
 class QCPItemText;
 class QCPItemTracer;
-class QStandardItemModel;
-class QStandardItem;
 class QTreeView;
 class QDockWidget;
 class QProgressDialog;
 class QLineEdit;
+class QComboBox;
+class QLabel;
 class QSpinBox;
 class QThread;
-
-// Custom Roles
-enum TreeItemRoles
-{
-    UniqueIdRole = Qt::UserRole + 1, // "filename/tablename/signalindex"
-    IsFileItemRole,
-    PenDataRole,
-    FileNameRole,
-    IsSignalItemRole
-};
+class QTableView;
+class QFrame;
 
 struct SignalLocation
 {
@@ -62,6 +65,7 @@ public:
 signals:
     void requestLoadCsv(const QString &filePath);
     void requestLoadMat(const QString &filePath);
+    void requestDerivedSignal(const DerivedSignalRequest &request);
 
 protected:
     // Event Overrides
@@ -73,10 +77,12 @@ private slots:
     //  1. 菜单动作槽 (Menu Actions)
     void on_actionLoadFile_triggered();
     void on_actionImportView_triggered();
+    void on_actionNewDerivedSignal_triggered();
     void on_actionToggleLegend_toggled(bool checked);
     void onLegendPositionChanged(QAction *action);
     void on_actionClearAllPlots_triggered();
     void onOpenGLActionToggled(bool checked);
+    void onFrameRendered(const RenderScheduler::FrameStats &stats);
 
     // 布局动作
     void onLayoutActionTriggered();
@@ -94,9 +100,10 @@ private slots:
     void showLoadProgress(int percentage);
 
     //  3. 信号树交互槽 (Signal Tree)
-    void onSignalItemChanged(QStandardItem *item);
+    void onSignalCheckChanged(SignalHandle handle, bool checked);
     void onSignalItemDoubleClicked(const QModelIndex &index);
-    void onSignalSearchChanged(const QString &text);
+    void onSignalSearchResult(const SignalSearchResult &result);
+    void onSignalRowsInserted(const QModelIndex &parent, int first, int last);
     void onSignalTreeContextMenu(const QPoint &pos);
     void onDeleteFileAction(); // 树右键删除文件
 
@@ -104,6 +111,8 @@ private slots:
     void onPlotClicked();
     void onPlotSelectionChanged();
     void onXAxisRangeChanged(const QCPRange &newRange);
+    void onPlotBeforeReplot();
+    void onPlotMouseHover(QMouseEvent *event);
 
     // 图例与图表右键
     void onLegendClick(QCPLegend *legend, QCPAbstractLegendItem *item, QMouseEvent *event);
@@ -113,9 +122,13 @@ private slots:
 
     // 游标与重放
     void onReplayActionToggled(bool checked);
+    void onSnapModeTriggered(QAction *action);
+    void onDuplicateNamePolicyTriggered(QAction *action);
     void updateCursorsForLayoutChange();
 
     void on_actionExportAll_triggered(); // 导出所有视图的槽
+    void onInteractionQualitySettings();
+    void onPlotCellOnScreenChanged(QWidget *cell, bool onScreen);
 
 private:
     //  内部数据结构
@@ -125,6 +138,16 @@ private:
         int cols = 1;
         QString layoutType = "grid";
     };
+    /**
+     * @brief 网格中的一个单元格
+     * * 边框控件随布局创建；子图在单元格首次进入视口时才创建，此前曲线集合只记录在
+     * m_plotSignalMap 中，X 范围取自已创建的子图，游标只保存 key
+     */
+    struct PlotCell
+    {
+        QFrame *frame = nullptr;
+        QCustomPlot *plot = nullptr;
+    };
     struct SignalInfo
     {
         QString name;
@@ -147,9 +170,12 @@ private:
     void setupPlotLayout(int rows, int cols);
     void setupPlotLayout(const QList<QRect> &geometries);
     void setupPlotInteractions(QCustomPlot *plot);
-    void clearPlotLayout();
+    void releasePlotCells(int keepCount);
+    QCustomPlot *ensureCellPlot(int plotIndex);
+    int plotIndexOf(QCustomPlot *plot) const;
+    bool syncPlotGraphs(QCustomPlot *plot, int plotIndex);
 
-    void setupGraphInstance(QCustomPlot *plot, const QString &uniqueID, const SignalLocation &loc);
+    void setupGraphInstance(QCustomPlot *plot, SignalHandle handle, const SignalLocation &loc);
 
     //  核心逻辑辅助函数
     void loadFile(const QString &filePath);
@@ -157,22 +183,59 @@ private:
     void removeFile(const QString &filename);
 
     // 信号管理
-    void addSignalToPlot(const QString &uniqueID, QCustomPlot *plot, bool replot = true);
-    void removeSignalFromPlot(const QString &uniqueID, QCustomPlot *plot);
+    void addSignalToPlot(SignalHandle handle, QCustomPlot *plot, bool replot = true);
+    void addSignalToCell(SignalHandle handle, int plotIndex, bool replot = true);
+    void removeSignalFromPlot(SignalHandle handle, QCustomPlot *plot);
+    void setChildSignalsChecked(const QModelIndex &parent, bool checked);
+
+    /**
+     * @brief 批量修改作用域 (RAII，可嵌套)
+     * * 作用域内的信号添加/删除只修改曲线本身；坐标轴、图例、游标和重绘
+     * 推迟到最外层作用域结束时，对每个受影响的子图统一处理一次
+     */
+    class PlotBatchScope
+    {
+    public:
+        explicit PlotBatchScope(MainWindow *window);
+        ~PlotBatchScope();
+
+    private:
+        Q_DISABLE_COPY(PlotBatchScope)
+        MainWindow *m_window;
+    };
+
+    void beginPlotBatch();
+    void endPlotBatch();
+    void markPlotEdited(QCustomPlot *plot, bool rescale);
+    void refreshEditedPlots(const QHash<QCustomPlot *, bool> &plots);
+
+    void setHoveredGraph(QCPGraph *graph);
+
+    // 游标读数面板
+    void scheduleCursorReadoutUpdate();
+    void updateCursorReadoutEntries();
+    void updateRangeStatsActive();
+
+    // 直方图
+    void showSignalHistogram(SignalHandle handle);
+
+    // 派生信号
+    bool resolveDerivedInputs(const QStringList &names, QVector<SignalRegistry::Location> *inputs,
+                              QString *errorMessage) const;
     void populateSignalTree(const FileData &data);
     void updateSignalTreeChecks();
-    bool filterSignalTree(QStandardItem *item, const QString &query);
+    void applySignalFilter();
+    void updateHiddenSignalRows(const QModelIndex &parent, int first, int last);
+    void setTreeNodeHidden(const QModelIndex &index, const QString &key, bool hidden);
 
     // 绘图管理
     void setActivePlot(QCustomPlot *plot);
-    QCPGraph *getGraph(QCustomPlot *plot, const QString &uniqueID) const;
-    QStandardItem *findItemBySignalName(const QString &name);
+    QCPGraph *getGraph(QCustomPlot *plot, SignalHandle handle) const;
 
     // 数据辅助
     QCPRange getGlobalTimeRange() const;
     double getSmallestTimeStep() const;
     void updateReplayManagerRange();
-    QString getUniqueID(QStandardItem *item) const;
 
     // 导入辅助
     LayoutInfo parseViewMetaData(const QDomDocument &doc);
@@ -181,7 +244,7 @@ private:
     // 针对单个 Plot 配置图例的辅助函数
     void configurePlotLegend(QCustomPlot *plot, int mode);
 
-    SignalLocation getSignalDataFromID(const QString &uniqueID) const;
+    SignalLocation getSignalData(SignalHandle handle) const;
 
     void exportPlot(QCustomPlot *plot); // 导出单个 Plot 的辅助函数
 
@@ -193,6 +256,11 @@ private:
      */
     void performFitView(bool fitX, bool fitY, FitTarget target);
 
+    /**
+     * @brief 按给定 X 范围内的数据适配单个子图的 Y 轴
+     */
+    void fitPlotYRange(QCustomPlot *plot, const QCPRange &searchXRange);
+
     //  成员变量 (分组)
 
     // 1. 核心逻辑组件
@@ -200,13 +268,32 @@ private:
     DataManager *m_dataManager;
     CursorManager *m_cursorManager;
     ReplayManager *m_replayManager;
+    RenderScheduler *m_renderScheduler;
+    PlotRasterizer *m_plotRasterizer;
+    InteractionQuality *m_interactionQuality;
+    SignalRegistry *m_signalRegistry;
 
     // 2. 主 UI 容器
-    QWidget *m_plotContainer;
+    PlotGridArea *m_plotGrid;
+    QWidget *m_plotContainer; // m_plotGrid 的内容控件
     QDockWidget *m_signalDock;
     QTreeView *m_signalTree;
-    QStandardItemModel *m_signalTreeModel;
+    QDockWidget *m_cursorReadoutDock;
+    QTableView *m_cursorReadoutView;
+    CursorReadoutModel *m_cursorReadoutModel;
+    bool m_cursorReadoutUpdatePending;
+    QDockWidget *m_rangeStatsDock;
+    QTableView *m_rangeStatsView;
+    RangeStatsModel *m_rangeStatsModel;
+    SignalTreeModel *m_signalTreeModel;
     QLineEdit *m_signalSearchBox;
+    QComboBox *m_signalSearchModeBox;
+    QLabel *m_signalSearchStatus;
+    SignalSearch *m_signalSearch;
+    SignalSearchResult m_signalFilter;           // 当前应用到视图的搜索结果
+    QHash<QString, QBitArray> m_hiddenSignalRows; // 表前缀 -> 视图中已隐藏的信号行
+    QSet<QString> m_hiddenTreeNodes;              // 视图中已隐藏的文件名 / 表前缀
+    SparklineCache *m_sparklineCache;             // 信号树预览缩略图
     QProgressDialog *m_progressDialog;
     QToolBar *m_viewToolBar;
     QDialog *m_customLayoutDialog; // 懒加载
@@ -214,15 +301,13 @@ private:
     QSpinBox *m_customColsSpinBox;
 
     // 3. 绘图状态管理
-    QList<QCustomPlot *> m_plotWidgets; // 所有 Plot 列表
+    QList<PlotCell> m_plotCells;        // 所有单元格 (按布局索引)
+    QList<QCustomPlot *> m_plotWidgets; // 已创建的 Plot 列表 (按单元格顺序)
     QCustomPlot *m_activePlot;          // 当前选中的 Plot
     QCustomPlot *m_lastMousePlot;       // 最后交互的 Plot (用于游标吸附)
 
-    // 信号映射 (PlotIndex -> Set<SignalID>) - 用于持久化
-    QMap<int, QSet<QString>> m_plotSignalMap;
-
-    //  快速查找表
-    QHash<QString, QStandardItem *> m_uniqueIdMap;
+    // 信号映射 (PlotIndex -> Set<SignalHandle>) - 布局切换时保留
+    QMap<int, QSet<SignalHandle>> m_plotSignalMap;
 
     QCPMarginGroup *m_yAxisGroup; // Y轴对齐
 
@@ -231,9 +316,16 @@ private:
     QVector<QColor> m_colorList;
     int m_colorIndex;
 
+    // 批量修改状态 (见 PlotBatchScope)
+    int m_plotBatchDepth;
+    QHash<QCustomPlot *, bool> m_batchEditedPlots; // 子图 -> 是否需要 rescaleAxes
+
+    QPointer<QCPGraph> m_hoveredGraph; // 当前悬停高亮的曲线
+
     // 5. 动作 (Actions)
     QAction *m_loadFileAction;
     QAction *m_importViewAction;
+    QAction *m_newDerivedSignalAction;
     //  图例位置动作组
     QActionGroup *m_legendPosGroup;
     QAction *m_legendPosOutsideTopAction;
@@ -256,12 +348,23 @@ private:
     QAction *m_fitViewYAllAction;
     QAction *m_toggleLegendAction;
     QAction *m_openGLAction;
+    QAction *m_renderStatsAction;
+    QAction *m_offscreenRenderAction;
+    QAction *m_interactionQualityAction;
     QAction *m_clearAllPlotsAction;
     // 游标
     QAction *m_cursorNoneAction;
     QAction *m_cursorSingleAction;
     QAction *m_cursorDoubleAction;
     QActionGroup *m_cursorGroup;
+    // 游标吸附
+    QAction *m_snapAllAction;
+    QAction *m_snapActivePlotAction;
+    QAction *m_snapSignalAction;
+    QAction *m_snapNoneAction;
+    QActionGroup *m_snapGroup;
+    // 导入视图时同名信号的解析策略
+    QActionGroup *m_duplicateNameGroup;
     QAction *m_replayAction;
 
     QAction *m_exportAllAction;
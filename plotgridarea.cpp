@@ -0,0 +1,144 @@
+#include "plotgridarea.h"
+
+#include <QGridLayout>
+#include <QTimer>
+
+PlotGridArea::PlotGridArea(QWidget *parent)
+    : QScrollArea(parent),
+      m_container(nullptr),
+      m_grid(nullptr),
+      m_minimumCellSize(240, 160),
+      m_rows(1),
+      m_cols(1),
+      m_updatePending(false)
+{
+    setFrameShape(QFrame::NoFrame);
+    setWidgetResizable(true);
+
+    m_container = new QWidget(this);
+    m_grid = new QGridLayout(m_container);
+    m_grid->setSpacing(0);
+    m_grid->setContentsMargins(0, 0, 0, 0);
+    setWidget(m_container);
+}
+
+PlotGridArea::~PlotGridArea()
+{
+}
+
+QWidget *PlotGridArea::container() const
+{
+    return m_container;
+}
+
+QGridLayout *PlotGridArea::gridLayout() const
+{
+    return m_grid;
+}
+
+void PlotGridArea::setMinimumCellSize(const QSize &size)
+{
+    m_minimumCellSize = size;
+    applyMinimumSize();
+}
+
+QSize PlotGridArea::minimumCellSize() const
+{
+    return m_minimumCellSize;
+}
+
+void PlotGridArea::setGridSize(int rows, int cols)
+{
+    m_rows = qMax(1, rows);
+    m_cols = qMax(1, cols);
+    applyMinimumSize();
+}
+
+void PlotGridArea::setCells(const QList<QWidget *> &cells)
+{
+    for (QWidget *cell : cells)
+    {
+        if (!m_cells.contains(cell))
+            connect(cell, &QObject::destroyed, this, &PlotGridArea::onCellDestroyed, Qt::UniqueConnection);
+    }
+
+    m_cells = cells;
+    m_onScreen.clear();
+    m_unreported = QSet<QWidget *>(cells.begin(), cells.end());
+    scheduleUpdate();
+}
+
+bool PlotGridArea::isOnScreen(QWidget *cell) const
+{
+    return m_onScreen.contains(cell);
+}
+
+void PlotGridArea::resizeEvent(QResizeEvent *event)
+{
+    QScrollArea::resizeEvent(event);
+    scheduleUpdate();
+}
+
+void PlotGridArea::scrollContentsBy(int dx, int dy)
+{
+    QScrollArea::scrollContentsBy(dx, dy);
+    scheduleUpdate();
+}
+
+/**
+ * @brief [辅助] 合并同一轮事件中的多次滚动/缩放，只计算一次可见性
+ */
+void PlotGridArea::scheduleUpdate()
+{
+    if (m_updatePending)
+        return;
+    m_updatePending = true;
+    QTimer::singleShot(0, this, &PlotGridArea::updateOnScreenCells);
+}
+
+/**
+ * @brief [辅助] 网格的最小尺寸 = 行列数 * 单元格最小尺寸
+ */
+void PlotGridArea::applyMinimumSize()
+{
+    m_container->setMinimumSize(m_cols * m_minimumCellSize.width(), m_rows * m_minimumCellSize.height());
+    scheduleUpdate();
+}
+
+/**
+ * @brief [槽] 计算各单元格与视口是否相交，并通知变化
+ * * 接收方可能在通知中创建子图，因此遍历列表的副本
+ */
+void PlotGridArea::updateOnScreenCells()
+{
+    m_updatePending = false;
+
+    const QRect viewportRect = viewport()->rect();
+    const QList<QWidget *> cells = m_cells;
+    for (QWidget *cell : cells)
+    {
+        if (!m_cells.contains(cell))
+            continue;
+
+        const QRect cellRect(cell->mapTo(viewport(), QPoint(0, 0)), cell->size());
+        const bool onScreen = cell->isVisible() && cellRect.intersects(viewportRect);
+        const bool unreported = m_unreported.remove(cell);
+        if (!unreported && onScreen == m_onScreen.contains(cell))
+            continue;
+
+        if (onScreen)
+            m_onScreen.insert(cell);
+        else
+            m_onScreen.remove(cell);
+        emit cellOnScreenChanged(cell, onScreen);
+    }
+}
+
+void PlotGridArea::onCellDestroyed(QObject *object)
+{
+    // 此时对象已析构，只能按指针值移除
+    QWidget *cell = static_cast<QWidget *>(object);
+    m_cells.removeAll(cell);
+    m_onScreen.remove(cell);
+    m_unreported.remove(cell);
+}
@@ -0,0 +1,78 @@
+#ifndef PLOTGRIDAREA_H
+#define PLOTGRIDAREA_H
+
+#include <QScrollArea>
+#include <QList>
+#include <QSet>
+
+// 向前声明
+class QGridLayout;
+
+/**
+ * @brief 可滚动的子图网格容器
+ * * 子图网格放在滚动区域中，每个单元格有最小尺寸；布局较小时网格铺满窗口，
+ * 行列很多 (例如 10x10) 时改为滚动浏览。
+ * 容器跟踪每个单元格是否与视口相交，并在变化时发出 cellOnScreenChanged，
+ * 由调用方在单元格首次进入视口时才创建子图，并暂停离屏子图的重绘和 OpenGL 上下文。
+ */
+class PlotGridArea : public QScrollArea
+{
+    Q_OBJECT
+
+public:
+    explicit PlotGridArea(QWidget *parent = nullptr);
+    ~PlotGridArea();
+
+    /**
+     * @brief 网格所在的内容控件 (布局为 QGridLayout)
+     */
+    QWidget *container() const;
+    QGridLayout *gridLayout() const;
+
+    /**
+     * @brief 单元格最小尺寸，网格总尺寸小于视口时不出现滚动条
+     */
+    void setMinimumCellSize(const QSize &size);
+    QSize minimumCellSize() const;
+
+    void setGridSize(int rows, int cols);
+
+    /**
+     * @brief 设置需要跟踪可见性的单元格控件
+     * * 新单元格在下一轮事件循环中计算一次可见性，并无论结果如何都发出一次 cellOnScreenChanged
+     */
+    void setCells(const QList<QWidget *> &cells);
+
+    bool isOnScreen(QWidget *cell) const;
+
+signals:
+    /**
+     * @brief [信号] 单元格滚入或滚出视口
+     */
+    void cellOnScreenChanged(QWidget *cell, bool onScreen);
+
+protected:
+    void resizeEvent(QResizeEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private slots:
+    void updateOnScreenCells();
+    void onCellDestroyed(QObject *object);
+
+private:
+    void scheduleUpdate();
+    void applyMinimumSize();
+
+    QWidget *m_container;
+    QGridLayout *m_grid;
+    QSize m_minimumCellSize;
+    int m_rows;
+    int m_cols;
+    bool m_updatePending;
+
+    QList<QWidget *> m_cells;
+    QSet<QWidget *> m_onScreen;
+    QSet<QWidget *> m_unreported; // 尚未发出过初始状态的单元格
+};
+
+#endif // PLOTGRIDAREA_H
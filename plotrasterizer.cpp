@@ -0,0 +1,703 @@
+#include "plotrasterizer.h"
+#include "renderscheduler.h"
+#include "signalgraph.h"
+#include "denseraster.h"
+
+#include <QThreadPool>
+#include <QThread>
+#include <QRunnable>
+#include <QPainter>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <climits>
+
+// 每像素样本数低于该值时直接绘制原始折线
+static const double kDenseThreshold = 2.0;
+// 精细阶段每列最多约用多少个金字塔桶，其余两端不完整部分用原始数据补齐
+static const double kExactEdgeBuckets = 8.0;
+// 瓦片宽度 (视口宽度的倍数)，两侧各留一个视口的余量用于平移
+static const int kTileWidthFactor = 3;
+// 视口距瓦片边缘小于该比例 (相对视口宽度) 时重新渲染
+static const double kTileEdgeMargin = 0.25;
+
+/**
+ * @brief 合成图层：在 "main" 图层最底部绘制后台光栅化得到的图像
+ */
+class PlotRasterLayerable : public QCPLayerable
+{
+public:
+    explicit PlotRasterLayerable(QCustomPlot *plot)
+        : QCPLayerable(plot, QLatin1String("main"))
+    {
+        // 放在 main 图层最前，保证实时绘制的 (选中) 曲线位于图像之上
+        moveToLayer(layer(), true);
+    }
+
+    void setImage(const QImage &image, const QCPRange &keyRange, const QCPRange &valueRange)
+    {
+        m_image = image;
+        m_keyRange = keyRange;
+        m_valueRange = valueRange;
+    }
+
+    void clearImage()
+    {
+        m_image = QImage();
+    }
+
+protected:
+    void applyDefaultAntialiasingHint(QCPPainter *painter) const override
+    {
+        applyAntialiasingHint(painter, mAntialiased, QCP::aeNone);
+    }
+
+    QRect clipRect() const override
+    {
+        if (mParentPlot && mParentPlot->axisRect())
+            return mParentPlot->axisRect()->rect();
+        return QCPLayerable::clipRect();
+    }
+
+    void draw(QCPPainter *painter) override
+    {
+        // 导出时曲线自行精确绘制，这里不再叠加屏幕分辨率的图像
+        if (m_image.isNull() || painter->modes().testFlag(QCPPainter::pmNoCaching))
+            return;
+
+        // 图像可能来自旧的视图：按它的坐标范围映射到当前像素位置，
+        // 这样在新任务完成之前，平移/缩放也能立即得到反馈
+        QCPAxis *xAxis = mParentPlot->xAxis;
+        QCPAxis *yAxis = mParentPlot->yAxis;
+        const double left = xAxis->coordToPixel(m_keyRange.lower);
+        const double right = xAxis->coordToPixel(m_keyRange.upper);
+        const double top = yAxis->coordToPixel(m_valueRange.upper);
+        const double bottom = yAxis->coordToPixel(m_valueRange.lower);
+        painter->drawImage(QRectF(left, top, right - left, bottom - top), m_image);
+    }
+
+private:
+    QImage m_image;
+    QCPRange m_keyRange;
+    QCPRange m_valueRange;
+};
+
+/**
+ * @brief 传给工作线程的单条曲线快照 (全部为隐式共享的只读数据)
+ */
+struct RasterSignal
+{
+    QVector<double> keys;
+    QVector<double> values;
+    SignalLod lod;
+    QPen pen;
+    bool antialiased = false;
+};
+
+/**
+ * @brief 传给工作线程的子图快照
+ */
+struct RasterRequest
+{
+    QCustomPlot *plot = nullptr;
+    int generation = 0;
+    QCPRange keyRange;
+    QCPRange valueRange;
+    QSize size;
+    qreal pixelRatio = 1.0;
+    double coarseBucketPixels = 4.0; // 粗略阶段允许的桶宽 (像素)，越大越快但越粗糙
+    QVector<RasterSignal> items;
+};
+
+/**
+ * @brief [辅助类] 按像素列聚合 min/max 并生成折线
+ * * 每列输出最大值和最小值两个点，相邻列之间自然连接
+ */
+class ColumnPolyline
+{
+public:
+    ColumnPolyline(QPainter &painter, double height, double valueLower, double yScale)
+        : m_painter(painter),
+          m_height(height),
+          m_valueLower(valueLower),
+          m_yScale(yScale),
+          m_column(INT_MIN),
+          m_lo(0),
+          m_hi(0)
+    {
+    }
+
+    void add(int column, double lo, double hi)
+    {
+        if (column != m_column)
+        {
+            emitColumn();
+            m_column = column;
+            m_lo = lo;
+            m_hi = hi;
+        }
+        else
+        {
+            m_lo = qMin(m_lo, lo);
+            m_hi = qMax(m_hi, hi);
+        }
+    }
+
+    void gap()
+    {
+        emitColumn();
+        flushLine();
+    }
+
+    void finish()
+    {
+        emitColumn();
+        flushLine();
+    }
+
+private:
+    double toY(double value) const
+    {
+        return m_height - (value - m_valueLower) * m_yScale;
+    }
+
+    void emitColumn()
+    {
+        if (m_column == INT_MIN)
+            return;
+        const double x = m_column + 0.5;
+        m_line.append(QPointF(x, toY(m_hi)));
+        if (m_hi != m_lo)
+            m_line.append(QPointF(x, toY(m_lo)));
+        m_column = INT_MIN;
+    }
+
+    void flushLine()
+    {
+        if (m_line.size() == 1)
+            m_painter.drawPoint(m_line.first());
+        else if (m_line.size() > 1)
+            m_painter.drawPolyline(m_line.constData(), m_line.size());
+        m_line.clear();
+    }
+
+    QPainter &m_painter;
+    double m_height;
+    double m_valueLower;
+    double m_yScale;
+    int m_column;
+    double m_lo;
+    double m_hi;
+    QVector<QPointF> m_line;
+};
+
+/**
+ * @brief [辅助函数] 计算可见样本的索引范围 (两端各多取一个样本，用于连接到视图外的线段)
+ * @return 没有可见样本或视图范围无效时返回 false
+ */
+static bool visibleRange(const RasterSignal &sig, const RasterRequest &request, int *begin, int *end)
+{
+    const int n = qMin(sig.keys.size(), sig.values.size());
+    if (n == 0 || request.keyRange.size() <= 0 || request.valueRange.size() <= 0)
+        return false;
+
+    const double *keyData = sig.keys.constData();
+    *begin = int(std::lower_bound(keyData, keyData + n, request.keyRange.lower) - keyData);
+    *end = int(std::upper_bound(keyData, keyData + n, request.keyRange.upper) - keyData);
+    *begin = qMax(0, *begin - 1);
+    *end = qMin(n, *end + 1);
+    return *end > *begin;
+}
+
+/**
+ * @brief [辅助函数] 判断曲线是否走 DenseRaster 快速路径 (密集数据且为纯色实线)
+ */
+static bool useDenseRaster(const RasterSignal &sig, const RasterRequest &request)
+{
+    if (sig.pen.style() != Qt::SolidLine || sig.pen.brush().style() != Qt::SolidPattern)
+        return false;
+
+    int begin = 0;
+    int end = 0;
+    if (!visibleRange(sig, request, &begin, &end))
+        return false;
+    return (end - begin) / qMax(1.0, double(request.size.width())) >= kDenseThreshold;
+}
+
+/**
+ * @brief [辅助函数] 将密集曲线按像素列直接写入图像 (在工作线程中调用)
+ * @param refined false 时使用比像素更粗的 LOD 级别 (整桶近似)，true 时结果与逐样本聚合一致
+ */
+static void rasterizeDense(QImage &image, const RasterSignal &sig, const RasterRequest &request, bool refined)
+{
+    int begin = 0;
+    int end = 0;
+    if (!visibleRange(sig, request, &begin, &end))
+        return;
+
+    // 在设备像素上聚合，高分屏下同样逐像素精确
+    const int width = image.width();
+    const double samplesPerPixel = (end - begin) / qMax(1.0, double(width));
+    const int level = refined ? sig.lod.levelForDensity(samplesPerPixel / kExactEdgeBuckets)
+                              : sig.lod.levelForDensity(samplesPerPixel * request.coarseBucketPixels);
+
+    const DenseRaster::Columns columns =
+        DenseRaster::reduce(sig.keys.constData(), sig.values.constData(), sig.lod, begin, end,
+                            request.keyRange.lower, request.keyRange.size() / width, width, level, refined);
+
+    const double penWidth = qMax(1.0, sig.pen.widthF()) * request.pixelRatio;
+    DenseRaster::fillSpans(image, columns, request.valueRange.lower, image.height() / request.valueRange.size(),
+                           sig.pen.color(), penWidth, refined && sig.antialiased);
+}
+
+/**
+ * @brief [辅助函数] 将一条曲线光栅化到 painter 上 (在工作线程中调用)
+ * @param refined false 时使用比像素更粗的 LOD 级别，true 时使用像素精度
+ */
+static void rasterizeSignal(QPainter &painter, const RasterSignal &sig, const RasterRequest &request, bool refined)
+{
+    // 1. 可见索引范围
+    int begin = 0;
+    int end = 0;
+    if (!visibleRange(sig, request, &begin, &end))
+        return;
+
+    const double width = request.size.width();
+    const double height = request.size.height();
+    const double keyLower = request.keyRange.lower;
+    const double valueLower = request.valueRange.lower;
+    const double xScale = width / request.keyRange.size();
+    const double yScale = height / request.valueRange.size();
+
+    painter.setPen(sig.pen);
+    painter.setRenderHint(QPainter::Antialiasing, refined && sig.antialiased);
+
+    const double *keyData = sig.keys.constData();
+    const double *valueData = sig.values.constData();
+    const double samplesPerPixel = (end - begin) / qMax(1.0, width);
+
+    // 2. 稀疏数据：直接绘制原始折线
+    if (samplesPerPixel < kDenseThreshold)
+    {
+        QVector<QPointF> line;
+        line.reserve(end - begin);
+        for (int i = begin; i < end; ++i)
+        {
+            const double v = valueData[i];
+            if (qIsNaN(v))
+            {
+                if (line.size() > 1)
+                    painter.drawPolyline(line.constData(), line.size());
+                line.clear();
+                continue;
+            }
+            line.append(QPointF((keyData[i] - keyLower) * xScale, height - (v - valueLower) * yScale));
+        }
+        if (line.size() > 1)
+            painter.drawPolyline(line.constData(), line.size());
+        return;
+    }
+
+    // 3. 密集数据：按像素列聚合 min/max
+    auto columnOf = [keyLower, xScale](double key) -> int
+    {
+        const double x = (key - keyLower) * xScale;
+        return int(std::floor(qBound(-1.0e6, x, 1.0e6)));
+    };
+
+    ColumnPolyline polyline(painter, height, valueLower, yScale);
+    const double density = refined ? samplesPerPixel : samplesPerPixel * request.coarseBucketPixels;
+    const int level = sig.lod.levelForDensity(density);
+
+    if (level < 0)
+    {
+        for (int i = begin; i < end; ++i)
+        {
+            const double v = valueData[i];
+            if (qIsNaN(v))
+            {
+                polyline.gap();
+                continue;
+            }
+            polyline.add(columnOf(keyData[i]), v, v);
+        }
+    }
+    else
+    {
+        const int bucketSize = sig.lod.bucketSize(level);
+        const double *mins = sig.lod.minData(level);
+        const double *maxs = sig.lod.maxData(level);
+        const int firstBucket = begin / bucketSize;
+        const int lastBucket = qMin(sig.lod.bucketCount(level), (end - 1) / bucketSize + 1);
+        for (int b = firstBucket; b < lastBucket; ++b)
+        {
+            if (qIsNaN(mins[b]))
+            {
+                polyline.gap();
+                continue;
+            }
+            polyline.add(columnOf(keyData[b * bucketSize]), mins[b], maxs[b]);
+        }
+    }
+    polyline.finish();
+}
+
+/**
+ * @brief 光栅化任务 (在线程池中运行)
+ */
+class RasterJob : public QRunnable
+{
+public:
+    RasterJob(PlotRasterizer *owner, const RasterRequest &request, bool refined,
+              const QSharedPointer<QAtomicInt> &latestGeneration)
+        : m_owner(owner),
+          m_request(request),
+          m_refined(refined),
+          m_latestGeneration(latestGeneration)
+    {
+    }
+
+    void run() override
+    {
+        if (isStale())
+            return;
+
+        const QSize pixelSize(qCeil(m_request.size.width() * m_request.pixelRatio),
+                              qCeil(m_request.size.height() * m_request.pixelRatio));
+        if (pixelSize.isEmpty())
+            return;
+
+        QImage image(pixelSize, QImage::Format_ARGB32_Premultiplied);
+        image.setDevicePixelRatio(m_request.pixelRatio);
+        image.fill(Qt::transparent);
+
+        {
+            // 密集实线直接写扫描线，其余曲线走 QPainter；按顺序切换以保持叠放次序
+            QPainter painter;
+            for (const RasterSignal &sig : m_request.items)
+            {
+                // 视图已变化，放弃过期任务
+                if (isStale())
+                    return;
+
+                if (useDenseRaster(sig, m_request))
+                {
+                    if (painter.isActive())
+                        painter.end();
+                    rasterizeDense(image, sig, m_request, m_refined);
+                }
+                else
+                {
+                    if (!painter.isActive())
+                        painter.begin(&image);
+                    rasterizeSignal(painter, sig, m_request, m_refined);
+                }
+            }
+        }
+
+        RasterResult result;
+        result.plot = m_request.plot;
+        result.generation = m_request.generation;
+        result.refined = m_refined;
+        result.image = image;
+        result.keyRange = m_request.keyRange;
+        result.valueRange = m_request.valueRange;
+        emit m_owner->rasterReady(result);
+    }
+
+private:
+    bool isStale() const
+    {
+        return m_latestGeneration->loadAcquire() != m_request.generation;
+    }
+
+    PlotRasterizer *m_owner;
+    RasterRequest m_request;
+    bool m_refined;
+    QSharedPointer<QAtomicInt> m_latestGeneration;
+};
+
+bool PlotRasterizer::ViewKey::operator==(const ViewKey &other) const
+{
+    return keyRange == other.keyRange &&
+           valueRange == other.valueRange &&
+           size == other.size &&
+           pixelRatio == other.pixelRatio &&
+           contentHash == other.contentHash;
+}
+
+bool PlotRasterizer::ViewKey::isPanOf(const ViewKey &other) const
+{
+    // 平移会引入浮点误差，跨度按相对误差比较
+    const double span = keyRange.size();
+    const double otherSpan = other.keyRange.size();
+    return qAbs(span - otherSpan) <= qAbs(otherSpan) * 1e-9 &&
+           valueRange == other.valueRange &&
+           size == other.size &&
+           pixelRatio == other.pixelRatio &&
+           contentHash == other.contentHash;
+}
+
+PlotRasterizer::PlotRasterizer(RenderScheduler *scheduler, QObject *parent)
+    : QObject(parent),
+      m_scheduler(scheduler),
+      m_pool(nullptr),
+      m_enabled(false),
+      m_draft(false),
+      m_draftLodFactor(4.0)
+{
+    qRegisterMetaType<RasterResult>("RasterResult");
+
+    m_pool = new QThreadPool(this);
+    m_pool->setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+
+    // 工作线程发出的结果以排队方式回到 GUI 线程
+    connect(this, &PlotRasterizer::rasterReady, this, &PlotRasterizer::onRasterReady, Qt::QueuedConnection);
+}
+
+PlotRasterizer::~PlotRasterizer()
+{
+    for (auto it = m_states.begin(); it != m_states.end(); ++it)
+        it.value().latestGeneration->storeRelease(-1);
+    m_pool->clear();
+    m_pool->waitForDone();
+}
+
+bool PlotRasterizer::isEnabled() const
+{
+    return m_enabled;
+}
+
+void PlotRasterizer::attachPlot(QCustomPlot *plot)
+{
+    if (!plot || m_states.contains(plot))
+        return;
+
+    PlotState state;
+    state.layerable = new PlotRasterLayerable(plot);
+    state.layerable->setVisible(m_enabled);
+    state.latestGeneration = QSharedPointer<QAtomicInt>(new QAtomicInt(0));
+    m_states.insert(plot, state);
+
+    // afterLayout 在坐标轴矩形更新之后、绘制之前发出
+    connect(plot, &QCustomPlot::afterLayout, this, &PlotRasterizer::onPlotLayoutUpdated);
+    connect(plot, &QObject::destroyed, this, &PlotRasterizer::onPlotDestroyed);
+}
+
+/**
+ * @brief [槽] 启用/禁用离屏渲染
+ */
+void PlotRasterizer::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled)
+        return;
+    m_enabled = enabled;
+
+    for (auto it = m_states.begin(); it != m_states.end(); ++it)
+    {
+        QCustomPlot *plot = it.key();
+        resetPlot(plot, it.value());
+        it.value().layerable->setVisible(enabled);
+
+        if (!enabled)
+        {
+            for (int i = 0; i < plot->graphCount(); ++i)
+            {
+                if (SignalGraph *graph = qobject_cast<SignalGraph *>(plot->graph(i)))
+                    graph->setRasterized(false);
+            }
+        }
+        m_scheduler->requestReplot(plot);
+    }
+}
+
+void PlotRasterizer::setDraftMode(bool draft, double lodFactor)
+{
+    m_draftLodFactor = qMax(1.0, lodFactor);
+    if (m_draft == draft)
+        return;
+    m_draft = draft;
+
+    if (draft || !m_enabled)
+        return;
+
+    for (auto it = m_states.begin(); it != m_states.end(); ++it)
+    {
+        if (it.value().refinePending && it.value().hasViewKey)
+            submit(it.key(), it.value(), true);
+    }
+}
+
+/**
+ * @brief [槽] 子图布局完成 (即将绘制) 时检查视图是否变化
+ */
+void PlotRasterizer::onPlotLayoutUpdated()
+{
+    if (!m_enabled)
+        return;
+
+    QCustomPlot *plot = qobject_cast<QCustomPlot *>(sender());
+    auto it = m_states.find(plot);
+    if (it == m_states.end())
+        return;
+
+    // 新加入的曲线同样交给后台合成
+    for (int i = 0; i < plot->graphCount(); ++i)
+    {
+        if (SignalGraph *graph = qobject_cast<SignalGraph *>(plot->graph(i)))
+            graph->setRasterized(true);
+    }
+
+    PlotState &state = it.value();
+    ViewKey key = currentViewKey(plot);
+    if (state.hasViewKey && (state.viewKey == key || tileCovers(state, key)))
+        return; // 纯平移且仍在瓦片内：合成图层按坐标平移已有图像即可
+
+    state.viewKey = key;
+    state.hasViewKey = true;
+    submit(plot, state);
+}
+
+void PlotRasterizer::onPlotDestroyed(QObject *object)
+{
+    // 此时对象已析构，只能按指针值移除
+    QCustomPlot *plot = static_cast<QCustomPlot *>(object);
+    auto it = m_states.find(plot);
+    if (it == m_states.end())
+        return;
+
+    it.value().latestGeneration->storeRelease(-1);
+    m_states.erase(it);
+}
+
+/**
+ * @brief [槽] 接收工作线程的结果，只接受比当前显示更新的结果
+ */
+void PlotRasterizer::onRasterReady(const RasterResult &result)
+{
+    if (!m_enabled)
+        return;
+
+    auto it = m_states.find(result.plot);
+    if (it == m_states.end())
+        return;
+
+    PlotState &state = it.value();
+    if (result.generation < state.shownGeneration)
+        return;
+    if (result.generation == state.shownGeneration && (state.shownRefined || !result.refined))
+        return;
+
+    state.shownGeneration = result.generation;
+    state.shownRefined = result.refined;
+    state.layerable->setImage(result.image, result.keyRange, result.valueRange);
+    m_scheduler->requestReplot(result.plot);
+}
+
+PlotRasterizer::ViewKey PlotRasterizer::currentViewKey(QCustomPlot *plot) const
+{
+    ViewKey key;
+    key.keyRange = plot->xAxis->range();
+    key.valueRange = plot->yAxis->range();
+    key.size = plot->axisRect()->rect().size();
+    key.pixelRatio = plot->bufferDevicePixelRatio();
+
+    // FNV-1a: 曲线集合、可见性和画笔的变化都需要重新光栅化
+    quint64 hash = 1469598103934665603ULL;
+    auto mix = [&hash](quint64 value) -> void
+    {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    };
+    for (int i = 0; i < plot->graphCount(); ++i)
+    {
+        QCPGraph *graph = plot->graph(i);
+        mix(quint64(quintptr(graph)));
+        mix(graph->visible() ? 1 : 0);
+        mix(graph->antialiased() ? 1 : 0);
+        mix(graph->pen().color().rgba());
+        mix(quint64(graph->pen().widthF() * 1000.0));
+        mix(quint64(graph->pen().style()));
+    }
+    key.contentHash = hash;
+    return key;
+}
+
+/**
+ * @brief [辅助] 判断已提交的瓦片能否覆盖新视图
+ */
+bool PlotRasterizer::tileCovers(const PlotState &state, const ViewKey &key) const
+{
+    if (!key.isPanOf(state.viewKey))
+        return false;
+
+    const double margin = key.keyRange.size() * kTileEdgeMargin;
+    return key.keyRange.lower - state.tileKeyRange.lower >= margin &&
+           state.tileKeyRange.upper - key.keyRange.upper >= margin;
+}
+
+/**
+ * @brief [辅助] 拍下子图快照并提交粗略 + 精细两个任务
+ * * X 方向按瓦片宽度 (视口的 kTileWidthFactor 倍，视口居中) 渲染；
+ * 草稿模式下只提交粗略任务，精细任务推迟到交互结束
+ * @param refineOnly 为当前代补交精细任务 (不递增代号)
+ */
+void PlotRasterizer::submit(QCustomPlot *plot, PlotState &state, bool refineOnly)
+{
+    RasterRequest request;
+    request.plot = plot;
+    const double span = state.viewKey.keyRange.size();
+    const double extra = span * (kTileWidthFactor - 1) / 2.0;
+    state.tileKeyRange = QCPRange(state.viewKey.keyRange.lower - extra, state.viewKey.keyRange.upper + extra);
+
+    request.keyRange = state.tileKeyRange;
+    request.valueRange = state.viewKey.valueRange;
+    request.size = QSize(state.viewKey.size.width() * kTileWidthFactor, state.viewKey.size.height());
+    request.pixelRatio = state.viewKey.pixelRatio;
+    request.coarseBucketPixels = m_draftLodFactor;
+
+    for (int i = 0; i < plot->graphCount(); ++i)
+    {
+        SignalGraph *graph = qobject_cast<SignalGraph *>(plot->graph(i));
+        if (!graph || !graph->visible() || graph->sourceKeys().isEmpty())
+            continue;
+
+        RasterSignal sig;
+        sig.keys = graph->sourceKeys();
+        sig.values = graph->sourceValues();
+        sig.lod = graph->sourceLod();
+        sig.pen = graph->pen();
+        sig.antialiased = graph->antialiased();
+        request.items.append(sig);
+    }
+
+    if (!refineOnly)
+    {
+        state.generation++;
+        state.latestGeneration->storeRelease(state.generation);
+    }
+    request.generation = state.generation;
+
+    // 粗略任务优先级更高，先得到可用的画面
+    if (!refineOnly)
+        m_pool->start(new RasterJob(this, request, false, state.latestGeneration), 1);
+
+    state.refinePending = m_draft;
+    if (!m_draft)
+        m_pool->start(new RasterJob(this, request, true, state.latestGeneration), 0);
+}
+
+/**
+ * @brief [辅助] 放弃所有进行中的任务并清除已显示的图像
+ */
+void PlotRasterizer::resetPlot(QCustomPlot *plot, PlotState &state)
+{
+    Q_UNUSED(plot);
+    state.generation++;
+    state.latestGeneration->storeRelease(state.generation);
+    state.shownGeneration = state.generation;
+    state.shownRefined = true;
+    state.refinePending = false;
+    state.hasViewKey = false;
+    state.layerable->clearImage();
+}
@@ -0,0 +1,122 @@
+#ifndef PLOTRASTERIZER_H
+#define PLOTRASTERIZER_H
+
+#include <QObject>
+#include <QHash>
+#include <QImage>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include "qcustomplot.h"
+
+// 向前声明
+class QThreadPool;
+class RenderScheduler;
+class PlotRasterLayerable;
+
+/**
+ * @brief 一次后台光栅化任务的结果
+ */
+struct RasterResult
+{
+    QCustomPlot *plot = nullptr; // 仅用作查找键，工作线程中不解引用
+    int generation = 0;
+    bool refined = false; // false: 粗略 LOD；true: 精细结果
+    QImage image;
+    QCPRange keyRange;
+    QCPRange valueRange;
+};
+Q_DECLARE_METATYPE(RasterResult)
+
+/**
+ * @brief 子图离屏渲染器
+ * * 启用后，每个子图的数据曲线在线程池中被光栅化为 QImage：先提交粗略 LOD 任务，
+ * 再提交精细任务。GUI 线程只负责把图像与坐标轴、游标等交互元素合成，
+ * 因此无论数据多密集，输入都保持流畅。
+ * 视图变化 (坐标范围、尺寸、曲线集合或画笔) 在子图布局完成后被检测，并自动提交新任务，
+ * 过期任务会在工作线程中尽早放弃。
+ * 光栅化范围在 X 方向是视口的 3 倍 (瓦片缓存)：纯平移时直接平移已有图像，
+ * 只有视口接近缓存边缘、缩放或 Y 范围变化时才重新渲染。
+ */
+class PlotRasterizer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PlotRasterizer(RenderScheduler *scheduler, QObject *parent = nullptr);
+    ~PlotRasterizer();
+
+    bool isEnabled() const;
+
+    /**
+     * @brief 将子图纳入管理 (创建合成图层并监听布局更新)
+     */
+    void attachPlot(QCustomPlot *plot);
+
+public slots:
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief [槽] 交互期间的草稿模式
+     * * 开启时只提交粗略 LOD 任务；关闭时为仍停留在粗略结果的子图补交精细任务
+     * @param lodFactor 粗略任务的 LOD 桶宽 (像素)，与曲线草稿模式使用同一设置
+     */
+    void setDraftMode(bool draft, double lodFactor = 4.0);
+
+signals:
+    /**
+     * @brief [信号] 工作线程完成一次光栅化 (以排队连接送回 GUI 线程)
+     */
+    void rasterReady(const RasterResult &result);
+
+private slots:
+    void onPlotLayoutUpdated();
+    void onPlotDestroyed(QObject *object);
+    void onRasterReady(const RasterResult &result);
+
+private:
+    /**
+     * @brief 判断视图是否变化的键
+     */
+    struct ViewKey
+    {
+        QCPRange keyRange;
+        QCPRange valueRange;
+        QSize size;
+        qreal pixelRatio = 1.0;
+        quint64 contentHash = 0;
+
+        bool operator==(const ViewKey &other) const;
+
+        /**
+         * @brief 判断视图是否仅在 X 方向平移 (缩放、Y 范围、尺寸和内容均未变化)
+         */
+        bool isPanOf(const ViewKey &other) const;
+    };
+
+    struct PlotState
+    {
+        PlotRasterLayerable *layerable = nullptr; // 属于 plot，随 plot 一起销毁
+        QSharedPointer<QAtomicInt> latestGeneration;
+        int generation = 0;
+        int shownGeneration = -1;
+        bool shownRefined = false;
+        bool refinePending = false; // 草稿模式下提交的视图尚缺精细任务
+        bool hasViewKey = false;
+        ViewKey viewKey;
+        QCPRange tileKeyRange; // 当前瓦片 (视口加两侧余量) 覆盖的 X 范围
+    };
+
+    ViewKey currentViewKey(QCustomPlot *plot) const;
+    bool tileCovers(const PlotState &state, const ViewKey &key) const;
+    void submit(QCustomPlot *plot, PlotState &state, bool refineOnly = false);
+    void resetPlot(QCustomPlot *plot, PlotState &state);
+
+    RenderScheduler *m_scheduler;
+    QThreadPool *m_pool;
+    bool m_enabled;
+    bool m_draft;
+    double m_draftLodFactor;
+    QHash<QCustomPlot *, PlotState> m_states;
+};
+
+#endif // PLOTRASTERIZER_H
@@ -0,0 +1,398 @@
+#include "rangestatsmodel.h"
+#include "latestjobrunner.h"
+
+#include <QRunnable>
+#include <QSet>
+#include <QTimer>
+#include <QtNumeric>
+#include <algorithm>
+
+/**
+ * @brief [辅助函数] 游标区间对应的样本下标 [begin, end)
+ */
+static void sampleRange(const RangeStatsModel::Entry &entry, double key1, double key2, int *begin, int *end)
+{
+    const int n = qMin(entry.keys.size(), entry.values.size());
+    const double *keys = entry.keys.constData();
+    *begin = int(std::lower_bound(keys, keys + n, key1) - keys);
+    *end = int(std::upper_bound(keys, keys + n, key2) - keys);
+}
+
+/**
+ * @brief 区间统计任务 (在线程池中运行)
+ * * 只做前缀和相减和 LOD 最小/最大值，每个信号 O(log n)
+ */
+class RangeStatsJob : public QRunnable
+{
+public:
+    RangeStatsJob(RangeStatsModel *owner, const QVector<RangeStatsModel::Entry> &entries,
+                  const QVector<SignalPrefixSums> &sums, double key1, double key2, int generation)
+        : m_owner(owner),
+          m_entries(entries),
+          m_sums(sums),
+          m_key1(qMin(key1, key2)),
+          m_key2(qMax(key1, key2)),
+          m_generation(generation)
+    {
+    }
+
+    void run() override
+    {
+        RangeStatsResult result;
+        result.generation = m_generation;
+        result.ranges.resize(m_entries.size());
+        result.mins.fill(qQNaN(), m_entries.size());
+        result.maxs.fill(qQNaN(), m_entries.size());
+        result.built.resize(m_entries.size());
+
+        for (int i = 0; i < m_entries.size(); ++i)
+        {
+            const RangeStatsModel::Entry &entry = m_entries.at(i);
+
+            // 前缀和只在第一次需要时构建
+            SignalPrefixSums sums = m_sums.at(i);
+            if (sums.isEmpty())
+            {
+                sums = SignalPrefixSums::build(entry.keys, entry.values);
+                result.built[i] = sums;
+            }
+
+            int begin = 0;
+            int end = 0;
+            sampleRange(entry, m_key1, m_key2, &begin, &end);
+
+            result.ranges[i] = sums.rangeStats(begin, end);
+            double lo = 0;
+            double hi = 0;
+            if (entry.lod.rangeMinMax(entry.values, begin, end, lo, hi))
+            {
+                result.mins[i] = lo;
+                result.maxs[i] = hi;
+            }
+        }
+
+        emit m_owner->statsReady(result);
+    }
+
+private:
+    RangeStatsModel *m_owner;
+    QVector<RangeStatsModel::Entry> m_entries;
+    QVector<SignalPrefixSums> m_sums;
+    double m_key1;
+    double m_key2;
+    int m_generation;
+};
+
+/**
+ * @brief 区间分位数任务 (在线程池中运行)
+ * * 合并区间内各块的 t-digest 摘要，两端不完整的块使用原始样本
+ */
+class RangeQuantilesJob : public QRunnable
+{
+public:
+    RangeQuantilesJob(RangeStatsModel *owner, const QVector<RangeStatsModel::Entry> &entries,
+                      double key1, double key2, int generation)
+        : m_owner(owner),
+          m_entries(entries),
+          m_key1(qMin(key1, key2)),
+          m_key2(qMax(key1, key2)),
+          m_generation(generation)
+    {
+    }
+
+    void run() override
+    {
+        RangeQuantilesResult result;
+        result.generation = m_generation;
+        result.p50s.fill(qQNaN(), m_entries.size());
+        result.p95s.fill(qQNaN(), m_entries.size());
+        result.p99s.fill(qQNaN(), m_entries.size());
+
+        for (int i = 0; i < m_entries.size(); ++i)
+        {
+            const RangeStatsModel::Entry &entry = m_entries.at(i);
+            int begin = 0;
+            int end = 0;
+            sampleRange(entry, m_key1, m_key2, &begin, &end);
+
+            const QuantileDigest digest = entry.quantiles.rangeDigest(entry.values, begin, end);
+            if (!digest.isEmpty())
+            {
+                result.p50s[i] = digest.quantile(0.50);
+                result.p95s[i] = digest.quantile(0.95);
+                result.p99s[i] = digest.quantile(0.99);
+            }
+        }
+
+        emit m_owner->quantilesReady(result);
+    }
+
+private:
+    RangeStatsModel *m_owner;
+    QVector<RangeStatsModel::Entry> m_entries;
+    double m_key1;
+    double m_key2;
+    int m_generation;
+};
+
+RangeStatsModel::RangeStatsModel(QObject *parent)
+    : SignalRowModel(parent),
+      m_cursorKey1(0),
+      m_cursorKey2(0),
+      m_active(false),
+      m_runner(nullptr),
+      m_quantileRunner(nullptr),
+      m_quantileTimer(nullptr)
+{
+    qRegisterMetaType<RangeStatsResult>("RangeStatsResult");
+    qRegisterMetaType<RangeQuantilesResult>("RangeQuantilesResult");
+
+    m_runner = new LatestJobRunner([this](int generation) { return createJob(generation); }, this);
+    m_quantileRunner = new LatestJobRunner([this](int generation) { return createQuantilesJob(generation); }, this);
+
+    // 游标停止移动后才计算分位数
+    m_quantileTimer = new QTimer(this);
+    m_quantileTimer->setSingleShot(true);
+    m_quantileTimer->setInterval(kQuantileDelayMs);
+
+    connect(m_quantileTimer, &QTimer::timeout, m_quantileRunner, [this]() { m_quantileRunner->request(); });
+    connect(this, &RangeStatsModel::statsReady, this, &RangeStatsModel::onStatsReady, Qt::QueuedConnection);
+    connect(this, &RangeStatsModel::quantilesReady, this, &RangeStatsModel::onQuantilesReady, Qt::QueuedConnection);
+}
+
+RangeStatsModel::~RangeStatsModel()
+{
+    m_runner->cancelAndWait();
+    m_quantileRunner->cancelAndWait();
+}
+
+int RangeStatsModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+int RangeStatsModel::entryCount() const
+{
+    return m_entries.size();
+}
+
+const SignalRowEntry &RangeStatsModel::entryAt(int row) const
+{
+    return m_entries.at(row);
+}
+
+QVariant RangeStatsModel::valueText(int row, int column) const
+{
+    if (!m_active || row >= m_result.ranges.size())
+        return QString();
+
+    const SignalPrefixSums::Range &range = m_result.ranges.at(row);
+    switch (column)
+    {
+    case CountColumn:
+        return range.count;
+    case MinColumn:
+        return formatValue(m_result.mins.at(row));
+    case MaxColumn:
+        return formatValue(m_result.maxs.at(row));
+    case MeanColumn:
+        return formatValue(range.mean);
+    case RmsColumn:
+        return formatValue(range.rms);
+    case StdDevColumn:
+        return formatValue(range.stddev);
+    case IntegralColumn:
+        return formatValue(range.integral);
+    case P50Column:
+        return formatValue(m_quantiles.p50s.value(row, qQNaN()));
+    case P95Column:
+        return formatValue(m_quantiles.p95s.value(row, qQNaN()));
+    case P99Column:
+        return formatValue(m_quantiles.p99s.value(row, qQNaN()));
+    default:
+        return QVariant();
+    }
+}
+
+QVariant RangeStatsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QAbstractTableModel::headerData(section, orientation, role);
+
+    switch (section)
+    {
+    case NameColumn:
+        return tr("信号");
+    case CountColumn:
+        return tr("样本数");
+    case MinColumn:
+        return tr("最小值");
+    case MaxColumn:
+        return tr("最大值");
+    case MeanColumn:
+        return tr("均值");
+    case RmsColumn:
+        return tr("RMS");
+    case StdDevColumn:
+        return tr("标准差");
+    case IntegralColumn:
+        return tr("积分");
+    case P50Column:
+        return tr("P50");
+    case P95Column:
+        return tr("P95");
+    case P99Column:
+        return tr("P99");
+    default:
+        return QVariant();
+    }
+}
+
+void RangeStatsModel::setEntries(const QVector<Entry> &entries)
+{
+    beginResetModel();
+    m_entries = entries;
+    clearResults();
+    endResetModel();
+
+    // 释放不再绘制的信号的前缀和
+    QSet<QString> ids;
+    for (const Entry &entry : m_entries)
+        ids.insert(entry.uniqueID);
+    for (auto it = m_cache.begin(); it != m_cache.end();)
+    {
+        if (!ids.contains(it.key()))
+            it = m_cache.erase(it);
+        else
+            ++it;
+    }
+
+    // 基于旧条目的任务结果需丢弃
+    m_runner->invalidate();
+    submit();
+}
+
+void RangeStatsModel::setActive(bool active)
+{
+    if (m_active == active)
+        return;
+
+    m_active = active;
+    if (m_active)
+    {
+        submit();
+    }
+    else
+    {
+        // 运行中任务的结果在 onStatsReady 中丢弃
+        clearResults();
+        emitValuesChanged();
+    }
+}
+
+/**
+ * @brief [槽] 记录游标位置并请求重新统计
+ */
+void RangeStatsModel::setCursorKey(double key, int cursorIndex)
+{
+    if (cursorIndex == 1)
+        m_cursorKey1 = key;
+    else if (cursorIndex == 2)
+        m_cursorKey2 = key;
+    else
+        return;
+
+    submit();
+}
+
+/**
+ * @brief [辅助] 请求统计 (面板不活动时不计算)，分位数推迟到游标停止移动后
+ */
+void RangeStatsModel::submit()
+{
+    if (!m_active)
+        return;
+
+    m_runner->request();
+    scheduleQuantiles();
+}
+
+/**
+ * @brief [辅助] 作废当前的分位数 (显示为 "-") 并重新开始等待
+ */
+void RangeStatsModel::scheduleQuantiles()
+{
+    m_quantileRunner->invalidate();
+    m_quantiles = RangeQuantilesResult();
+    m_quantileTimer->start();
+}
+
+/**
+ * @brief [辅助] 按当前条目和游标位置创建统计任务
+ * * 取出仍对应同一份数据的缓存，其余的由任务重新构建
+ */
+QRunnable *RangeStatsModel::createJob(int generation)
+{
+    if (!m_active)
+        return nullptr;
+
+    QVector<SignalPrefixSums> sums(m_entries.size());
+    for (int i = 0; i < m_entries.size(); ++i)
+    {
+        auto it = m_cache.constFind(m_entries.at(i).uniqueID);
+        if (it != m_cache.constEnd() && it.value().values.constData() == m_entries.at(i).values.constData())
+            sums[i] = it.value().sums;
+    }
+    return new RangeStatsJob(this, m_entries, sums, m_cursorKey1, m_cursorKey2, generation);
+}
+
+QRunnable *RangeStatsModel::createQuantilesJob(int generation)
+{
+    if (!m_active)
+        return nullptr;
+    return new RangeQuantilesJob(this, m_entries, m_cursorKey1, m_cursorKey2, generation);
+}
+
+void RangeStatsModel::clearResults()
+{
+    m_result = RangeStatsResult();
+    m_quantiles = RangeQuantilesResult();
+    m_quantileTimer->stop();
+    m_quantileRunner->invalidate();
+}
+
+/**
+ * @brief [槽] 接收统计结果，缓存新建的前缀和，只通知数值列变化
+ */
+void RangeStatsModel::onStatsReady(const RangeStatsResult &result)
+{
+    if (!m_active || !m_runner->isCurrent(result.generation) || result.ranges.size() != m_entries.size())
+        return;
+
+    for (int i = 0; i < result.built.size(); ++i)
+    {
+        if (result.built.at(i).isEmpty())
+            continue;
+        CachedSums cached;
+        cached.values = m_entries.at(i).values;
+        cached.sums = result.built.at(i);
+        m_cache.insert(m_entries.at(i).uniqueID, cached);
+    }
+
+    m_result = result;
+    m_result.built.clear();
+    emitValuesChanged();
+}
+
+/**
+ * @brief [槽] 接收分位数结果，只通知分位数列变化
+ */
+void RangeStatsModel::onQuantilesReady(const RangeQuantilesResult &result)
+{
+    if (!m_active || !m_quantileRunner->isCurrent(result.generation) || result.p50s.size() != m_entries.size())
+        return;
+
+    m_quantiles = result;
+    if (!m_entries.isEmpty())
+        emit dataChanged(index(0, P50Column), index(m_entries.size() - 1, P99Column), {Qt::DisplayRole});
+}
@@ -0,0 +1,152 @@
+#ifndef RANGESTATSMODEL_H
+#define RANGESTATSMODEL_H
+
+#include <QHash>
+#include <QVector>
+#include <QMetaType>
+
+#include "signalrowmodel.h"
+#include "signalprefixsums.h"
+#include "signallod.h"
+#include "signalquantiles.h"
+
+// 向前声明
+class LatestJobRunner;
+class QRunnable;
+class QTimer;
+
+/**
+ * @brief 一次区间统计任务的结果 (工作线程 -> GUI 线程)
+ */
+struct RangeStatsResult
+{
+    int generation = 0;
+    QVector<SignalPrefixSums::Range> ranges; // 与条目一一对应
+    QVector<double> mins;
+    QVector<double> maxs;
+    QVector<SignalPrefixSums> built; // 本次新建的前缀和 (未新建的为空)
+};
+Q_DECLARE_METATYPE(RangeStatsResult)
+
+/**
+ * @brief 一次区间分位数任务的结果 (工作线程 -> GUI 线程)
+ */
+struct RangeQuantilesResult
+{
+    int generation = 0;
+    QVector<double> p50s; // 与条目一一对应，由分块摘要合并得到
+    QVector<double> p95s;
+    QVector<double> p99s;
+};
+Q_DECLARE_METATYPE(RangeQuantilesResult)
+
+/**
+ * @brief 双游标区间统计表模型
+ * * 每行一个已绘制的信号，统计两游标之间样本的个数、最小/最大值、均值、RMS、标准差和积分。
+ * 前缀和在某个信号第一次参与统计时于工作线程中构建并缓存，之后每次游标移动只需
+ * 两次二分查找加 O(1) 的前缀和相减；最小/最大值借助 LOD 金字塔，为 O(log n)。
+ * 分位数需要合并区间内各块的 t-digest 摘要并排序两端不完整块的原始样本，开销较大，
+ * 因此由单独的任务在游标停止移动 kQuantileDelayMs 之后计算，拖拽期间分位数列显示为 "-"。
+ * 两类任务各由一个 LatestJobRunner 调度：同一时刻最多一个任务，拖拽期间只保留最新位置。
+ */
+class RangeStatsModel : public SignalRowModel
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        NameColumn = 0,
+        CountColumn,
+        MinColumn,
+        MaxColumn,
+        MeanColumn,
+        RmsColumn,
+        StdDevColumn,
+        IntegralColumn,
+        P50Column,
+        P95Column,
+        P99Column,
+        ColumnCount
+    };
+
+    /**
+     * @brief 一个信号条目：在游标读数的基础上附带区间最小/最大值和分位数所需的结构
+     */
+    struct Entry : SignalRowEntry
+    {
+        SignalLod lod;
+        SignalQuantiles quantiles;
+    };
+
+    static const int kQuantileDelayMs = 200; // 游标停止移动后多久计算分位数
+
+    explicit RangeStatsModel(QObject *parent = nullptr);
+    ~RangeStatsModel();
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief 替换全部条目 (不再绘制的信号的前缀和随之释放)
+     */
+    void setEntries(const QVector<Entry> &entries);
+
+    /**
+     * @brief 只有双游标模式且面板可见时才计算 (避免为隐藏的面板构建前缀和)
+     */
+    void setActive(bool active);
+
+public slots:
+    /**
+     * @brief [槽] 游标位置变化 (与 CursorManager::cursorKeyChanged 对应)
+     */
+    void setCursorKey(double key, int cursorIndex);
+
+signals:
+    /**
+     * @brief [信号] 工作线程完成一次统计 (以排队连接送回 GUI 线程)
+     */
+    void statsReady(const RangeStatsResult &result);
+    void quantilesReady(const RangeQuantilesResult &result);
+
+private slots:
+    void onStatsReady(const RangeStatsResult &result);
+    void onQuantilesReady(const RangeQuantilesResult &result);
+
+protected:
+    int entryCount() const override;
+    const SignalRowEntry &entryAt(int row) const override;
+    QVariant valueText(int row, int column) const override;
+
+private:
+    /**
+     * @brief 缓存的前缀和 (同时持有数值向量，用于判断数据是否仍是构建时的那一份)
+     */
+    struct CachedSums
+    {
+        QVector<double> values;
+        SignalPrefixSums sums;
+    };
+
+    void submit();
+    void scheduleQuantiles();
+    QRunnable *createJob(int generation);
+    QRunnable *createQuantilesJob(int generation);
+    void clearResults();
+
+    QVector<Entry> m_entries;
+    RangeStatsResult m_result;
+    RangeQuantilesResult m_quantiles;
+    QHash<QString, CachedSums> m_cache; // 信号 ID -> 前缀和
+
+    double m_cursorKey1;
+    double m_cursorKey2;
+    bool m_active;
+
+    LatestJobRunner *m_runner;
+    LatestJobRunner *m_quantileRunner;
+    QTimer *m_quantileTimer;
+};
+
+#endif // RANGESTATSMODEL_H
@@ -0,0 +1,238 @@
+#include "renderscheduler.h"
+#include "qcustomplot.h"
+
+#include <QTimer>
+#include <QEvent>
+
+RenderScheduler::RenderScheduler(QObject *parent)
+    : QObject(parent),
+      m_frameTimer(nullptr),
+      m_frameInterval(16)
+{
+    qRegisterMetaType<RenderScheduler::FrameStats>("RenderScheduler::FrameStats");
+
+    m_frameTimer = new QTimer(this);
+    m_frameTimer->setSingleShot(true);
+    m_frameTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_frameTimer, &QTimer::timeout, this, &RenderScheduler::flush);
+
+    m_sinceLastFrame.start();
+}
+
+RenderScheduler::~RenderScheduler()
+{
+}
+
+void RenderScheduler::setFrameInterval(int ms)
+{
+    m_frameInterval = qMax(0, ms);
+}
+
+int RenderScheduler::frameInterval() const
+{
+    return m_frameInterval;
+}
+
+RenderScheduler::FrameStats RenderScheduler::frameStats() const
+{
+    return m_stats;
+}
+
+void RenderScheduler::resetFrameStats()
+{
+    m_stats = FrameStats();
+}
+
+bool RenderScheduler::isPending(QCustomPlot *plot) const
+{
+    return m_dirtySet.contains(plot) || m_dirtyLayers.contains(plot);
+}
+
+void RenderScheduler::setPlotSuspended(QCustomPlot *plot, bool suspended)
+{
+    if (!plot)
+        return;
+
+    trackPlot(plot);
+    if (suspended)
+    {
+        m_suspendedPlots.insert(plot);
+        return;
+    }
+
+    if (m_suspendedPlots.remove(plot) && m_deferredPlots.contains(plot))
+        requestReplot(plot);
+}
+
+bool RenderScheduler::isPlotSuspended(QCustomPlot *plot) const
+{
+    return m_suspendedPlots.contains(plot);
+}
+
+/**
+ * @brief [槽] 将子图标记为脏
+ * * 同一帧内的重复请求会被合并
+ */
+void RenderScheduler::requestReplot(QCustomPlot *plot)
+{
+    if (!plot)
+        return;
+
+    m_stats.requests++;
+    trackPlot(plot);
+
+    if (!m_dirtySet.contains(plot))
+    {
+        m_dirtySet.insert(plot);
+        m_dirtyPlots.append(plot);
+    }
+    m_dirtyLayers.remove(plot);
+    scheduleFrame();
+}
+
+/**
+ * @brief [槽] 仅将子图的某个缓冲图层标记为脏
+ */
+void RenderScheduler::requestLayerReplot(QCustomPlot *plot, const QString &layerName)
+{
+    if (!plot)
+        return;
+
+    m_stats.requests++;
+    trackPlot(plot);
+
+    // 已有完整重绘请求时无需单独处理图层
+    if (!m_dirtySet.contains(plot))
+    {
+        QStringList &layers = m_dirtyLayers[plot];
+        if (!layers.contains(layerName))
+            layers.append(layerName);
+    }
+    scheduleFrame();
+}
+
+/**
+ * @brief [辅助] 启动帧定时器
+ * * 空闲后的第一个请求立即处理，连续的请求按帧间隔节流
+ */
+void RenderScheduler::scheduleFrame()
+{
+    if (m_frameTimer->isActive())
+        return;
+
+    qint64 elapsed = m_sinceLastFrame.elapsed();
+    int delay = (elapsed >= m_frameInterval) ? 0 : int(m_frameInterval - elapsed);
+    m_frameTimer->start(delay);
+}
+
+/**
+ * @brief [槽] 处理当前所有挂起的重绘请求 (一帧)
+ */
+void RenderScheduler::flush()
+{
+    m_frameTimer->stop();
+    if (m_dirtyPlots.isEmpty() && m_dirtyLayers.isEmpty())
+        return;
+
+    // 先取出列表，重绘过程中产生的新请求将进入下一帧
+    QList<QCustomPlot *> plots = m_dirtyPlots;
+    QHash<QCustomPlot *, QStringList> layers = m_dirtyLayers;
+    m_dirtyPlots.clear();
+    m_dirtySet.clear();
+    m_dirtyLayers.clear();
+
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+
+    for (QCustomPlot *plot : plots)
+    {
+        layers.remove(plot);
+        if (!isRenderable(plot))
+        {
+            m_deferredPlots.insert(plot);
+            m_stats.skipped++;
+            continue;
+        }
+
+        m_deferredPlots.remove(plot);
+        // 立即重绘缓冲，但窗口刷新交给事件循环合并
+        plot->replot(QCustomPlot::rpQueuedRefresh);
+        m_stats.replots++;
+    }
+
+    for (auto it = layers.constBegin(); it != layers.constEnd(); ++it)
+    {
+        QCustomPlot *plot = it.key();
+        if (!isRenderable(plot))
+        {
+            // 图层缓冲在隐藏期间无意义，重新显示时整体重绘
+            m_deferredPlots.insert(plot);
+            m_stats.skipped++;
+            continue;
+        }
+
+        for (const QString &layerName : it.value())
+        {
+            // QCPLayer::replot 在缓冲失效时会自动退化为完整重绘
+            if (QCPLayer *layer = plot->layer(layerName))
+            {
+                layer->replot();
+                m_stats.layerReplots++;
+            }
+        }
+    }
+
+    double frameMs = frameTimer.nsecsElapsed() * 1e-6;
+    m_stats.frames++;
+    m_stats.lastFrameMs = frameMs;
+    m_stats.avgFrameMs = (m_stats.frames == 1) ? frameMs : m_stats.avgFrameMs * 0.9 + frameMs * 0.1;
+    if (frameMs > m_stats.maxFrameMs)
+        m_stats.maxFrameMs = frameMs;
+
+    m_sinceLastFrame.restart();
+    emit frameRendered(m_stats);
+
+    if (!m_dirtyPlots.isEmpty() || !m_dirtyLayers.isEmpty())
+        scheduleFrame();
+}
+
+bool RenderScheduler::isRenderable(QCustomPlot *plot) const
+{
+    return plot->isVisible() && plot->width() > 0 && plot->height() > 0 && !m_suspendedPlots.contains(plot);
+}
+
+void RenderScheduler::trackPlot(QCustomPlot *plot)
+{
+    if (m_trackedPlots.contains(plot))
+        return;
+
+    m_trackedPlots.insert(plot);
+    plot->installEventFilter(this);
+    connect(plot, &QObject::destroyed, this, &RenderScheduler::onPlotDestroyed);
+}
+
+/**
+ * @brief 被推迟的子图重新显示时补上一次重绘
+ */
+bool RenderScheduler::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Show)
+    {
+        QCustomPlot *plot = static_cast<QCustomPlot *>(watched);
+        if (m_deferredPlots.contains(plot) && !m_suspendedPlots.contains(plot))
+            requestReplot(plot);
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void RenderScheduler::onPlotDestroyed(QObject *object)
+{
+    // 此时对象已析构，只能按指针值移除
+    QCustomPlot *plot = static_cast<QCustomPlot *>(object);
+    m_trackedPlots.remove(plot);
+    m_deferredPlots.remove(plot);
+    m_suspendedPlots.remove(plot);
+    m_dirtyLayers.remove(plot);
+    if (m_dirtySet.remove(plot))
+        m_dirtyPlots.removeAll(plot);
+}
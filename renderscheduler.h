@@ -0,0 +1,123 @@
+#ifndef RENDERSCHEDULER_H
+#define RENDERSCHEDULER_H
+
+#include <QObject>
+#include <QList>
+#include <QSet>
+#include <QHash>
+#include <QStringList>
+#include <QElapsedTimer>
+
+// 向前声明
+class QCustomPlot;
+class QTimer;
+
+/**
+ * @brief 渲染调度器 (运行在 GUI 线程)
+ * * 所有子图的重绘请求先标记为 "脏"，再由帧定时器统一处理，
+ * 保证每个子图在每个显示帧内最多只重绘一次。
+ * 隐藏、尺寸为 0 或被暂停 (例如滚出视口) 的子图会被跳过，直到它们重新可见。
+ * 对于只需刷新单个缓冲图层 (例如游标) 的请求，仅重绘该图层，
+ * 其余图层保留已缓存的像素。
+ */
+class RenderScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 帧时间统计 (用于调试)
+     */
+    struct FrameStats
+    {
+        int frames = 0;           // 已处理的帧数
+        int requests = 0;         // 收到的重绘请求总数
+        int replots = 0;          // 实际执行的重绘次数
+        int layerReplots = 0;     // 仅重绘单个图层的次数
+        int skipped = 0;          // 因隐藏/尺寸为 0 而跳过的次数
+        double lastFrameMs = 0.0; // 最近一帧的耗时
+        double avgFrameMs = 0.0;  // 帧耗时的指数滑动平均
+        double maxFrameMs = 0.0;  // 最大帧耗时
+    };
+
+    explicit RenderScheduler(QObject *parent = nullptr);
+    ~RenderScheduler();
+
+    /**
+     * @brief 设置帧间隔 (毫秒)，默认 16ms (约 60fps)
+     */
+    void setFrameInterval(int ms);
+    int frameInterval() const;
+
+    FrameStats frameStats() const;
+    void resetFrameStats();
+
+    /**
+     * @brief 子图当前是否有未处理的重绘请求
+     */
+    bool isPending(QCustomPlot *plot) const;
+
+    /**
+     * @brief 暂停/恢复子图的重绘 (例如滚出视口的子图)
+     * * 暂停期间的请求与隐藏子图一样被推迟，恢复时补绘一次
+     */
+    void setPlotSuspended(QCustomPlot *plot, bool suspended);
+    bool isPlotSuspended(QCustomPlot *plot) const;
+
+public slots:
+    /**
+     * @brief [槽] 将子图标记为脏，在下一帧中重绘
+     */
+    void requestReplot(QCustomPlot *plot);
+
+    /**
+     * @brief [槽] 仅将子图的某个图层标记为脏
+     * * 图层必须为 QCPLayer::lmBuffered 模式；若同一帧内该子图也请求了完整重绘，
+     * 则图层请求被合并到完整重绘中
+     * @param layerName 图层名称
+     */
+    void requestLayerReplot(QCustomPlot *plot, const QString &layerName);
+
+    /**
+     * @brief [槽] 立即处理所有挂起的重绘请求
+     */
+    void flush();
+
+signals:
+    /**
+     * @brief [信号] 一帧处理完成
+     * @param stats 累计的帧时间统计
+     */
+    void frameRendered(const RenderScheduler::FrameStats &stats);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void onPlotDestroyed(QObject *object);
+
+private:
+    void scheduleFrame();
+    bool isRenderable(QCustomPlot *plot) const;
+    void trackPlot(QCustomPlot *plot);
+
+    QTimer *m_frameTimer;
+    QElapsedTimer m_sinceLastFrame;
+    int m_frameInterval;
+
+    // 保持请求顺序，避免 QSet 的无序遍历
+    QList<QCustomPlot *> m_dirtyPlots;
+    QSet<QCustomPlot *> m_dirtySet;
+    // 仅需重绘单个图层的子图 -> 图层名称列表
+    QHash<QCustomPlot *, QStringList> m_dirtyLayers;
+    // 因隐藏而被推迟的子图，在 Show 事件时补绘
+    QSet<QCustomPlot *> m_deferredPlots;
+    QSet<QCustomPlot *> m_suspendedPlots;
+    QSet<QCustomPlot *> m_trackedPlots;
+
+    FrameStats m_stats;
+};
+
+Q_DECLARE_METATYPE(RenderScheduler::FrameStats)
+
+#endif // RENDERSCHEDULER_H
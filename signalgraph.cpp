@@ -0,0 +1,287 @@
+#include "signalgraph.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// 每像素样本数低于此值时逐点计算已足够快
+static const double kDenseSelectSamplesPerPixel = 2.0;
+// 悬停高亮时画笔加宽的像素数
+static const double kHighlightExtraWidth = 1.5;
+
+SignalGraph::SignalGraph(QCPAxis *keyAxis, QCPAxis *valueAxis)
+    : QCPGraph(keyAxis, valueAxis),
+      m_rasterized(false),
+      m_highlighted(false),
+      m_draft(false),
+      m_draftLodFactor(4.0),
+      m_draftAntialiased(false)
+{
+}
+
+SignalGraph::~SignalGraph()
+{
+}
+
+void SignalGraph::setSignalSource(const QVector<double> &keys, const QVector<double> &values, const SignalLod &lod)
+{
+    m_keys = keys;
+    m_values = values;
+    m_lod = lod;
+}
+
+const QVector<double> &SignalGraph::sourceKeys() const
+{
+    return m_keys;
+}
+
+const QVector<double> &SignalGraph::sourceValues() const
+{
+    return m_values;
+}
+
+const SignalLod &SignalGraph::sourceLod() const
+{
+    return m_lod;
+}
+
+void SignalGraph::setRasterized(bool rasterized)
+{
+    m_rasterized = rasterized;
+}
+
+bool SignalGraph::isRasterized() const
+{
+    return m_rasterized;
+}
+
+QCPRange SignalGraph::getValueRange(bool &foundRange, QCP::SignDomain inSignDomain, const QCPRange &inKeyRange) const
+{
+    const int n = qMin(m_keys.size(), m_values.size());
+    if (inSignDomain != QCP::sdBoth || n == 0)
+        return QCPGraph::getValueRange(foundRange, inSignDomain, inKeyRange);
+
+    // 与 QCPDataContainer::valueRange 一致：默认构造的 QCPRange 表示不限制时间范围
+    int begin = 0;
+    int end = n;
+    if (inKeyRange != QCPRange())
+    {
+        const double *keyData = m_keys.constData();
+        begin = int(std::lower_bound(keyData, keyData + n, inKeyRange.lower) - keyData);
+        end = int(std::upper_bound(keyData, keyData + n, inKeyRange.upper) - keyData);
+    }
+
+    double lo = 0;
+    double hi = 0;
+    foundRange = m_lod.rangeMinMax(m_values, begin, end, lo, hi);
+    return foundRange ? QCPRange(lo, hi) : QCPRange();
+}
+
+void SignalGraph::setHighlighted(bool highlighted)
+{
+    m_highlighted = highlighted;
+}
+
+bool SignalGraph::isHighlighted() const
+{
+    return m_highlighted;
+}
+
+void SignalGraph::setDraftMode(bool draft, double lodFactor, bool antialiased)
+{
+    m_draft = draft;
+    m_draftLodFactor = qMax(1.0, lodFactor);
+    m_draftAntialiased = antialiased;
+}
+
+bool SignalGraph::isDraftMode() const
+{
+    return m_draft;
+}
+
+double SignalGraph::selectTest(const QPointF &pos, bool onlySelectable, QVariant *details) const
+{
+    const int n = qMin(m_keys.size(), m_values.size());
+    if (n == 0 || m_lod.isEmpty() || mLineStyle != lsLine || !mKeyAxis || !mValueAxis ||
+        mKeyAxis.data()->orientation() != Qt::Horizontal)
+        return QCPGraph::selectTest(pos, onlySelectable, details);
+
+    if ((onlySelectable && mSelectable == QCP::stNone) || mDataContainer->isEmpty())
+        return -1;
+    if (!mKeyAxis.data()->axisRect()->rect().contains(pos.toPoint()) &&
+        !mParentPlot->interactions().testFlag(QCP::iSelectPlottablesBeyondAxisRect))
+        return -1;
+
+    QCPAxis *keyAxis = mKeyAxis.data();
+    QCPAxis *valueAxis = mValueAxis.data();
+    const double *keyData = m_keys.constData();
+
+    // 稀疏时逐点计算更精确 (相邻样本的连线可能跨越多个像素列)
+    const QCPRange keyRange = keyAxis->range();
+    const int visibleBegin = int(std::lower_bound(keyData, keyData + n, keyRange.lower) - keyData);
+    const int visibleEnd = int(std::upper_bound(keyData, keyData + n, keyRange.upper) - keyData);
+    const double axisPixels = qMax(1, keyAxis->axisRect()->width());
+    if ((visibleEnd - visibleBegin) / axisPixels < kDenseSelectSamplesPerPixel)
+        return QCPGraph::selectTest(pos, onlySelectable, details);
+
+    const int tolerance = qMax(1, int(std::ceil(mParentPlot->selectionTolerance())));
+    const int firstColumn = int(std::floor(pos.x())) - tolerance;
+    const int lastColumn = int(std::floor(pos.x())) + tolerance;
+
+    double minDistSqr = std::numeric_limits<double>::max();
+    bool found = false;
+    for (int column = firstColumn; column <= lastColumn; ++column)
+    {
+        double keyA = keyAxis->pixelToCoord(column);
+        double keyB = keyAxis->pixelToCoord(column + 1);
+        if (keyA > keyB)
+            std::swap(keyA, keyB);
+
+        // 向两侧各多取一个样本，使列间的连线段也被覆盖
+        int begin = int(std::lower_bound(keyData, keyData + n, keyA) - keyData) - 1;
+        int end = int(std::lower_bound(keyData, keyData + n, keyB) - keyData) + 1;
+        begin = qMax(0, begin);
+        end = qMin(n, end);
+        if (begin >= end)
+            continue;
+
+        double lo = 0;
+        double hi = 0;
+        if (!m_lod.rangeMinMax(m_values, begin, end, lo, hi))
+            continue;
+
+        double yA = valueAxis->coordToPixel(lo);
+        double yB = valueAxis->coordToPixel(hi);
+        if (yA > yB)
+            std::swap(yA, yB);
+
+        const double dx = (column + 0.5) - pos.x();
+        double dy = 0;
+        if (pos.y() < yA)
+            dy = yA - pos.y();
+        else if (pos.y() > yB)
+            dy = pos.y() - yB;
+
+        const double distSqr = dx * dx + dy * dy;
+        if (distSqr < minDistSqr)
+        {
+            minDistSqr = distSqr;
+            found = true;
+        }
+    }
+
+    if (!found)
+        return -1;
+
+    if (details)
+    {
+        // 与 QCPGraph 一致，附带最接近点击位置的数据点
+        const double key = keyAxis->pixelToCoord(pos.x());
+        int index = int(std::lower_bound(keyData, keyData + n, key) - keyData);
+        if (index >= n)
+            index = n - 1;
+        if (index > 0 && (key - keyData[index - 1]) < (keyData[index] - key))
+            --index;
+        details->setValue(QCPDataSelection(QCPDataRange(index, index + 1)));
+    }
+    return std::sqrt(minDistSqr);
+}
+
+void SignalGraph::draw(QCPPainter *painter)
+{
+    const bool exporting = painter->modes().testFlag(QCPPainter::pmNoCaching);
+
+    // 后台合成模式下，普通曲线由光栅图像代替；
+    // 选中或悬停的曲线仍在上层实时绘制以显示高亮，导出 (pmNoCaching) 时始终精确绘制
+    if (m_rasterized && !selected() && !m_highlighted && !exporting)
+        return;
+
+    if (m_highlighted && !selected() && !exporting)
+    {
+        // 临时加宽画笔，绘制后恢复 (直接修改 mPen，不触发任何信号)
+        const QPen normalPen = mPen;
+        QPen hoverPen = normalPen;
+        hoverPen.setWidthF(qMax(1.0, normalPen.widthF()) + kHighlightExtraWidth);
+        mPen = hoverPen;
+        QCPGraph::draw(painter);
+        mPen = normalPen;
+        return;
+    }
+
+    if (m_draft && !selected() && !exporting)
+    {
+        if (drawDraft(painter))
+            return;
+
+        // 稀疏数据仍走 QCPGraph，只关闭抗锯齿
+        const bool antialiased = mAntialiased;
+        mAntialiased = m_draftAntialiased;
+        QCPGraph::draw(painter);
+        mAntialiased = antialiased;
+        return;
+    }
+
+    QCPGraph::draw(painter);
+}
+
+/**
+ * @brief [辅助] 以粗一级的 LOD 桶绘制草稿折线
+ * * 每个桶在其中点时刻输出 min、max 两个顶点，全 NaN 的桶断开折线
+ * @return 数据不够密集 (或样式不适用) 时返回 false，由调用方按常规方式绘制
+ */
+bool SignalGraph::drawDraft(QCPPainter *painter)
+{
+    QCPAxis *keyAxis = mKeyAxis.data();
+    QCPAxis *valueAxis = mValueAxis.data();
+    const int n = qMin(m_keys.size(), m_values.size());
+    if (!keyAxis || !valueAxis || n == 0 || m_lod.isEmpty() || mLineStyle != lsLine ||
+        keyAxis->orientation() != Qt::Horizontal)
+        return false;
+
+    const double *keyData = m_keys.constData();
+    const QCPRange keyRange = keyAxis->range();
+    const int begin = qMax(0, int(std::lower_bound(keyData, keyData + n, keyRange.lower) - keyData) - 1);
+    const int end = qMin(n, int(std::upper_bound(keyData, keyData + n, keyRange.upper) - keyData) + 1);
+    if (begin >= end)
+        return true;
+
+    const double samplesPerPixel = (end - begin) / double(qMax(1, keyAxis->axisRect()->width()));
+    const int level = m_lod.levelForDensity(samplesPerPixel * m_draftLodFactor);
+    if (level < 0)
+        return false;
+
+    const int bucketSize = m_lod.bucketSize(level);
+    const int firstBucket = begin / bucketSize;
+    const int lastBucket = qMin(m_lod.bucketCount(level) - 1, (end - 1) / bucketSize);
+    const double *minData = m_lod.minData(level);
+    const double *maxData = m_lod.maxData(level);
+
+    painter->setPen(mPen);
+    painter->setBrush(Qt::NoBrush);
+    painter->setAntialiasing(m_draftAntialiased);
+
+    QVector<QPointF> points;
+    points.reserve(2 * (lastBucket - firstBucket + 1));
+    auto flush = [painter, &points]() -> void
+    {
+        if (points.size() >= 2)
+            painter->drawPolyline(points.constData(), points.size());
+        points.clear();
+    };
+
+    for (int b = firstBucket; b <= lastBucket; ++b)
+    {
+        if (qIsNaN(minData[b]))
+        {
+            flush();
+            continue;
+        }
+
+        const int mid = qMin(n - 1, b * bucketSize + bucketSize / 2);
+        const double x = keyAxis->coordToPixel(keyData[mid]);
+        points.append(QPointF(x, valueAxis->coordToPixel(minData[b])));
+        points.append(QPointF(x, valueAxis->coordToPixel(maxData[b])));
+    }
+    flush();
+    return true;
+}
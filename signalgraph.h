@@ -0,0 +1,87 @@
+#ifndef SIGNALGRAPH_H
+#define SIGNALGRAPH_H
+
+#include "qcustomplot.h"
+#include "signallod.h"
+
+/**
+ * @brief 信号曲线 (QCPGraph 子类)
+ * * 除 QCPGraph 自身的数据容器外，还持有原始时间/数值向量 (隐式共享，不额外拷贝)
+ * 和 LOD 金字塔，供后台光栅化等快速路径直接读取。
+ */
+class SignalGraph : public QCPGraph
+{
+    Q_OBJECT
+
+public:
+    explicit SignalGraph(QCPAxis *keyAxis, QCPAxis *valueAxis);
+    ~SignalGraph() override;
+
+    /**
+     * @brief 设置原始数据源
+     * @param keys 时间向量 (升序)
+     * @param values 数值向量
+     * @param lod 对应的 min/max 金字塔
+     */
+    void setSignalSource(const QVector<double> &keys, const QVector<double> &values, const SignalLod &lod);
+
+    const QVector<double> &sourceKeys() const;
+    const QVector<double> &sourceValues() const;
+    const SignalLod &sourceLod() const;
+
+    /**
+     * @brief 设置是否由 PlotRasterizer 在后台合成
+     * * 为 true 时曲线不再自行绘制 (选中高亮和导出除外)
+     */
+    void setRasterized(bool rasterized);
+    bool isRasterized() const;
+
+    /**
+     * @brief 数值范围查询 (重写)
+     * * sdBoth 时借助 LOD 金字塔在 O(log n) 内得到结果，自动适配和 rescaleAxes 都走这里；
+     * 其余符号域回退到 QCPGraph 的线性扫描
+     */
+    QCPRange getValueRange(bool &foundRange, QCP::SignDomain inSignDomain = QCP::sdBoth,
+                           const QCPRange &inKeyRange = QCPRange()) const override;
+
+    /**
+     * @brief 命中测试 (重写)
+     * * 密集数据下只检查点击位置 ± 选择容差内的像素列，每列用 LOD 金字塔求 min/max
+     * 作为竖直线段，复杂度 O(像素列数 * log n)，与可见样本数无关；
+     * 稀疏数据或非折线样式回退到 QCPGraph 的逐点计算
+     */
+    double selectTest(const QPointF &pos, bool onlySelectable, QVariant *details = nullptr) const override;
+
+    /**
+     * @brief 设置悬停高亮 (以加粗画笔在上层绘制，不修改曲线本身的画笔)
+     */
+    void setHighlighted(bool highlighted);
+    bool isHighlighted() const;
+
+    /**
+     * @brief 设置草稿质量 (交互期间使用)
+     * * 开启时密集数据直接以 LOD 桶的 min/max 折线绘制，桶宽约为 lodFactor 个像素；
+     * 选中、悬停和导出时仍按完整质量绘制
+     * @param lodFactor 相对像素精度的放大倍数 (>= 1)
+     * @param antialiased 草稿绘制是否抗锯齿
+     */
+    void setDraftMode(bool draft, double lodFactor = 4.0, bool antialiased = false);
+    bool isDraftMode() const;
+
+protected:
+    void draw(QCPPainter *painter) override;
+
+private:
+    bool drawDraft(QCPPainter *painter);
+
+    QVector<double> m_keys;
+    QVector<double> m_values;
+    SignalLod m_lod;
+    bool m_rasterized;
+    bool m_highlighted;
+    bool m_draft;
+    double m_draftLodFactor;
+    bool m_draftAntialiased;
+};
+
+#endif // SIGNALGRAPH_H
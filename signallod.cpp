@@ -0,0 +1,179 @@
+#include "signallod.h"
+
+#include <cmath>
+#include <QtNumeric>
+#include <limits>
+
+SignalLod::SignalLod()
+    : m_sampleCount(0)
+{
+}
+
+/**
+ * @brief 构建金字塔
+ * * 第 0 级直接扫描原始数据，之后每一级两两合并上一级的桶，总开销 O(n)
+ */
+SignalLod SignalLod::build(const QVector<double> &values)
+{
+    SignalLod lod;
+    lod.m_sampleCount = values.size();
+    if (values.size() <= kBaseBucket)
+        return lod; // 数据太少，直接使用原始数据
+
+    // 1. 第 0 级
+    const int n = values.size();
+    const int count0 = (n + kBaseBucket - 1) / kBaseBucket;
+    QVector<double> mins(count0);
+    QVector<double> maxs(count0);
+    const double *src = values.constData();
+
+    for (int b = 0; b < count0; ++b)
+    {
+        const int start = b * kBaseBucket;
+        const int stop = qMin(n, start + kBaseBucket);
+        // std::fmin/fmax 会忽略 NaN 操作数
+        double lo = qQNaN();
+        double hi = qQNaN();
+        for (int i = start; i < stop; ++i)
+        {
+            lo = std::fmin(lo, src[i]);
+            hi = std::fmax(hi, src[i]);
+        }
+        mins[b] = lo;
+        maxs[b] = hi;
+    }
+    lod.m_min.append(mins);
+    lod.m_max.append(maxs);
+
+    // 2. 逐级合并，直到只剩一个桶
+    while (lod.m_min.last().size() > 1)
+    {
+        const QVector<double> &prevMin = lod.m_min.last();
+        const QVector<double> &prevMax = lod.m_max.last();
+        const int prevCount = prevMin.size();
+        const int count = (prevCount + 1) / 2;
+
+        QVector<double> levelMin(count);
+        QVector<double> levelMax(count);
+        for (int b = 0; b < count; ++b)
+        {
+            const int i = 2 * b;
+            if (i + 1 < prevCount)
+            {
+                levelMin[b] = std::fmin(prevMin[i], prevMin[i + 1]);
+                levelMax[b] = std::fmax(prevMax[i], prevMax[i + 1]);
+            }
+            else
+            {
+                levelMin[b] = prevMin[i];
+                levelMax[b] = prevMax[i];
+            }
+        }
+        lod.m_min.append(levelMin);
+        lod.m_max.append(levelMax);
+    }
+
+    return lod;
+}
+
+bool SignalLod::isEmpty() const
+{
+    return m_min.isEmpty();
+}
+
+int SignalLod::sampleCount() const
+{
+    return m_sampleCount;
+}
+
+int SignalLod::levelCount() const
+{
+    return m_min.size();
+}
+
+int SignalLod::bucketSize(int level) const
+{
+    return kBaseBucket << level;
+}
+
+int SignalLod::bucketCount(int level) const
+{
+    return m_min.at(level).size();
+}
+
+const double *SignalLod::minData(int level) const
+{
+    return m_min.at(level).constData();
+}
+
+const double *SignalLod::maxData(int level) const
+{
+    return m_max.at(level).constData();
+}
+
+int SignalLod::levelForDensity(double samplesPerPixel) const
+{
+    int level = -1;
+    for (int l = 0; l < m_min.size(); ++l)
+    {
+        if (bucketSize(l) > samplesPerPixel)
+            break;
+        level = l;
+    }
+    return level;
+}
+
+bool SignalLod::rangeMinMax(const QVector<double> &values, int begin, int end, double &lo, double &hi) const
+{
+    begin = qMax(0, begin);
+    end = qMin(end, values.size());
+    lo = std::numeric_limits<double>::infinity();
+    hi = -std::numeric_limits<double>::infinity();
+    if (end <= begin)
+        return false;
+
+    const double *src = values.constData();
+    auto scan = [&lo, &hi, src](int from, int to) -> void
+    {
+        for (int i = from; i < to; ++i)
+        {
+            lo = std::fmin(lo, src[i]);
+            hi = std::fmax(hi, src[i]);
+        }
+    };
+
+    // 1. 区间内没有完整的基础桶 (或没有金字塔)：直接扫描
+    int bucketBegin = (begin + kBaseBucket - 1) / kBaseBucket;
+    int bucketEnd = end / kBaseBucket;
+    if (m_min.isEmpty() || bucketBegin >= bucketEnd)
+    {
+        scan(begin, end);
+        return lo <= hi;
+    }
+
+    // 2. 两端不完整的部分
+    scan(begin, bucketBegin * kBaseBucket);
+    scan(bucketEnd * kBaseBucket, end);
+
+    // 3. 中间的完整桶：自底向上，奇数边界取当前级，其余交给上一级
+    for (int level = 0; level < m_min.size() && bucketBegin < bucketEnd; ++level)
+    {
+        const QVector<double> &mins = m_min.at(level);
+        const QVector<double> &maxs = m_max.at(level);
+        if (bucketBegin & 1)
+        {
+            lo = std::fmin(lo, mins.at(bucketBegin));
+            hi = std::fmax(hi, maxs.at(bucketBegin));
+            ++bucketBegin;
+        }
+        if (bucketEnd & 1)
+        {
+            --bucketEnd;
+            lo = std::fmin(lo, mins.at(bucketEnd));
+            hi = std::fmax(hi, maxs.at(bucketEnd));
+        }
+        bucketBegin /= 2;
+        bucketEnd /= 2;
+    }
+    return lo <= hi;
+}
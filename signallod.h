@@ -0,0 +1,55 @@
+#ifndef SIGNALLOD_H
+#define SIGNALLOD_H
+
+#include <QVector>
+#include <QMetaType>
+
+/**
+ * @brief 信号的多级 min/max 金字塔 (LOD)
+ * * 第 L 级的每个桶覆盖 (kBaseBucket << L) 个连续样本，记录该区间的最小值和最大值 (忽略 NaN，
+ * 全为 NaN 的桶记为 NaN)。在加载时于工作线程中构建，之后只读，可在多个线程间共享。
+ */
+class SignalLod
+{
+public:
+    static const int kBaseBucket = 32;
+
+    SignalLod();
+
+    /**
+     * @brief 从原始数值构建金字塔
+     */
+    static SignalLod build(const QVector<double> &values);
+
+    bool isEmpty() const;
+    int sampleCount() const;
+    int levelCount() const;
+
+    int bucketSize(int level) const;
+    int bucketCount(int level) const;
+    const double *minData(int level) const;
+    const double *maxData(int level) const;
+
+    /**
+     * @brief 选择桶大小不超过 samplesPerPixel 的最粗一级
+     * @return 级别索引；如果直接使用原始数据更合适，则返回 -1
+     */
+    int levelForDensity(double samplesPerPixel) const;
+
+    /**
+     * @brief 查询样本区间 [begin, end) 的最小/最大值 (忽略 NaN)
+     * * 把金字塔当作线段树使用：两端不足一个基础桶的部分直接扫描原始数据，
+     * 中间部分逐级合并，复杂度 O(kBaseBucket + log n)
+     * @param values 构建金字塔时使用的原始数值
+     * @return 区间内存在非 NaN 样本时返回 true
+     */
+    bool rangeMinMax(const QVector<double> &values, int begin, int end, double &lo, double &hi) const;
+
+private:
+    int m_sampleCount;
+    QVector<QVector<double>> m_min;
+    QVector<QVector<double>> m_max;
+};
+Q_DECLARE_METATYPE(SignalLod)
+
+#endif // SIGNALLOD_H
@@ -0,0 +1,143 @@
+#include "signalprefixsums.h"
+
+#include <QtNumeric>
+#include <cmath>
+
+/**
+ * @brief Kahan 补偿累加器
+ */
+struct KahanSum
+{
+    double sum = 0;
+    double compensation = 0;
+
+    void add(double value)
+    {
+        const double y = value - compensation;
+        const double t = sum + y;
+        compensation = (t - sum) - y;
+        sum = t;
+    }
+};
+
+SignalPrefixSums::Range::Range()
+    : mean(qQNaN()),
+      rms(qQNaN()),
+      stddev(qQNaN()),
+      integral(qQNaN())
+{
+}
+
+SignalPrefixSums::SignalPrefixSums()
+    : m_shift(0)
+{
+}
+
+SignalPrefixSums SignalPrefixSums::build(const QVector<double> &keys, const QVector<double> &values)
+{
+    SignalPrefixSums sums;
+    const int n = qMin(keys.size(), values.size());
+    if (n == 0)
+        return sums;
+
+    const double *t = keys.constData();
+    const double *v = values.constData();
+
+    // 1. 以第一个有限样本为偏移量；同时判断是否需要计数数组
+    int nonFinite = 0;
+    bool shiftFound = false;
+    for (int i = 0; i < n; ++i)
+    {
+        if (!std::isfinite(v[i]))
+        {
+            ++nonFinite;
+        }
+        else if (!shiftFound)
+        {
+            sums.m_shift = v[i];
+            shiftFound = true;
+        }
+    }
+
+    sums.m_sum.resize(n + 1);
+    sums.m_sumSq.resize(n + 1);
+    sums.m_integral.resize(n);
+    if (nonFinite > 0)
+        sums.m_count.resize(n + 1);
+
+    // 2. 单次遍历累加
+    KahanSum sum;
+    KahanSum sumSq;
+    KahanSum integral;
+    int count = 0;
+    sums.m_sum[0] = 0;
+    sums.m_sumSq[0] = 0;
+    sums.m_integral[0] = 0;
+    if (nonFinite > 0)
+        sums.m_count[0] = 0;
+
+    for (int i = 0; i < n; ++i)
+    {
+        const bool finite = std::isfinite(v[i]);
+        if (finite)
+        {
+            const double d = v[i] - sums.m_shift;
+            sum.add(d);
+            sumSq.add(d * d);
+            ++count;
+        }
+        if (i > 0)
+        {
+            if (finite && std::isfinite(v[i - 1]))
+                integral.add((t[i] - t[i - 1]) * (v[i] + v[i - 1]) * 0.5);
+            sums.m_integral[i] = integral.sum;
+        }
+
+        sums.m_sum[i + 1] = sum.sum;
+        sums.m_sumSq[i + 1] = sumSq.sum;
+        if (nonFinite > 0)
+            sums.m_count[i + 1] = count;
+    }
+
+    return sums;
+}
+
+bool SignalPrefixSums::isEmpty() const
+{
+    return m_sum.isEmpty();
+}
+
+int SignalPrefixSums::sampleCount() const
+{
+    return m_integral.size();
+}
+
+int SignalPrefixSums::finiteCount(int begin, int end) const
+{
+    return m_count.isEmpty() ? end - begin : m_count.at(end) - m_count.at(begin);
+}
+
+SignalPrefixSums::Range SignalPrefixSums::rangeStats(int begin, int end) const
+{
+    Range range;
+    begin = qMax(0, begin);
+    end = qMin(end, sampleCount());
+    if (end <= begin)
+        return range;
+
+    range.count = finiteCount(begin, end);
+    if (range.count == 0)
+        return range;
+
+    const double n = range.count;
+    const double s = m_sum.at(end) - m_sum.at(begin);
+    const double ss = m_sumSq.at(end) - m_sumSq.at(begin);
+
+    range.mean = m_shift + s / n;
+    // Σv² = Σ(d + shift)² = Σd² + 2·shift·Σd + n·shift²
+    const double sumOfSquares = ss + 2.0 * m_shift * s + n * m_shift * m_shift;
+    range.rms = std::sqrt(qMax(0.0, sumOfSquares / n));
+    range.stddev = range.count > 1 ? std::sqrt(qMax(0.0, (ss - s * s / n) / (n - 1))) : 0.0;
+    range.integral = m_integral.at(end - 1) - m_integral.at(begin);
+    return range;
+}
@@ -0,0 +1,59 @@
+#ifndef SIGNALPREFIXSUMS_H
+#define SIGNALPREFIXSUMS_H
+
+#include <QVector>
+#include <QMetaType>
+
+/**
+ * @brief 信号的前缀和数组 (用于区间统计)
+ * * 保存数值、数值平方以及梯形积分的前缀和，累加时使用 Kahan 补偿。
+ * 为减小方差计算中的相消误差，数值先减去第一个有限样本再累加。
+ * NaN/Inf 样本不参与统计；只有存在这类样本时才额外保存有限样本计数的前缀和。
+ * 构建后只读，可在多个线程间共享；任意样本区间的计数、均值、RMS、标准差和积分均为 O(1)。
+ */
+class SignalPrefixSums
+{
+public:
+    /**
+     * @brief 一个样本区间的统计量 (没有有限样本时除 count 外均为 NaN)
+     */
+    struct Range
+    {
+        int count = 0;
+        double mean;
+        double rms;
+        double stddev;
+        double integral; // 区间内相邻有限样本之间的梯形积分
+
+        Range();
+    };
+
+    SignalPrefixSums();
+
+    /**
+     * @brief 从原始数据构建前缀和 (O(n))
+     * @param keys 升序时间向量 (用于积分)
+     * @param values 数值向量
+     */
+    static SignalPrefixSums build(const QVector<double> &keys, const QVector<double> &values);
+
+    bool isEmpty() const;
+    int sampleCount() const;
+
+    /**
+     * @brief 样本区间 [begin, end) 的统计量，O(1)
+     */
+    Range rangeStats(int begin, int end) const;
+
+private:
+    int finiteCount(int begin, int end) const;
+
+    double m_shift;
+    QVector<double> m_sum;      // m_sum[i] = Σ (v - shift)，样本 [0, i)
+    QVector<double> m_sumSq;    // m_sumSq[i] = Σ (v - shift)^2，样本 [0, i)
+    QVector<double> m_integral; // m_integral[i] = 样本 0 到 i 之间的梯形积分
+    QVector<int> m_count;       // m_count[i] = 样本 [0, i) 中的有限值个数 (全为有限值时为空)
+};
+Q_DECLARE_METATYPE(SignalPrefixSums)
+
+#endif // SIGNALPREFIXSUMS_H
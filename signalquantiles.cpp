@@ -0,0 +1,286 @@
+#include "signalquantiles.h"
+
+#include <QtNumeric>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief [辅助函数] k1 尺度函数 k(q) = δ/(2π)·asin(2q-1)
+ */
+static double scaleK(double q)
+{
+    return QuantileDigest::kCompression / (2.0 * M_PI) * std::asin(2.0 * q - 1.0);
+}
+
+/**
+ * @brief [辅助函数] k1 尺度函数的反函数，超出定义域时截断到 1
+ */
+static double scaleQ(double k)
+{
+    if (k >= QuantileDigest::kCompression / 4.0)
+        return 1.0;
+    return (std::sin(k * 2.0 * M_PI / QuantileDigest::kCompression) + 1.0) / 2.0;
+}
+
+static bool centroidLess(const QuantileDigest::Centroid &a, const QuantileDigest::Centroid &b)
+{
+    return a.mean < b.mean;
+}
+
+QuantileDigest::QuantileDigest()
+    : m_count(0),
+      m_min(qQNaN()),
+      m_max(qQNaN())
+{
+}
+
+QuantileDigest QuantileDigest::fromValues(const double *values, int count, bool exact)
+{
+    QuantileDigest digest;
+
+    QVector<double> sorted;
+    sorted.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        if (std::isfinite(values[i]))
+            sorted.append(values[i]);
+    }
+    if (sorted.isEmpty())
+        return digest;
+    std::sort(sorted.begin(), sorted.end());
+
+    QVector<Centroid> centroids;
+    centroids.reserve(sorted.size());
+    for (double v : sorted)
+    {
+        Centroid c;
+        c.mean = v;
+        c.weight = 1.0;
+        centroids.append(c);
+    }
+
+    digest.m_count = sorted.size();
+    digest.m_min = sorted.first();
+    digest.m_max = sorted.last();
+    digest.m_centroids = exact ? centroids : compress(centroids, digest.m_count);
+    return digest;
+}
+
+QuantileDigest QuantileDigest::merge(const QVector<QuantileDigest> &parts)
+{
+    QuantileDigest digest;
+
+    int total = 0;
+    for (const QuantileDigest &part : parts)
+        total += part.m_centroids.size();
+
+    QVector<Centroid> centroids;
+    centroids.reserve(total);
+    for (const QuantileDigest &part : parts)
+    {
+        if (part.isEmpty())
+            continue;
+        centroids += part.m_centroids;
+        digest.m_count += part.m_count;
+        // std::fmin/fmax 会忽略 NaN 操作数
+        digest.m_min = std::fmin(digest.m_min, part.m_min);
+        digest.m_max = std::fmax(digest.m_max, part.m_max);
+    }
+    if (centroids.isEmpty())
+        return digest;
+
+    std::sort(centroids.begin(), centroids.end(), centroidLess);
+    digest.m_centroids = compress(centroids, digest.m_count);
+    return digest;
+}
+
+/**
+ * @brief [辅助] 按尺度函数合并相邻质心：每个质心覆盖的分位数跨度不超过 k 增加 1 所对应的跨度
+ */
+QVector<QuantileDigest::Centroid> QuantileDigest::compress(const QVector<Centroid> &sorted, double total)
+{
+    QVector<Centroid> result;
+    if (sorted.isEmpty())
+        return result;
+
+    double weightSoFar = 0;
+    double weightLimit = total * scaleQ(scaleK(0.0) + 1.0);
+    Centroid current = sorted.first();
+
+    for (int i = 1; i < sorted.size(); ++i)
+    {
+        const Centroid &next = sorted.at(i);
+        if (weightSoFar + current.weight + next.weight <= weightLimit)
+        {
+            const double weight = current.weight + next.weight;
+            current.mean += (next.mean - current.mean) * next.weight / weight;
+            current.weight = weight;
+        }
+        else
+        {
+            result.append(current);
+            weightSoFar += current.weight;
+            weightLimit = total * scaleQ(scaleK(weightSoFar / total) + 1.0);
+            current = next;
+        }
+    }
+    result.append(current);
+    return result;
+}
+
+bool QuantileDigest::isEmpty() const
+{
+    return m_centroids.isEmpty();
+}
+
+double QuantileDigest::count() const
+{
+    return m_count;
+}
+
+double QuantileDigest::min() const
+{
+    return m_min;
+}
+
+double QuantileDigest::max() const
+{
+    return m_max;
+}
+
+double QuantileDigest::quantile(double q) const
+{
+    if (m_centroids.isEmpty())
+        return qQNaN();
+    if (q <= 0)
+        return m_min;
+    if (q >= 1)
+        return m_max;
+
+    const int n = m_centroids.size();
+    const double index = q * m_count;
+
+    // 1. 左尾：最小值到第一个质心中心之间线性插值
+    const Centroid &first = m_centroids.first();
+    if (index < first.weight / 2.0)
+        return m_min + (first.mean - m_min) * index / (first.weight / 2.0);
+
+    // 2. 相邻质心中心之间线性插值
+    double cumulative = first.weight / 2.0;
+    for (int i = 0; i + 1 < n; ++i)
+    {
+        const Centroid &a = m_centroids.at(i);
+        const Centroid &b = m_centroids.at(i + 1);
+        const double span = (a.weight + b.weight) / 2.0;
+        if (cumulative + span > index)
+            return a.mean + (b.mean - a.mean) * (index - cumulative) / span;
+        cumulative += span;
+    }
+
+    // 3. 右尾
+    const Centroid &last = m_centroids.last();
+    const double tail = qMin(1.0, (index - cumulative) / (last.weight / 2.0));
+    return last.mean + (m_max - last.mean) * tail;
+}
+
+double QuantileDigest::cdf(double x) const
+{
+    if (m_centroids.isEmpty() || qIsNaN(x))
+        return qQNaN();
+    if (x < m_min)
+        return 0.0;
+    if (x >= m_max)
+        return 1.0;
+
+    const int n = m_centroids.size();
+
+    // 1. 左尾
+    const Centroid &first = m_centroids.first();
+    if (x < first.mean)
+        return (first.mean > m_min ? (x - m_min) / (first.mean - m_min) : 1.0) * (first.weight / 2.0) / m_count;
+
+    // 2. 相邻质心中心之间
+    double cumulative = first.weight / 2.0;
+    for (int i = 0; i + 1 < n; ++i)
+    {
+        const Centroid &a = m_centroids.at(i);
+        const Centroid &b = m_centroids.at(i + 1);
+        const double span = (a.weight + b.weight) / 2.0;
+        if (x < b.mean)
+            return (cumulative + span * (x - a.mean) / (b.mean - a.mean)) / m_count;
+        cumulative += span;
+    }
+
+    // 3. 右尾
+    const Centroid &last = m_centroids.last();
+    return (cumulative + (last.weight / 2.0) * (x - last.mean) / (m_max - last.mean)) / m_count;
+}
+
+SignalQuantiles::SignalQuantiles()
+    : m_sampleCount(0)
+{
+}
+
+SignalQuantiles SignalQuantiles::build(const QVector<double> &values)
+{
+    SignalQuantiles quantiles;
+    quantiles.m_sampleCount = values.size();
+
+    const int n = values.size();
+    const double *src = values.constData();
+    quantiles.m_blocks.reserve((n + kBlockSize - 1) / kBlockSize);
+    for (int start = 0; start < n; start += kBlockSize)
+        quantiles.m_blocks.append(QuantileDigest::fromValues(src + start, qMin(int(kBlockSize), n - start)));
+
+    quantiles.m_total = QuantileDigest::merge(quantiles.m_blocks);
+    return quantiles;
+}
+
+bool SignalQuantiles::isEmpty() const
+{
+    return m_blocks.isEmpty();
+}
+
+int SignalQuantiles::sampleCount() const
+{
+    return m_sampleCount;
+}
+
+const QuantileDigest &SignalQuantiles::total() const
+{
+    return m_total;
+}
+
+QuantileDigest SignalQuantiles::rangeDigest(const QVector<double> &values, int begin, int end) const
+{
+    begin = qMax(0, begin);
+    end = qMin(end, qMin(values.size(), m_sampleCount));
+    if (end <= begin)
+        return QuantileDigest();
+    if (begin == 0 && end == m_sampleCount)
+        return m_total;
+
+    const double *src = values.constData();
+    const int blockBegin = (begin + kBlockSize - 1) / kBlockSize;
+    const int blockEnd = end / kBlockSize;
+
+    // 1. 区间内没有完整的块：样本不多，直接精确计算
+    if (blockBegin >= blockEnd || m_blocks.isEmpty())
+        return QuantileDigest::fromValues(src + begin, end - begin, true);
+
+    // 2. 完整的块使用块摘要，两端不完整的部分使用原始样本
+    QVector<QuantileDigest> parts;
+    parts.reserve(blockEnd - blockBegin + 2);
+    for (int b = blockBegin; b < blockEnd; ++b)
+        parts.append(m_blocks.at(b));
+
+    const int headEnd = blockBegin * kBlockSize;
+    const int tailBegin = blockEnd * kBlockSize;
+    if (headEnd > begin)
+        parts.append(QuantileDigest::fromValues(src + begin, headEnd - begin, true));
+    if (end > tailBegin)
+        parts.append(QuantileDigest::fromValues(src + tailBegin, end - tailBegin, true));
+
+    return QuantileDigest::merge(parts);
+}
@@ -0,0 +1,97 @@
+#ifndef SIGNALQUANTILES_H
+#define SIGNALQUANTILES_H
+
+#include <QVector>
+#include <QMetaType>
+
+/**
+ * @brief 可合并的分位数摘要 (t-digest)
+ * * 按数值排序的质心序列，质心大小受 k1 尺度函数约束：两端 (p1、p99 附近) 的质心很小，
+ * 中间较大，因此尾部分位数的精度最高。多个摘要合并时只需归并质心后重新压缩。
+ * 只统计有限值，NaN/Inf 被忽略。
+ */
+class QuantileDigest
+{
+public:
+    static const int kCompression = 200; // δ，压缩后每个摘要约 δ/2 个质心
+
+    struct Centroid
+    {
+        double mean;
+        double weight;
+    };
+
+    QuantileDigest();
+
+    /**
+     * @brief 由原始样本构建
+     * @param exact 为 true 时不压缩 (每个样本一个质心)，分位数即样本顺序统计量之间的插值
+     */
+    static QuantileDigest fromValues(const double *values, int count, bool exact = false);
+
+    /**
+     * @brief 合并多个摘要
+     */
+    static QuantileDigest merge(const QVector<QuantileDigest> &parts);
+
+    bool isEmpty() const;
+    double count() const;
+    double min() const;
+    double max() const;
+
+    /**
+     * @brief 分位数 q ∈ [0, 1]；摘要为空时返回 NaN
+     */
+    double quantile(double q) const;
+
+    /**
+     * @brief 累积分布：小于等于 x 的样本比例
+     */
+    double cdf(double x) const;
+
+private:
+    static QVector<Centroid> compress(const QVector<Centroid> &sorted, double total);
+
+    QVector<Centroid> m_centroids; // 按 mean 升序
+    double m_count;
+    double m_min;
+    double m_max;
+};
+
+/**
+ * @brief 信号的分块分位数摘要
+ * * 每 kBlockSize 个样本一个 QuantileDigest，另有整条信号的合并摘要。在加载时于工作线程中构建，
+ * 之后只读。区间查询合并完全落在区间内的块摘要，两端不完整的块直接使用原始样本，
+ * 开销与区间内的块数成正比，不需要对区间内的全部样本排序。
+ */
+class SignalQuantiles
+{
+public:
+    static const int kBlockSize = 16384;
+
+    SignalQuantiles();
+
+    static SignalQuantiles build(const QVector<double> &values);
+
+    bool isEmpty() const;
+    int sampleCount() const;
+
+    /**
+     * @brief 整条信号的摘要
+     */
+    const QuantileDigest &total() const;
+
+    /**
+     * @brief 样本区间 [begin, end) 的摘要
+     * @param values 构建时使用的原始数值
+     */
+    QuantileDigest rangeDigest(const QVector<double> &values, int begin, int end) const;
+
+private:
+    int m_sampleCount;
+    QVector<QuantileDigest> m_blocks;
+    QuantileDigest m_total;
+};
+Q_DECLARE_METATYPE(SignalQuantiles)
+
+#endif // SIGNALQUANTILES_H
@@ -0,0 +1,252 @@
+#include "signalregistry.h"
+#include "qcustomplot.h"
+
+SignalRegistry::SignalRegistry(QObject *parent)
+    : QObject(parent),
+      m_duplicateNamePolicy(PreferNewestFile)
+{
+}
+
+SignalRegistry::~SignalRegistry()
+{
+}
+
+SignalHandle SignalRegistry::registerFile(const QString &filename, const FileData &data)
+{
+    unregisterFile(filename);
+
+    FileSlot &file = m_files[filename];
+    file.data = data;
+    file.firstHandle = m_handleTables.size();
+    file.count = 0;
+
+    // 只做常量访问，避免与调用方共享的表数据分离
+    const QList<SignalTable> &tables = file.data.tables;
+    for (const SignalTable &table : tables)
+    {
+        TableSlot slot;
+        slot.fileName = filename;
+        slot.prefix = filename + "/" + table.name + "/";
+        slot.table = &table;
+        slot.firstHandle = m_handleTables.size();
+        slot.count = table.headers.size();
+
+        const int index = m_tables.size();
+        m_tables.append(slot);
+        file.tables.append(index);
+        if (!m_tablesByPrefix.contains(slot.prefix))
+            m_tablesByPrefix.insert(slot.prefix, index);
+
+        // 句柄单调递增，追加后各名称的句柄列表仍保持升序
+        for (int column = 0; column < slot.count; ++column)
+            m_handlesByName[signalDisplayName(table.headers, column)].append(slot.firstHandle + column);
+
+        m_handleTables.insert(m_handleTables.size(), slot.count, index);
+        file.count += slot.count;
+    }
+
+    return file.firstHandle;
+}
+
+void SignalRegistry::unregisterFile(const QString &filename)
+{
+    auto it = m_files.find(filename);
+    if (it == m_files.end())
+        return;
+
+    for (int index : it.value().tables)
+    {
+        TableSlot &slot = m_tables[index];
+        for (int i = 0; i < slot.count; ++i)
+        {
+            const QString name = signalDisplayName(slot.table->headers, i);
+            auto nameIt = m_handlesByName.find(name);
+            if (nameIt != m_handlesByName.end())
+            {
+                nameIt.value().removeOne(slot.firstHandle + i);
+                if (nameIt.value().isEmpty())
+                    m_handlesByName.erase(nameIt);
+            }
+            m_handleTables[slot.firstHandle + i] = -1;
+        }
+        if (m_tablesByPrefix.value(slot.prefix, -1) == index)
+            m_tablesByPrefix.remove(slot.prefix);
+        slot.table = nullptr;
+    }
+
+    m_files.erase(it);
+}
+
+bool SignalRegistry::fileHandles(const QString &filename, SignalHandle *first, int *count) const
+{
+    auto it = m_files.constFind(filename);
+    if (it == m_files.constEnd())
+        return false;
+
+    *first = it.value().firstHandle;
+    *count = it.value().count;
+    return true;
+}
+
+bool SignalRegistry::isValid(SignalHandle handle) const
+{
+    return tableSlot(handle) >= 0;
+}
+
+SignalRegistry::Location SignalRegistry::location(SignalHandle handle) const
+{
+    Location loc;
+    const int index = tableSlot(handle);
+    if (index < 0)
+        return loc;
+
+    const TableSlot &slot = m_tables.at(index);
+    loc.table = slot.table;
+    loc.column = handle - slot.firstHandle;
+    return loc;
+}
+
+QString SignalRegistry::uniqueID(SignalHandle handle) const
+{
+    const int index = tableSlot(handle);
+    if (index < 0)
+        return QString();
+
+    const TableSlot &slot = m_tables.at(index);
+    return slot.prefix + QString::number(handle - slot.firstHandle);
+}
+
+SignalHandle SignalRegistry::handleForID(const QString &uniqueID) const
+{
+    const int slash = uniqueID.lastIndexOf('/');
+    if (slash < 0)
+        return InvalidSignalHandle;
+
+    const int index = m_tablesByPrefix.value(uniqueID.left(slash + 1), -1);
+    if (index < 0)
+        return InvalidSignalHandle;
+
+    bool ok = false;
+    const int column = uniqueID.midRef(slash + 1).toInt(&ok);
+    const TableSlot &slot = m_tables.at(index);
+    if (!ok || column < 0 || column >= slot.count)
+        return InvalidSignalHandle;
+
+    return slot.firstHandle + column;
+}
+
+QString SignalRegistry::tablePrefix(SignalHandle handle) const
+{
+    const int index = tableSlot(handle);
+    return index < 0 ? QString() : m_tables.at(index).prefix;
+}
+
+SignalHandle SignalRegistry::handleForName(const QString &name) const
+{
+    auto it = m_handlesByName.constFind(name);
+    if (it == m_handlesByName.constEnd())
+        return InvalidSignalHandle;
+
+    const QVector<SignalHandle> &handles = it.value();
+    if (m_duplicateNamePolicy == PreferOldestFile)
+        return handles.first();
+
+    // 最近加载的文件句柄最大；再回退到该文件中的第一个同名信号
+    const QString &fileName = m_tables.at(tableSlot(handles.last())).fileName;
+    const SignalHandle fileFirst = m_files.constFind(fileName).value().firstHandle;
+    int i = handles.size() - 1;
+    while (i > 0 && handles.at(i - 1) >= fileFirst)
+        --i;
+    return handles.at(i);
+}
+
+QVector<SignalHandle> SignalRegistry::handlesForName(const QString &name) const
+{
+    return m_handlesByName.value(name);
+}
+
+SignalRegistry::DuplicateNamePolicy SignalRegistry::duplicateNamePolicy() const
+{
+    return m_duplicateNamePolicy;
+}
+
+void SignalRegistry::setDuplicateNamePolicy(DuplicateNamePolicy policy)
+{
+    m_duplicateNamePolicy = policy;
+}
+
+QString SignalRegistry::signalDisplayName(const QStringList &headers, int row)
+{
+    QString name = headers.at(row).trimmed();
+    if (name.isEmpty())
+        name = tr("Signal %1").arg(row + 1);
+    return name;
+}
+
+void SignalRegistry::bindGraph(SignalHandle handle, QCPGraph *graph)
+{
+    if (!graph || !graph->parentPlot())
+        return;
+
+    GraphBinding binding;
+    binding.plot = graph->parentPlot();
+    binding.handle = handle;
+    m_graphBindings.insert(graph, binding);
+    m_plotGraphs[binding.plot].insert(handle, graph);
+
+    connect(graph, &QObject::destroyed, this, &SignalRegistry::onGraphDestroyed, Qt::UniqueConnection);
+}
+
+QCPGraph *SignalRegistry::graph(QCustomPlot *plot, SignalHandle handle) const
+{
+    auto it = m_plotGraphs.constFind(plot);
+    if (it == m_plotGraphs.constEnd())
+        return nullptr;
+    return it.value().value(handle, nullptr);
+}
+
+SignalHandle SignalRegistry::handleOf(const QCPGraph *graph) const
+{
+    auto it = m_graphBindings.constFind(graph);
+    return it == m_graphBindings.constEnd() ? InvalidSignalHandle : it.value().handle;
+}
+
+QList<QCPGraph *> SignalRegistry::graphs(SignalHandle handle) const
+{
+    QList<QCPGraph *> result;
+    for (auto it = m_plotGraphs.constBegin(); it != m_plotGraphs.constEnd(); ++it)
+    {
+        if (QCPGraph *graph = it.value().value(handle, nullptr))
+            result.append(graph);
+    }
+    return result;
+}
+
+/**
+ * @brief [槽] 曲线销毁时解除绑定 (此时对象已析构，只能按指针值查找)
+ */
+void SignalRegistry::onGraphDestroyed(QObject *object)
+{
+    auto it = m_graphBindings.find(object);
+    if (it == m_graphBindings.end())
+        return;
+
+    const GraphBinding binding = it.value();
+    m_graphBindings.erase(it);
+
+    auto plotIt = m_plotGraphs.find(binding.plot);
+    if (plotIt != m_plotGraphs.end())
+    {
+        if (plotIt.value().value(binding.handle) == object)
+            plotIt.value().remove(binding.handle);
+        if (plotIt.value().isEmpty())
+            m_plotGraphs.erase(plotIt);
+    }
+}
+
+int SignalRegistry::tableSlot(SignalHandle handle) const
+{
+    if (handle < 0 || handle >= m_handleTables.size())
+        return -1;
+    return m_handleTables.at(handle);
+}
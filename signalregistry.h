@@ -0,0 +1,148 @@
+#ifndef SIGNALREGISTRY_H
+#define SIGNALREGISTRY_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+#include "datamanager.h"
+
+// 向前声明
+class QCustomPlot;
+class QCPGraph;
+
+/**
+ * @brief 信号句柄：加载期间唯一的整数，文件移除后失效且不再复用
+ */
+typedef int SignalHandle;
+static const SignalHandle InvalidSignalHandle = -1;
+
+/**
+ * @brief 信号注册表
+ * * 文件加载时为每个信号分配一个整数句柄 (同一文件内按表、列顺序连续分配)，
+ * 句柄到数据列、句柄到各子图曲线的查找均为 O(1)，热路径不再拆分或比较字符串。
+ * "filename/tablename/signalindex" 形式的字符串 ID 只在持久化、导入和拖放边界上转换。
+ * 注册表持有 FileData 的共享副本，返回的 SignalTable 指针在文件注销前一直有效。
+ * 另外维护信号名称 -> 句柄的散列索引，随文件注册/注销增量更新，供按名称导入视图使用。
+ */
+class SignalRegistry : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 多个文件中存在同名信号时的选择策略
+     */
+    enum DuplicateNamePolicy
+    {
+        PreferNewestFile = 0, // 最近加载的文件
+        PreferOldestFile      // 最早加载的文件
+    };
+
+    /**
+     * @brief 句柄对应的数据列
+     */
+    struct Location
+    {
+        const SignalTable *table = nullptr;
+        int column = -1;
+    };
+
+    explicit SignalRegistry(QObject *parent = nullptr);
+    ~SignalRegistry();
+
+    /**
+     * @brief 注册一个文件的全部信号
+     * @return 文件第一个信号的句柄 (文件没有信号时也会占用起始位置)
+     */
+    SignalHandle registerFile(const QString &filename, const FileData &data);
+
+    /**
+     * @brief 注销文件，其句柄随即失效 (已绑定的曲线记录由调用方先行移除)
+     */
+    void unregisterFile(const QString &filename);
+
+    /**
+     * @brief 文件的句柄区间 [first, first + count)
+     */
+    bool fileHandles(const QString &filename, SignalHandle *first, int *count) const;
+
+    bool isValid(SignalHandle handle) const;
+    Location location(SignalHandle handle) const;
+
+    // 字符串 ID 转换 (仅用于持久化、导入和拖放)
+    QString uniqueID(SignalHandle handle) const;
+    SignalHandle handleForID(const QString &uniqueID) const;
+    QString tablePrefix(SignalHandle handle) const;
+
+    /**
+     * @brief 按显示名称查找信号，重名时按 duplicateNamePolicy() 选择文件，
+     * 同一文件内取第一个同名信号
+     */
+    SignalHandle handleForName(const QString &name) const;
+    QVector<SignalHandle> handlesForName(const QString &name) const;
+
+    DuplicateNamePolicy duplicateNamePolicy() const;
+    void setDuplicateNamePolicy(DuplicateNamePolicy policy);
+
+    /**
+     * @brief 信号的显示名称 (表头为空时使用 "Signal N")
+     */
+    static QString signalDisplayName(const QStringList &headers, int row);
+
+    /**
+     * @brief 记录曲线对应的信号 (曲线销毁时自动解除)
+     */
+    void bindGraph(SignalHandle handle, QCPGraph *graph);
+    QCPGraph *graph(QCustomPlot *plot, SignalHandle handle) const;
+    SignalHandle handleOf(const QCPGraph *graph) const;
+
+    /**
+     * @brief 信号在所有子图上的曲线
+     */
+    QList<QCPGraph *> graphs(SignalHandle handle) const;
+
+private slots:
+    void onGraphDestroyed(QObject *object);
+
+private:
+    struct TableSlot
+    {
+        QString fileName;
+        QString prefix; // "filename/tablename/"
+        const SignalTable *table;
+        SignalHandle firstHandle;
+        int count;
+    };
+
+    struct FileSlot
+    {
+        FileData data; // 共享副本，保证 SignalTable 指针有效
+        SignalHandle firstHandle;
+        int count;
+        QVector<int> tables;
+    };
+
+    struct GraphBinding
+    {
+        QCustomPlot *plot;
+        SignalHandle handle;
+    };
+
+    int tableSlot(SignalHandle handle) const;
+
+    QHash<QString, FileSlot> m_files;
+    QVector<TableSlot> m_tables;          // 注销的表保留位置 (table 置空)
+    QVector<int> m_handleTables;          // 句柄 -> 表序号，注销后为 -1
+    QHash<QString, int> m_tablesByPrefix; // 表前缀 -> 表序号
+
+    QHash<QString, QVector<SignalHandle>> m_handlesByName; // 显示名称 -> 句柄 (升序，即按加载顺序)
+    DuplicateNamePolicy m_duplicateNamePolicy;
+
+    QHash<QCustomPlot *, QHash<SignalHandle, QCPGraph *>> m_plotGraphs;
+    QHash<const QObject *, GraphBinding> m_graphBindings;
+};
+
+#endif // SIGNALREGISTRY_H
@@ -0,0 +1,228 @@
+#include "signalresampler.h"
+
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QtNumeric>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief [辅助函数] 重采样核心循环，插值方式在编译期确定
+ * * 调用前保证 srcCount > 0；i 为第一个大于当前目标时刻的源样本
+ */
+template <SignalResampler::Interpolation Mode>
+static int resampleRange(const double *srcKeys, const double *srcValues, int srcCount,
+                         const double *dstKeys, double *out, int begin, int end, int i)
+{
+    const double firstKey = srcKeys[0];
+    const double lastKey = srcKeys[srcCount - 1];
+
+    for (int j = begin; j < end; ++j)
+    {
+        const double t = dstKeys[j];
+        while (i < srcCount && srcKeys[i] <= t)
+            ++i;
+
+        // 源时间范围之外 (NaN 比较为 false，同样落在这里)
+        if (!(t >= firstKey && t <= lastKey))
+        {
+            out[j] = qQNaN();
+            continue;
+        }
+
+        const int lo = i - 1;
+        if (Mode == SignalResampler::ZeroOrderHold || i == srcCount || srcKeys[lo] == t)
+        {
+            out[j] = srcValues[lo];
+        }
+        else if (Mode == SignalResampler::Linear)
+        {
+            const double frac = (t - srcKeys[lo]) / (srcKeys[i] - srcKeys[lo]);
+            out[j] = srcValues[lo] + (srcValues[i] - srcValues[lo]) * frac;
+        }
+        else
+        {
+            out[j] = (t - srcKeys[lo] <= srcKeys[i] - t) ? srcValues[lo] : srcValues[i];
+        }
+    }
+    return i;
+}
+
+void SignalResampler::resampleBlock(const double *srcKeys, const double *srcValues, int srcCount,
+                                    const double *dstKeys, double *out, int begin, int end,
+                                    Interpolation interpolation, Cursor &cursor)
+{
+    if (end <= begin)
+        return;
+    if (srcCount <= 0)
+    {
+        std::fill(out + begin, out + end, qQNaN());
+        return;
+    }
+
+    // 游标与本段起点不衔接时 (新的一段或目标轴回退) 二分定位，否则沿用上一段的位置
+    int i = cursor.index;
+    if (i < 0 || i > srcCount || (i > 0 && srcKeys[i - 1] > dstKeys[begin]))
+        i = int(std::upper_bound(srcKeys, srcKeys + srcCount, dstKeys[begin]) - srcKeys);
+
+    switch (interpolation)
+    {
+    case Linear:
+        i = resampleRange<Linear>(srcKeys, srcValues, srcCount, dstKeys, out, begin, end, i);
+        break;
+    case Nearest:
+        i = resampleRange<Nearest>(srcKeys, srcValues, srcCount, dstKeys, out, begin, end, i);
+        break;
+    default:
+        i = resampleRange<ZeroOrderHold>(srcKeys, srcValues, srcCount, dstKeys, out, begin, end, i);
+        break;
+    }
+    cursor.index = i;
+}
+
+QVector<double> SignalResampler::unionAxis(const QVector<QVector<double>> &axes)
+{
+    QVector<double> result;
+    if (axes.size() == 1)
+        return axes.first();
+
+    // 1. 每条轴的当前元素放入小顶堆 (值, 轴序号)
+    typedef std::pair<double, int> HeapEntry;
+    std::vector<HeapEntry> heap;
+    QVector<int> positions(axes.size(), 0);
+    int total = 0;
+    for (int a = 0; a < axes.size(); ++a)
+    {
+        total += axes.at(a).size();
+        if (!axes.at(a).isEmpty())
+            heap.push_back(HeapEntry(axes.at(a).first(), a));
+    }
+    std::make_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+    result.reserve(total);
+
+    // 2. 依次弹出最小值，相同时刻只保留一个
+    while (!heap.empty())
+    {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+        const HeapEntry entry = heap.back();
+        heap.pop_back();
+
+        if (!qIsNaN(entry.first) && (result.isEmpty() || entry.first > result.last()))
+            result.append(entry.first);
+
+        const QVector<double> &axis = axes.at(entry.second);
+        const int next = ++positions[entry.second];
+        if (next < axis.size())
+        {
+            heap.push_back(HeapEntry(axis.at(next), entry.second));
+            std::push_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+        }
+    }
+    return result;
+}
+
+double SignalResampler::gridPointCount(double start, double end, double step)
+{
+    if (!std::isfinite(start) || !std::isfinite(end) || !std::isfinite(step) || !(step > 0) || end < start)
+        return 0;
+
+    // 容差保证 end 恰好落在网格上时被包含
+    return std::floor((end - start) / step + 1e-9) + 1;
+}
+
+int SignalResampler::maxGridPoints(int columnCount)
+{
+    return int(kMaxAllocBytes / sizeof(double) / qMax(1, columnCount));
+}
+
+QVector<double> SignalResampler::uniformGrid(double start, double end, double step)
+{
+    QVector<double> grid;
+    const double count = gridPointCount(start, end, step);
+    if (count <= 0 || count > maxGridPoints(1))
+        return grid;
+
+    // 按下标计算每个时刻，避免累加误差
+    const int n = int(count);
+    grid.resize(n);
+    for (int i = 0; i < n; ++i)
+        grid[i] = start + step * i;
+    return grid;
+}
+
+/**
+ * @brief 一段连续列的重采样任务 (在线程池中运行)
+ * * 各任务只写入自己负责的列，结果向量已预先分配好大小
+ */
+class ResampleJob : public QRunnable
+{
+public:
+    ResampleJob(const QVector<double> &srcKeys, const QVector<QVector<double>> &columns,
+                const QVector<double> &dstKeys, QVector<double> *out,
+                SignalResampler::Interpolation interpolation, int begin, int end)
+        : m_srcKeys(srcKeys),
+          m_columns(columns),
+          m_dstKeys(dstKeys),
+          m_out(out),
+          m_interpolation(interpolation),
+          m_begin(begin),
+          m_end(end)
+    {
+    }
+
+    void run() override
+    {
+        const int dstCount = m_dstKeys.size();
+        for (int c = m_begin; c < m_end; ++c)
+        {
+            const QVector<double> &values = m_columns.at(c);
+            const int srcCount = qMin(m_srcKeys.size(), values.size());
+
+            QVector<double> result(dstCount);
+            SignalResampler::Cursor cursor;
+            for (int start = 0; start < dstCount; start += SignalResampler::kBlockSize)
+            {
+                SignalResampler::resampleBlock(m_srcKeys.constData(), values.constData(), srcCount,
+                                               m_dstKeys.constData(), result.data(),
+                                               start, qMin(dstCount, start + SignalResampler::kBlockSize),
+                                               m_interpolation, cursor);
+            }
+            m_out[c] = result;
+        }
+    }
+
+private:
+    const QVector<double> &m_srcKeys;
+    const QVector<QVector<double>> &m_columns;
+    const QVector<double> &m_dstKeys;
+    QVector<double> *m_out;
+    SignalResampler::Interpolation m_interpolation;
+    int m_begin;
+    int m_end;
+};
+
+QVector<QVector<double>> SignalResampler::resampleColumns(const QVector<double> &srcKeys,
+                                                          const QVector<QVector<double>> &columns,
+                                                          const QVector<double> &dstKeys,
+                                                          Interpolation interpolation)
+{
+    QVector<QVector<double>> result(columns.size());
+    if (columns.isEmpty())
+        return result;
+
+    // 预先分离，任务中只通过裸指针写入
+    QVector<double> *out = result.data();
+
+    QThreadPool pool;
+    const int count = columns.size();
+    const int chunks = qMin(count, qMax(1, QThread::idealThreadCount()));
+    for (int i = 0; i < chunks; ++i)
+        pool.start(new ResampleJob(srcKeys, columns, dstKeys, out, interpolation,
+                                   count * i / chunks, count * (i + 1) / chunks));
+    pool.waitForDone();
+    return result;
+}
@@ -0,0 +1,89 @@
+#ifndef SIGNALRESAMPLER_H
+#define SIGNALRESAMPLER_H
+
+#include <QVector>
+#include <climits>
+
+/**
+ * @brief 不同时间轴上信号的对齐与重采样
+ * * 源时间轴和目标时间轴都是非递减序列，重采样以归并方式同时推进两个游标，
+ * 总开销与两条轴的长度之和成正比。目标轴按 kBlockSize 分块处理，块之间只传递源游标，
+ * 因此可以逐块产出结果；多列之间相互独立，在线程池中并行。
+ * 目标时刻落在源时间范围之外时结果为 NaN。
+ */
+class SignalResampler
+{
+public:
+    static const int kBlockSize = 4096;
+    static const int kMaxAllocBytes = INT_MAX - 64; // Qt5 容器单次分配的上限 (MaxAllocSize 减去头部)
+
+    /**
+     * @brief 插值方式
+     */
+    enum Interpolation
+    {
+        ZeroOrderHold = 0, // 取不晚于目标时刻的最后一个样本
+        Linear,            // 相邻两样本线性插值
+        Nearest            // 时间上最近的样本 (距离相等时取较早的)
+    };
+
+    /**
+     * @brief 目标时间轴
+     */
+    enum AxisMode
+    {
+        UnionAxis = 0, // 所有输入时间轴的并集 (去重)
+        ReferenceAxis, // 指定输入的时间轴
+        UniformGrid    // 公共时间范围内的均匀网格
+    };
+
+    /**
+     * @brief 源游标：目标轴分块推进时在块之间传递
+     */
+    struct Cursor
+    {
+        int index = -1; // 第一个大于当前目标时刻的源样本，-1 表示尚未定位
+    };
+
+    /**
+     * @brief 多条时间轴的并集 (k 路归并，相同时刻只保留一个)
+     */
+    static QVector<double> unionAxis(const QVector<QVector<double>> &axes);
+
+    /**
+     * @brief [start, end] 上步长为 step 的均匀网格的点数
+     * @return 参数无效 (非有限值、step <= 0 或 end < start) 时返回 0；可能超过 maxGridPoints()
+     */
+    static double gridPointCount(double start, double end, double step);
+
+    /**
+     * @brief 网格允许的最大点数
+     * @param columnCount 与网格等长、需要同时存在的列数 (网格本身、各重采样输入和输出)，
+     * 它们共用 kMaxAllocBytes 的内存预算，因此单列也不会超过一次分配的上限
+     */
+    static int maxGridPoints(int columnCount);
+
+    /**
+     * @brief [start, end] 上步长为 step 的均匀网格
+     * * 参数无效或点数超过 maxGridPoints(1) 时返回空网格 (在分配之前判断)
+     */
+    static QVector<double> uniformGrid(double start, double end, double step);
+
+    /**
+     * @brief 重采样目标轴的一段 [begin, end)
+     * @param cursor 上一段结束时的源游标；新的一段从任意位置开始时传入默认值即可 (会先二分定位)
+     */
+    static void resampleBlock(const double *srcKeys, const double *srcValues, int srcCount,
+                              const double *dstKeys, double *out, int begin, int end,
+                              Interpolation interpolation, Cursor &cursor);
+
+    /**
+     * @brief 把共用时间轴 srcKeys 的多列重采样到 dstKeys (按列并行，每列分块推进)
+     */
+    static QVector<QVector<double>> resampleColumns(const QVector<double> &srcKeys,
+                                                    const QVector<QVector<double>> &columns,
+                                                    const QVector<double> &dstKeys,
+                                                    Interpolation interpolation);
+};
+
+#endif // SIGNALRESAMPLER_H
@@ -0,0 +1,47 @@
+#include "signalrowmodel.h"
+
+#include <QtNumeric>
+
+SignalRowModel::SignalRowModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+int SignalRowModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : entryCount();
+}
+
+QVariant SignalRowModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= entryCount())
+        return QVariant();
+
+    const SignalRowEntry &entry = entryAt(index.row());
+    const bool nameColumn = index.column() == 0;
+
+    if (role == Qt::DisplayRole)
+        return nameColumn ? QVariant(entry.name) : valueText(index.row(), index.column());
+    if (role == Qt::ForegroundRole && nameColumn)
+        return entry.color;
+    if (role == Qt::ToolTipRole && nameColumn)
+        return entry.uniqueID;
+    if (role == Qt::TextAlignmentRole && !nameColumn)
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+
+    return QVariant();
+}
+
+void SignalRowModel::emitValuesChanged()
+{
+    const int rows = entryCount();
+    if (rows > 0)
+        emit dataChanged(index(0, 1), index(rows - 1, columnCount() - 1), {Qt::DisplayRole});
+}
+
+QString SignalRowModel::formatValue(double value)
+{
+    if (qIsNaN(value))
+        return QStringLiteral("-");
+    return QString::number(value, 'f', 3);
+}
@@ -0,0 +1,52 @@
+#ifndef SIGNALROWMODEL_H
+#define SIGNALROWMODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+#include <QColor>
+
+/**
+ * @brief 一个已绘制信号的行 (数据向量隐式共享，不额外拷贝)
+ */
+struct SignalRowEntry
+{
+    QString uniqueID;
+    QString name;
+    QColor color;
+    QVector<double> keys;
+    QVector<double> values;
+};
+
+/**
+ * @brief 每行一个信号的只读表模型基类 (游标读数、区间统计)
+ * * 第 0 列为信号名 (信号颜色，提示为信号 ID)，其余列为右对齐的数值；
+ * 数值只在视图请求时由子类格式化，不可见的行没有开销。
+ */
+class SignalRowModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit SignalRowModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+protected:
+    virtual int entryCount() const = 0;
+    virtual const SignalRowEntry &entryAt(int row) const = 0;
+
+    /**
+     * @brief 数值列的显示文本 (column >= 1)
+     */
+    virtual QVariant valueText(int row, int column) const = 0;
+
+    /**
+     * @brief 通知全部数值列变化 (名称列不变)
+     */
+    void emitValuesChanged();
+
+    static QString formatValue(double value);
+};
+
+#endif // SIGNALROWMODEL_H
@@ -0,0 +1,411 @@
+#include "signalsearch.h"
+#include "signalregistry.h"
+#include "latestjobrunner.h"
+
+#include <QRunnable>
+#include <QTimer>
+#include <QRegularExpression>
+#include <QFileInfo>
+#include <algorithm>
+#include <iterator>
+
+/**
+ * @brief [辅助函数] 三个连续字符组成的倒排表键
+ */
+static quint64 trigramKey(const QChar *chars)
+{
+    return (quint64(chars[0].unicode()) << 32) | (quint64(chars[1].unicode()) << 16) | quint64(chars[2].unicode());
+}
+
+/**
+ * @brief [辅助函数] 构建一个文件的名称索引 (在工作线程中运行)
+ */
+static SignalNameIndexPtr buildNameIndex(const QString &fileName, const FileData &data)
+{
+    SignalNameIndex *index = new SignalNameIndex;
+    index->fileName = fileName;
+    index->lowerFileName = fileName.toLower();
+
+    for (const SignalTable &source : data.tables)
+    {
+        SignalNameIndex::Table table;
+        table.prefix = fileName + "/" + source.name + "/";
+        table.lowerName = source.name.toLower();
+        table.firstEntry = index->lowerNames.size();
+        table.count = source.headers.size();
+        index->tables.append(table);
+
+        for (int row = 0; row < table.count; ++row)
+            index->lowerNames.append(SignalRegistry::signalDisplayName(source.headers, row).toLower());
+    }
+
+    for (int entry = 0; entry < index->lowerNames.size(); ++entry)
+    {
+        const QString &name = index->lowerNames.at(entry);
+        for (int i = 0; i + 3 <= name.size(); ++i)
+        {
+            // 序号按升序追加，同一名称中重复的三元组只记录一次
+            QVector<int> &postings = index->trigrams[trigramKey(name.constData() + i)];
+            if (postings.isEmpty() || postings.last() != entry)
+                postings.append(entry);
+        }
+    }
+
+    return SignalNameIndexPtr(index);
+}
+
+/**
+ * @brief 按模式匹配小写名称
+ */
+struct SignalNameMatcher
+{
+    SignalSearch::Mode mode;
+    QString lowerQuery;
+    QRegularExpression regex;
+    QStringList literals; // 用于三元组筛选的字面片段
+
+    bool matches(const QString &lowerName) const
+    {
+        if (mode == SignalSearch::Substring)
+            return lowerName.contains(lowerQuery);
+        return regex.match(lowerName).hasMatch();
+    }
+};
+
+/**
+ * @brief [辅助函数] 把通配符转换为匹配整个名称的正则表达式
+ */
+static QString wildcardToPattern(const QString &wildcard)
+{
+    QString pattern;
+    for (const QChar c : wildcard)
+    {
+        if (c == QLatin1Char('*'))
+            pattern += QLatin1String(".*");
+        else if (c == QLatin1Char('?'))
+            pattern += QLatin1Char('.');
+        else
+            pattern += QRegularExpression::escape(QString(c));
+    }
+    return QLatin1String("^(?:") + pattern + QLatin1String(")$");
+}
+
+/**
+ * @brief [辅助函数] 用字面片段的三元组求候选信号
+ * @return false 表示片段都短于 3 个字符，无法筛选，需要扫描全部名称
+ */
+static bool candidateEntries(const SignalNameIndex &index, const QStringList &literals, QVector<int> *candidates)
+{
+    bool filtered = false;
+    for (const QString &literal : literals)
+    {
+        for (int i = 0; i + 3 <= literal.size(); ++i)
+        {
+            auto it = index.trigrams.constFind(trigramKey(literal.constData() + i));
+            if (it == index.trigrams.constEnd())
+            {
+                candidates->clear(); // 任何名称都不含该三元组
+                return true;
+            }
+
+            if (!filtered)
+            {
+                *candidates = it.value();
+                filtered = true;
+            }
+            else
+            {
+                QVector<int> intersection;
+                intersection.reserve(qMin(candidates->size(), it.value().size()));
+                std::set_intersection(candidates->constBegin(), candidates->constEnd(),
+                                      it.value().constBegin(), it.value().constEnd(),
+                                      std::back_inserter(intersection));
+                candidates->swap(intersection);
+            }
+
+            if (candidates->isEmpty())
+                return true;
+        }
+    }
+    return filtered;
+}
+
+/**
+ * @brief [辅助函数] 在全部文件的索引上执行一次查询
+ */
+static SignalSearchResult evaluateQuery(const QVector<SignalNameIndexPtr> &indexes, const QString &query,
+                                        SignalSearch::Mode mode, int generation)
+{
+    SignalSearchResult result;
+    result.generation = generation;
+    result.active = true;
+
+    SignalNameMatcher matcher;
+    matcher.mode = mode;
+    matcher.lowerQuery = query.toLower();
+    if (mode == SignalSearch::Substring)
+    {
+        matcher.literals << matcher.lowerQuery;
+    }
+    else if (mode == SignalSearch::Wildcard)
+    {
+        matcher.regex.setPattern(wildcardToPattern(matcher.lowerQuery));
+        matcher.literals = matcher.lowerQuery.split(QRegularExpression(QStringLiteral("[*?]")), Qt::SkipEmptyParts);
+    }
+    else
+    {
+        matcher.regex.setPattern(query);
+        matcher.regex.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+        if (!matcher.regex.isValid())
+        {
+            result.error = matcher.regex.errorString();
+            return result;
+        }
+    }
+
+    for (const SignalNameIndexPtr &indexPtr : indexes)
+    {
+        const SignalNameIndex &index = *indexPtr;
+
+        QVector<int> candidates;
+        const bool filtered = candidateEntries(index, matcher.literals, &candidates);
+        int next = 0; // 候选序号升序，各表依次向后推进
+
+        for (const SignalNameIndex::Table &table : index.tables)
+        {
+            const int end = table.firstEntry + table.count;
+            QBitArray rows;
+            int hits = 0;
+
+            for (int entry = table.firstEntry; entry < end; ++entry)
+            {
+                if (filtered)
+                {
+                    if (next >= candidates.size() || candidates.at(next) >= end)
+                        break;
+                    entry = candidates.at(next++);
+                }
+
+                if (!matcher.matches(index.lowerNames.at(entry)))
+                    continue;
+
+                if (rows.isEmpty())
+                    rows = QBitArray(table.count);
+                rows.setBit(entry - table.firstEntry);
+                ++hits;
+            }
+
+            if (hits > 0)
+            {
+                result.rows.insert(table.prefix, rows);
+                result.matchCount += hits;
+            }
+            if (matcher.matches(table.lowerName))
+                result.nodes.insert(table.prefix);
+        }
+
+        if (matcher.matches(index.lowerFileName))
+            result.nodes.insert(index.fileName);
+    }
+
+    return result;
+}
+
+/**
+ * @brief 名称索引构建任务 (在线程池中运行)
+ */
+class SignalIndexBuildJob : public QRunnable
+{
+public:
+    SignalIndexBuildJob(SignalSearch *owner, const QString &fileName, const FileData &data, int buildId)
+        : m_owner(owner),
+          m_fileName(fileName),
+          m_data(data),
+          m_buildId(buildId)
+    {
+    }
+
+    void run() override
+    {
+        emit m_owner->indexBuilt(buildNameIndex(m_fileName, m_data), m_buildId);
+    }
+
+private:
+    SignalSearch *m_owner;
+    QString m_fileName;
+    FileData m_data; // 表数据隐式共享，不额外拷贝
+    int m_buildId;
+};
+
+/**
+ * @brief 查询任务 (在线程池中运行)
+ */
+class SignalSearchJob : public QRunnable
+{
+public:
+    SignalSearchJob(SignalSearch *owner, const QVector<SignalNameIndexPtr> &indexes, const QString &query,
+                    SignalSearch::Mode mode, int generation)
+        : m_owner(owner),
+          m_indexes(indexes),
+          m_query(query),
+          m_mode(mode),
+          m_generation(generation)
+    {
+    }
+
+    void run() override
+    {
+        emit m_owner->jobFinished(evaluateQuery(m_indexes, m_query, m_mode, m_generation));
+    }
+
+private:
+    SignalSearch *m_owner;
+    QVector<SignalNameIndexPtr> m_indexes;
+    QString m_query;
+    SignalSearch::Mode m_mode;
+    int m_generation;
+};
+
+SignalSearch::SignalSearch(QObject *parent)
+    : QObject(parent),
+      m_runner(nullptr),
+      m_debounceTimer(nullptr),
+      m_mode(Substring),
+      m_nextBuildId(0)
+{
+    qRegisterMetaType<SignalSearchResult>("SignalSearchResult");
+    qRegisterMetaType<SignalNameIndexPtr>("SignalNameIndexPtr");
+
+    m_runner = new LatestJobRunner([this](int generation) { return createJob(generation); }, this);
+
+    m_debounceTimer = new QTimer(this);
+    m_debounceTimer->setSingleShot(true);
+    m_debounceTimer->setInterval(200);
+
+    connect(m_debounceTimer, &QTimer::timeout, this, &SignalSearch::submit);
+    connect(this, &SignalSearch::jobFinished, this, &SignalSearch::onJobFinished, Qt::QueuedConnection);
+    connect(this, &SignalSearch::indexBuilt, this, &SignalSearch::onIndexBuilt, Qt::QueuedConnection);
+}
+
+SignalSearch::~SignalSearch()
+{
+    m_runner->cancelAndWait();
+}
+
+void SignalSearch::addFile(const QString &fileName, const FileData &data)
+{
+    if (!m_fileOrder.contains(fileName))
+        m_fileOrder.append(fileName);
+
+    const int buildId = ++m_nextBuildId;
+    m_pendingBuilds.insert(fileName, buildId);
+    m_runner->startUntracked(new SignalIndexBuildJob(this, fileName, data, buildId));
+}
+
+void SignalSearch::removeFile(const QString &fileName)
+{
+    m_fileOrder.removeAll(fileName);
+    m_pendingBuilds.remove(fileName);
+    if (m_indexes.remove(fileName) > 0 && !m_query.isEmpty())
+        submit();
+}
+
+QString SignalSearch::query() const
+{
+    return m_query;
+}
+
+SignalSearch::Mode SignalSearch::mode() const
+{
+    return m_mode;
+}
+
+void SignalSearch::setDebounceInterval(int ms)
+{
+    m_debounceTimer->setInterval(qMax(0, ms));
+}
+
+/**
+ * @brief [槽] 查询文本变化；清空时立即生效，否则等待输入停顿
+ */
+void SignalSearch::setQuery(const QString &text)
+{
+    const QString query = text.trimmed();
+    if (query == m_query)
+        return;
+
+    m_query = query;
+    if (m_query.isEmpty())
+    {
+        submit();
+        return;
+    }
+    m_debounceTimer->start();
+}
+
+void SignalSearch::setMode(Mode mode)
+{
+    if (m_mode == mode)
+        return;
+
+    m_mode = mode;
+    if (!m_query.isEmpty())
+        submit();
+}
+
+/**
+ * @brief [槽] 提交查询任务
+ */
+void SignalSearch::submit()
+{
+    m_debounceTimer->stop();
+
+    if (m_query.isEmpty())
+    {
+        // 清空查询无需工作线程，正在运行的任务结果将作为过期结果丢弃
+        m_runner->invalidate();
+        emit resultReady(SignalSearchResult());
+        return;
+    }
+
+    m_runner->request();
+}
+
+/**
+ * @brief [辅助] 按当前查询和文件顺序创建查询任务
+ */
+QRunnable *SignalSearch::createJob(int generation)
+{
+    QVector<SignalNameIndexPtr> indexes;
+    for (const QString &fileName : m_fileOrder)
+    {
+        SignalNameIndexPtr index = m_indexes.value(fileName);
+        if (index)
+            indexes.append(index);
+    }
+    return new SignalSearchJob(this, indexes, m_query, m_mode, generation);
+}
+
+/**
+ * @brief [槽] 接收查询结果，只转发最新一次查询的结果
+ */
+void SignalSearch::onJobFinished(const SignalSearchResult &result)
+{
+    if (m_runner->isLatest(result.generation))
+        emit resultReady(result);
+}
+
+/**
+ * @brief [槽] 索引构建完成；文件已被移除或重新加载时丢弃
+ */
+void SignalSearch::onIndexBuilt(const SignalNameIndexPtr &index, int buildId)
+{
+    if (!index || m_pendingBuilds.value(index->fileName, -1) != buildId)
+        return;
+
+    m_pendingBuilds.remove(index->fileName);
+    m_indexes.insert(index->fileName, index);
+
+    if (!m_query.isEmpty())
+        submit();
+}
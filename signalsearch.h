@@ -0,0 +1,129 @@
+#ifndef SIGNALSEARCH_H
+#define SIGNALSEARCH_H
+
+#include <QObject>
+#include <QBitArray>
+#include <QHash>
+#include <QSet>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
+#include <QMetaType>
+
+#include "datamanager.h"
+
+// 向前声明
+class LatestJobRunner;
+class QRunnable;
+class QTimer;
+
+/**
+ * @brief 一个文件的信号名称索引
+ * * 加载文件时在线程池中构建，构建完成后只读，可在查询任务之间共享。
+ * 名称统一转为小写；三元组倒排表只保存信号序号 (升序)，用于包含/通配符查询的候选筛选。
+ */
+struct SignalNameIndex
+{
+    struct Table
+    {
+        QString prefix;    // "filename/tablename/"
+        QString lowerName; // 表名 (小写)
+        int firstEntry;    // 第一个信号在 lowerNames 中的序号
+        int count;
+    };
+
+    QString fileName;
+    QString lowerFileName;
+    QVector<Table> tables;
+    QVector<QString> lowerNames;           // 每个信号一项，按表顺序排列
+    QHash<quint64, QVector<int>> trigrams; // 三元组 -> 包含它的信号序号
+};
+
+/**
+ * @brief 一次查询的结果 (工作线程 -> GUI 线程)
+ */
+struct SignalSearchResult
+{
+    int generation = 0;
+    bool active = false; // 查询文本非空
+    QString error;       // 正则表达式无效时的说明
+    int matchCount = 0;
+    QHash<QString, QBitArray> rows; // 表前缀 -> 匹配的信号行 (只包含有匹配的表)
+    QSet<QString> nodes;            // 名称本身匹配的文件名 / 表前缀
+};
+Q_DECLARE_METATYPE(SignalSearchResult)
+
+typedef QSharedPointer<const SignalNameIndex> SignalNameIndexPtr;
+Q_DECLARE_METATYPE(SignalNameIndexPtr)
+
+/**
+ * @brief 信号名称搜索
+ * * 每个文件加载后构建一次名称索引；查询文本变化经过防抖后提交到工作线程，
+ * 结果以 resultReady 送回 GUI 线程，由调用方只把可见性的变化应用到视图。
+ * 查询任务由 LatestJobRunner 调度，同一时刻最多一个，运行期间的新查询只保留最后一次；
+ * 索引构建与查询在同一工作线程中依次执行。
+ */
+class SignalSearch : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Mode
+    {
+        Substring = 0, // 名称包含查询文本
+        Wildcard,      // 整个名称匹配通配符 (* 和 ?)
+        Regex          // 名称中包含正则表达式的匹配
+    };
+
+    explicit SignalSearch(QObject *parent = nullptr);
+    ~SignalSearch();
+
+    /**
+     * @brief 为新加载的文件构建索引 (异步，完成后按当前查询重新搜索)
+     */
+    void addFile(const QString &fileName, const FileData &data);
+    void removeFile(const QString &fileName);
+
+    QString query() const;
+    Mode mode() const;
+
+    /**
+     * @brief 防抖间隔 (毫秒)，最后一次输入后经过该时间才提交查询
+     */
+    void setDebounceInterval(int ms);
+
+public slots:
+    void setQuery(const QString &text);
+    void setMode(Mode mode);
+
+signals:
+    /**
+     * @brief [信号] 查询结果 (已过滤掉过期的结果)
+     */
+    void resultReady(const SignalSearchResult &result);
+
+    // 工作线程 -> GUI 线程 (排队连接)
+    void jobFinished(const SignalSearchResult &result);
+    void indexBuilt(const SignalNameIndexPtr &index, int buildId);
+
+private slots:
+    void submit();
+    void onJobFinished(const SignalSearchResult &result);
+    void onIndexBuilt(const SignalNameIndexPtr &index, int buildId);
+
+private:
+    QRunnable *createJob(int generation);
+
+    LatestJobRunner *m_runner;
+    QTimer *m_debounceTimer;
+
+    QString m_query;
+    Mode m_mode;
+
+    QHash<QString, SignalNameIndexPtr> m_indexes; // 文件名 -> 索引
+    QStringList m_fileOrder;                      // 与信号树中的文件顺序一致
+    QHash<QString, int> m_pendingBuilds;          // 文件名 -> 正在构建的任务编号
+    int m_nextBuildId;
+};
+
+#endif // SIGNALSEARCH_H
@@ -0,0 +1,178 @@
+#include "signalstats.h"
+
+#include <QCoreApplication>
+#include <QStringList>
+#include <QtNumeric>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief [辅助函数] 格式化一个数值，NaN 显示为 "-"
+ */
+static QString formatStat(double value)
+{
+    return qIsNaN(value) ? QStringLiteral("-") : QString::number(value, 'g', 6);
+}
+
+SignalStats::SignalStats()
+    : min(qQNaN()),
+      max(qQNaN()),
+      mean(qQNaN()),
+      stddev(qQNaN())
+{
+}
+
+SignalStats SignalStats::compute(const QVector<double> &values)
+{
+    SignalStats stats;
+    stats.sampleCount = values.size();
+
+    const double *src = values.constData();
+    const int n = values.size();
+    int finiteCount = 0;
+    double lo = 0;
+    double hi = 0;
+    double mean = 0;
+    double m2 = 0;
+    double prev = 0;
+    bool increasing = true;
+    bool decreasing = true;
+
+    for (int i = 0; i < n; ++i)
+    {
+        const double v = src[i];
+        if (qIsNaN(v))
+        {
+            ++stats.nanCount;
+            continue;
+        }
+        if (qIsInf(v))
+        {
+            ++stats.infCount;
+            continue;
+        }
+
+        if (finiteCount == 0)
+        {
+            lo = v;
+            hi = v;
+        }
+        else
+        {
+            lo = qMin(lo, v);
+            hi = qMax(hi, v);
+            increasing = increasing && v >= prev;
+            decreasing = decreasing && v <= prev;
+        }
+        prev = v;
+
+        ++finiteCount;
+        const double delta = v - mean;
+        mean += delta / finiteCount;
+        m2 += delta * (v - mean);
+    }
+
+    if (finiteCount == 0)
+        return stats;
+
+    stats.min = lo;
+    stats.max = hi;
+    stats.mean = mean;
+    stats.stddev = finiteCount > 1 ? std::sqrt(m2 / (finiteCount - 1)) : 0.0;
+    if (increasing && decreasing)
+        stats.monotonicity = Constant;
+    else if (increasing)
+        stats.monotonicity = NonDecreasing;
+    else if (decreasing)
+        stats.monotonicity = NonIncreasing;
+    return stats;
+}
+
+QString SignalStats::toolTip() const
+{
+    static const char *const monotonicityNames[] = {
+        QT_TRANSLATE_NOOP("SignalStats", "否"),
+        QT_TRANSLATE_NOOP("SignalStats", "常量"),
+        QT_TRANSLATE_NOOP("SignalStats", "单调不减"),
+        QT_TRANSLATE_NOOP("SignalStats", "单调不增")};
+
+    QStringList lines;
+    lines << QCoreApplication::translate("SignalStats", "样本数: %1").arg(sampleCount)
+          << QCoreApplication::translate("SignalStats", "最小值: %1  最大值: %2").arg(formatStat(min), formatStat(max))
+          << QCoreApplication::translate("SignalStats", "均值: %1  标准差: %2").arg(formatStat(mean), formatStat(stddev))
+          << QCoreApplication::translate("SignalStats", "NaN: %1  Inf: %2").arg(nanCount).arg(infCount)
+          << QCoreApplication::translate("SignalStats", "单调性: %1").arg(QCoreApplication::translate("SignalStats", monotonicityNames[monotonicity]));
+    return lines.join(QLatin1Char('\n'));
+}
+
+TableStats::TableStats()
+    : timeMin(qQNaN()),
+      timeMax(qQNaN()),
+      minDt(qQNaN()),
+      medianDt(qQNaN())
+{
+}
+
+TableStats TableStats::compute(const QVector<double> &timeData)
+{
+    TableStats stats;
+    stats.sampleCount = timeData.size();
+    if (timeData.isEmpty())
+        return stats;
+
+    const double *src = timeData.constData();
+    const int n = timeData.size();
+    double lo = src[0];
+    double hi = src[0];
+    double minDt = qQNaN();
+
+    QVector<double> steps;
+    steps.reserve(n - 1);
+    for (int i = 1; i < n; ++i)
+    {
+        lo = std::fmin(lo, src[i]);
+        hi = std::fmax(hi, src[i]);
+
+        const double dt = src[i] - src[i - 1];
+        if (dt < 0)
+            stats.timeMonotonic = false;
+        if (dt > 0 && !(dt >= minDt))
+            minDt = dt;
+        if (!qIsNaN(dt))
+            steps.append(dt);
+    }
+
+    stats.timeMin = lo;
+    stats.timeMax = hi;
+    stats.minDt = minDt;
+    if (!steps.isEmpty())
+    {
+        // 中位数只需部分排序，O(n)
+        auto middle = steps.begin() + steps.size() / 2;
+        std::nth_element(steps.begin(), middle, steps.end());
+        stats.medianDt = *middle;
+    }
+    return stats;
+}
+
+void TableStats::merge(const TableStats &other)
+{
+    // 只有一个表时保留其中位数，多个表的中位数无法由各自的中位数合并
+    medianDt = sampleCount == 0 ? other.medianDt : qQNaN();
+    sampleCount += other.sampleCount;
+    // std::fmin/fmax 会忽略 NaN 操作数
+    timeMin = std::fmin(timeMin, other.timeMin);
+    timeMax = std::fmax(timeMax, other.timeMax);
+    minDt = std::fmin(minDt, other.minDt);
+    timeMonotonic = timeMonotonic && other.timeMonotonic;
+}
+
+QString TableStats::toolTip() const
+{
+    QStringList lines;
+    lines << QCoreApplication::translate("TableStats", "样本数: %1").arg(sampleCount)
+          << QCoreApplication::translate("TableStats", "时间范围: %1 ~ %2").arg(formatStat(timeMin), formatStat(timeMax))
+          << QCoreApplication::translate("TableStats", "步长: 最小 %1  中位数 %2").arg(formatStat(minDt), formatStat(medianDt))
+          << QCoreApplication::translate("TableStats", "时间单调: %1").arg(timeMonotonic ? QCoreApplication::translate("TableStats", "是") : QCoreApplication::translate("TableStats", "否 (已按时间排序)"));
+    return lines.join(QLatin1Char('\n'));
+}
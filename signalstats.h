@@ -0,0 +1,73 @@
+#ifndef SIGNALSTATS_H
+#define SIGNALSTATS_H
+
+#include <QVector>
+#include <QString>
+#include <QMetaType>
+
+/**
+ * @brief 一个信号 (数值列) 的统计信息
+ * * 加载时在工作线程中计算一次，之后只读。min/max/mean/stddev 只统计有限值，
+ * 没有有限值时为 NaN。
+ */
+struct SignalStats
+{
+    enum Monotonicity
+    {
+        NotMonotonic = 0,
+        Constant,      // 所有有限值相等
+        NonDecreasing, // 单调不减
+        NonIncreasing  // 单调不增
+    };
+
+    int sampleCount = 0;
+    int nanCount = 0;
+    int infCount = 0;
+    double min;
+    double max;
+    double mean;
+    double stddev;
+    Monotonicity monotonicity = NotMonotonic; // 忽略 NaN/Inf 后的单调性
+
+    SignalStats();
+
+    /**
+     * @brief 单次遍历计算统计量 (均值和方差使用 Welford 算法)
+     */
+    static SignalStats compute(const QVector<double> &values);
+
+    /**
+     * @brief 多行文本，用于提示
+     */
+    QString toolTip() const;
+};
+
+/**
+ * @brief 一个表 (或整个文件) 的时间轴统计信息
+ * * 文件级记录由各表的记录合并而来，时间范围和最小步长查询因此只需遍历文件。
+ */
+struct TableStats
+{
+    int sampleCount = 0;
+    double timeMin; // 时间轴最小/最大值 (无数据时为 NaN)
+    double timeMax;
+    double minDt;    // 最小正步长 (没有正步长时为 NaN)
+    double medianDt; // 步长中位数 (合并了多个表的记录不提供，为 NaN)
+    bool timeMonotonic = true; // 源数据的时间轴单调不减 (不单调的表加载时已按时间排序)
+
+    TableStats();
+
+    static TableStats compute(const QVector<double> &timeData);
+
+    /**
+     * @brief 合并另一个表的记录
+     */
+    void merge(const TableStats &other);
+
+    QString toolTip() const;
+};
+
+Q_DECLARE_METATYPE(SignalStats)
+Q_DECLARE_METATYPE(TableStats)
+
+#endif // SIGNALSTATS_H
@@ -1,5 +1,6 @@
 #include "signaltreedelegate.h"
-#include "mainwindow.h"
+#include "signaltreemodel.h"
+#include "sparklinecache.h"
 
 #include <QPainter>
 #include <QPen>
@@ -7,10 +8,16 @@
 #include <QApplication>
 
 SignalTreeDelegate::SignalTreeDelegate(QObject *parent)
-    : QStyledItemDelegate(parent)
+    : QStyledItemDelegate(parent),
+      m_sparklineCache(nullptr)
 {
 }
 
+void SignalTreeDelegate::setSparklineCache(SparklineCache *cache)
+{
+    m_sparklineCache = cache;
+}
+
 void SignalTreeDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
                                const QModelIndex &index) const
 {
@@ -45,16 +52,62 @@ void SignalTreeDelegate::paint(QPainter *painter, const QStyleOptionViewItem &op
         {
             QPen linePen = penData.value<QPen>();
 
+            // 只有可见行会走到这里：缓存未命中时登记计算，结果就绪后视图重绘
+            Sparkline sparkline;
+            bool hasSparkline = false;
+            if (m_sparklineCache)
+            {
+                const int handle = index.data(TreeItemRoles::SignalHandleRole).toInt();
+                hasSparkline = m_sparklineCache->sparkline(handle, &sparkline);
+                if (!hasSparkline)
+                    m_sparklineCache->request(handle);
+            }
+
             painter->save();
-            painter->setPen(linePen);
 
-            // 设置抗锯齿让线条更好看
-            painter->setRenderHint(QPainter::Antialiasing);
+            if (hasSparkline)
+            {
+                // 每列一段竖线 (min -> max)，并延伸到上一列的范围以保持连续
+                linePen.setWidth(1);
+                painter->setPen(linePen);
+
+                const QRect area = previewRect.adjusted(margin, margin, -margin, -margin);
+                const int columns = sparkline.lo.size();
+                QVector<QLine> lines;
+                lines.reserve(columns);
+                int prevTop = -1;
+                int prevBottom = -1;
+                for (int c = 0; c < columns; ++c)
+                {
+                    if (sparkline.lo.at(c) > sparkline.hi.at(c))
+                    {
+                        prevTop = -1;
+                        continue;
+                    }
+
+                    const int x = area.left() + c * area.width() / columns;
+                    const int top = area.bottom() - sparkline.hi.at(c) * (area.height() - 1) / 255;
+                    const int bottom = area.bottom() - sparkline.lo.at(c) * (area.height() - 1) / 255;
+                    const int spanTop = prevTop >= 0 ? qMin(top, prevBottom) : top;
+                    const int spanBottom = prevTop >= 0 ? qMax(bottom, prevTop) : bottom;
+                    lines.append(QLine(x, spanTop, x, spanBottom));
+                    prevTop = top;
+                    prevBottom = bottom;
+                }
+                painter->drawLines(lines);
+            }
+            else
+            {
+                painter->setPen(linePen);
+
+                // 设置抗锯齿让线条更好看
+                painter->setRenderHint(QPainter::Antialiasing);
 
-            // 在矩形中间绘制一条水平线
-            int y = previewRect.center().y();
-            // 左右各留一点边距
-            painter->drawLine(previewRect.left() + margin, y, previewRect.right() - margin, y);
+                // 在矩形中间绘制一条水平线
+                int y = previewRect.center().y();
+                // 左右各留一点边距
+                painter->drawLine(previewRect.left() + margin, y, previewRect.right() - margin, y);
+            }
 
             painter->restore();
         }
@@ -3,10 +3,13 @@
 
 #include <QStyledItemDelegate>
 
+class SparklineCache;
+
 /**
  * @brief 自定义委托，用于在 QTreeView 的条目右侧绘制信号预览线
  * * 遵循 readme.md 中 2.1 节关于属性编辑器的精神，
  * 但作为第一步在条目中直接提供只读预览。
+ * 设置缩略图缓存后绘制信号的 min/max 缩略图；缓存中尚无结果时先画水平线并登记计算。
  */
 class SignalTreeDelegate : public QStyledItemDelegate
 {
@@ -15,9 +18,14 @@ class SignalTreeDelegate : public QStyledItemDelegate
 public:
     explicit SignalTreeDelegate(QObject *parent = nullptr);
 
+    void setSparklineCache(SparklineCache *cache);
+
     // 重新实现 paint 来绘制自定义预览
     void paint(QPainter *painter, const QStyleOptionViewItem &option,
                const QModelIndex &index) const override;
+
+private:
+    SparklineCache *m_sparklineCache;
 };
 
 #endif // SIGNALTREEDELEGATE_H
\ No newline at end of file
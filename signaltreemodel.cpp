@@ -0,0 +1,586 @@
+#include "signaltreemodel.h"
+
+#include <QFileInfo>
+
+// 每次向视图追加的信号行数
+static const int kFetchBatchSize = 1000;
+
+SignalTreeModel::SignalTreeModel(QObject *parent)
+    : QAbstractItemModel(parent)
+{
+}
+
+SignalTreeModel::~SignalTreeModel()
+{
+    for (FileNode *file : m_files)
+    {
+        qDeleteAll(file->tables);
+        delete file;
+    }
+}
+
+QModelIndex SignalTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (column != 0 || row < 0 || row >= rowCount(parent))
+        return QModelIndex();
+
+    if (!parent.isValid())
+        return createIndex(row, 0, nullptr); // 文件节点
+
+    if (TableNode *table = childTable(parent))
+        return signalIndex(table, row);
+
+    FileNode *file = fileForIndex(parent);
+    if (file)
+        return createIndex(row, 0, static_cast<Node *>(file)); // 表节点
+
+    return QModelIndex();
+}
+
+QModelIndex SignalTreeModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid())
+        return QModelIndex();
+
+    Node *node = static_cast<Node *>(child.internalPointer());
+    if (!node)
+        return QModelIndex();
+
+    if (node->isFile)
+        return fileIndex(static_cast<FileNode *>(node));
+
+    TableNode *table = static_cast<TableNode *>(node);
+    if (table->file->flat)
+        return fileIndex(table->file);
+    return createIndex(table->tableIndex, 0, static_cast<Node *>(table->file));
+}
+
+int SignalTreeModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+        return m_files.size();
+    if (parent.column() != 0)
+        return 0;
+
+    if (TableNode *table = childTable(parent))
+        return table->fetchedCount;
+    if (FileNode *file = fileForIndex(parent))
+        return file->tables.size();
+    return 0;
+}
+
+int SignalTreeModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return 1;
+}
+
+bool SignalTreeModel::hasChildren(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+        return !m_files.isEmpty();
+
+    // 未加载的行也算作子项，视图才会显示展开箭头
+    if (TableNode *table = childTable(parent))
+        return table->signalCount > 0;
+    if (FileNode *file = fileForIndex(parent))
+        return !file->tables.isEmpty();
+    return false;
+}
+
+QVariant SignalTreeModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    if (TableNode *table = signalTable(index))
+    {
+        const int row = index.row();
+        switch (role)
+        {
+        case Qt::DisplayRole:
+            return SignalRegistry::signalDisplayName(table->headers, row);
+        case Qt::CheckStateRole:
+            return table->checked.testBit(row) ? Qt::Checked : Qt::Unchecked;
+        case UniqueIdRole:
+            return table->idPrefix + QString::number(row);
+        case SignalHandleRole:
+            return table->firstHandle + row;
+        case PenDataRole:
+            return QVariant::fromValue(table->customPens.value(row, defaultPen(table, row)));
+        case Qt::ToolTipRole:
+            // 统计信息在加载时已算好，这里只格式化
+            return row < table->signalStats.size() ? table->signalStats.at(row).toolTip() : QVariant();
+        case FileNameRole:
+            return table->file->name;
+        case IsFileItemRole:
+            return false;
+        case IsSignalItemRole:
+            return true;
+        default:
+            return QVariant();
+        }
+    }
+
+    if (TableNode *table = tableForIndex(index))
+    {
+        switch (role)
+        {
+        case Qt::DisplayRole:
+            return table->name;
+        case Qt::ToolTipRole:
+            return table->stats.toolTip();
+        case FileNameRole:
+            return table->file->name;
+        case IsFileItemRole:
+        case IsSignalItemRole:
+            return false;
+        default:
+            return QVariant();
+        }
+    }
+
+    if (FileNode *file = fileForIndex(index))
+    {
+        switch (role)
+        {
+        case Qt::DisplayRole:
+        case FileNameRole:
+            return file->name;
+        case Qt::ToolTipRole:
+            return file->stats.toolTip();
+        case IsFileItemRole:
+            return true;
+        case IsSignalItemRole:
+            return false;
+        default:
+            return QVariant();
+        }
+    }
+
+    return QVariant();
+}
+
+bool SignalTreeModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    TableNode *table = signalTable(index);
+    if (!table)
+        return false;
+
+    const int row = index.row();
+    if (role == Qt::CheckStateRole)
+    {
+        const bool checked = (static_cast<Qt::CheckState>(value.toInt()) == Qt::Checked);
+        if (table->checked.testBit(row) == checked)
+            return true;
+
+        table->checked.setBit(row, checked);
+        emit dataChanged(index, index, QVector<int>() << Qt::CheckStateRole);
+        emit signalCheckChanged(table->firstHandle + row, checked);
+        return true;
+    }
+
+    if (role == PenDataRole)
+    {
+        table->customPens.insert(row, value.value<QPen>());
+        emit dataChanged(index, index, QVector<int>() << PenDataRole);
+        return true;
+    }
+
+    return false;
+}
+
+Qt::ItemFlags SignalTreeModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return Qt::NoItemFlags;
+
+    Qt::ItemFlags itemFlags = Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsDragEnabled;
+    if (signalTable(index))
+        itemFlags |= Qt::ItemIsUserCheckable;
+    return itemFlags;
+}
+
+/**
+ * @brief 拖放编码的数据
+ * * 默认实现只包含 Qt::UserRole 以下的角色，这里补上拖放解码所需的自定义角色
+ */
+QMap<int, QVariant> SignalTreeModel::itemData(const QModelIndex &index) const
+{
+    QMap<int, QVariant> roles;
+    if (!index.isValid())
+        return roles;
+
+    roles.insert(Qt::DisplayRole, data(index, Qt::DisplayRole));
+    roles.insert(IsSignalItemRole, data(index, IsSignalItemRole));
+    roles.insert(IsFileItemRole, data(index, IsFileItemRole));
+    roles.insert(FileNameRole, data(index, FileNameRole));
+    if (signalTable(index))
+    {
+        roles.insert(UniqueIdRole, data(index, UniqueIdRole));
+        roles.insert(SignalHandleRole, data(index, SignalHandleRole));
+    }
+    return roles;
+}
+
+bool SignalTreeModel::canFetchMore(const QModelIndex &parent) const
+{
+    TableNode *table = childTable(parent);
+    return table && table->fetchedCount < table->signalCount;
+}
+
+void SignalTreeModel::fetchMore(const QModelIndex &parent)
+{
+    if (TableNode *table = childTable(parent))
+        fetchRows(table, table->fetchedCount + kFetchBatchSize);
+}
+
+void SignalTreeModel::setColorList(const QVector<QColor> &colors)
+{
+    m_colors = colors;
+}
+
+int SignalTreeModel::addFile(const QString &filename, const FileData &data, SignalHandle firstHandle, int colorBase)
+{
+    FileNode *file = new FileNode;
+    file->isFile = true;
+    file->name = filename;
+    // 如果只有一个表，并且其名称与文件名相同，则跳过创建表节点
+    file->flat = (data.tables.size() == 1 && data.tables.first().name == QFileInfo(filename).completeBaseName());
+    file->stats = data.stats;
+
+    int signalTotal = 0;
+    for (int t = 0; t < data.tables.size(); ++t)
+    {
+        const SignalTable &source = data.tables.at(t);
+
+        TableNode *table = new TableNode;
+        table->isFile = false;
+        table->file = file;
+        table->tableIndex = t;
+        table->name = source.name;
+        table->idPrefix = filename + "/" + source.name + "/";
+        table->firstHandle = firstHandle + signalTotal;
+        table->headers = source.headers;
+        table->signalCount = source.headers.size();
+        table->fetchedCount = qMin(table->signalCount, kFetchBatchSize);
+        table->colorBase = colorBase + signalTotal;
+        table->checked = QBitArray(table->signalCount);
+        table->stats = source.stats;
+        table->signalStats = source.signalStats;
+        file->tables.append(table);
+
+        if (table->signalCount > 0)
+            m_tablesByHandle.insert(table->firstHandle, table);
+        signalTotal += table->signalCount;
+    }
+
+    beginInsertRows(QModelIndex(), m_files.size(), m_files.size());
+    m_files.append(file);
+    endInsertRows();
+
+    return signalTotal;
+}
+
+void SignalTreeModel::removeFile(const QString &filename)
+{
+    for (int row = 0; row < m_files.size(); ++row)
+    {
+        FileNode *file = m_files.at(row);
+        if (file->name != filename)
+            continue;
+
+        beginRemoveRows(QModelIndex(), row, row);
+        m_files.remove(row);
+        for (TableNode *table : file->tables)
+        {
+            if (m_tablesByHandle.value(table->firstHandle) == table)
+                m_tablesByHandle.remove(table->firstHandle);
+        }
+        endRemoveRows();
+
+        qDeleteAll(file->tables);
+        delete file;
+        return;
+    }
+}
+
+bool SignalTreeModel::contains(SignalHandle handle) const
+{
+    int row = -1;
+    return locate(handle, &row) != nullptr;
+}
+
+QString SignalTreeModel::signalName(SignalHandle handle) const
+{
+    int row = -1;
+    TableNode *table = locate(handle, &row);
+    return table ? SignalRegistry::signalDisplayName(table->headers, row) : QString();
+}
+
+QPen SignalTreeModel::signalPen(SignalHandle handle) const
+{
+    int row = -1;
+    TableNode *table = locate(handle, &row);
+    if (!table)
+        return QPen();
+    return table->customPens.value(row, defaultPen(table, row));
+}
+
+void SignalTreeModel::setSignalPen(SignalHandle handle, const QPen &pen)
+{
+    int row = -1;
+    TableNode *table = locate(handle, &row);
+    if (!table)
+        return;
+
+    table->customPens.insert(row, pen);
+    emitRowsChanged(table, row, row, QVector<int>() << PenDataRole);
+}
+
+bool SignalTreeModel::isChecked(SignalHandle handle) const
+{
+    int row = -1;
+    TableNode *table = locate(handle, &row);
+    return table && table->checked.testBit(row);
+}
+
+void SignalTreeModel::setChecked(SignalHandle handle, bool checked, bool notify)
+{
+    int row = -1;
+    TableNode *table = locate(handle, &row);
+    if (!table || table->checked.testBit(row) == checked)
+        return;
+
+    table->checked.setBit(row, checked);
+    emitRowsChanged(table, row, row, QVector<int>() << Qt::CheckStateRole);
+    if (notify)
+        emit signalCheckChanged(handle, checked);
+}
+
+void SignalTreeModel::setCheckedSignals(const QSet<SignalHandle> &handles)
+{
+    // 1. 按表构建新的位数组
+    QHash<TableNode *, QBitArray> wanted;
+    for (SignalHandle handle : handles)
+    {
+        int row = -1;
+        TableNode *table = locate(handle, &row);
+        if (!table)
+            continue;
+
+        QBitArray &bits = wanted[table];
+        if (bits.isEmpty())
+            bits = QBitArray(table->signalCount);
+        bits.setBit(row);
+    }
+
+    // 2. 与当前状态比较，每个表只为变化的区间发出一次 dataChanged
+    const QVector<int> roles = QVector<int>() << Qt::CheckStateRole;
+    for (FileNode *file : m_files)
+    {
+        for (TableNode *table : file->tables)
+        {
+            QBitArray bits = wanted.value(table, QBitArray(table->signalCount));
+            if (bits == table->checked)
+                continue;
+
+            int first = -1;
+            int last = -1;
+            for (int row = 0; row < table->signalCount; ++row)
+            {
+                if (bits.testBit(row) != table->checked.testBit(row))
+                {
+                    if (first < 0)
+                        first = row;
+                    last = row;
+                }
+            }
+
+            table->checked = bits;
+            emitRowsChanged(table, first, last, roles);
+        }
+    }
+}
+
+QModelIndex SignalTreeModel::indexForHandle(SignalHandle handle, bool fetch)
+{
+    int row = -1;
+    TableNode *table = locate(handle, &row);
+    if (!table)
+        return QModelIndex();
+
+    if (row >= table->fetchedCount)
+    {
+        if (!fetch)
+            return QModelIndex();
+        // 取整到批次边界，避免逐行插入
+        fetchRows(table, (row / kFetchBatchSize + 1) * kFetchBatchSize);
+    }
+    return signalIndex(table, row);
+}
+
+QVector<SignalHandle> SignalTreeModel::signalHandles(const QModelIndex &node) const
+{
+    QVector<TableNode *> tables;
+    if (TableNode *table = childTable(node))
+        tables << table;
+    else if (FileNode *file = fileForIndex(node))
+        tables = file->tables;
+
+    QVector<SignalHandle> handles;
+    for (TableNode *table : tables)
+    {
+        for (int row = 0; row < table->signalCount; ++row)
+            handles << table->firstHandle + row;
+    }
+    return handles;
+}
+
+void SignalTreeModel::fetchUpTo(const QModelIndex &parent, int row)
+{
+    TableNode *table = childTable(parent);
+    if (table && row >= table->fetchedCount)
+        fetchRows(table, (row / kFetchBatchSize + 1) * kFetchBatchSize);
+}
+
+void SignalTreeModel::fetchAll()
+{
+    for (FileNode *file : m_files)
+    {
+        for (TableNode *table : file->tables)
+            fetchRows(table, table->signalCount);
+    }
+}
+
+/**
+ * @brief [辅助] 表节点 (父节点为文件) 对应的表
+ */
+SignalTreeModel::TableNode *SignalTreeModel::tableForIndex(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return nullptr;
+
+    Node *node = static_cast<Node *>(index.internalPointer());
+    if (!node || !node->isFile)
+        return nullptr;
+
+    FileNode *file = static_cast<FileNode *>(node);
+    if (file->flat || index.row() >= file->tables.size())
+        return nullptr;
+    return file->tables.at(index.row());
+}
+
+/**
+ * @brief [辅助] 文件节点 (顶层) 对应的文件
+ */
+SignalTreeModel::FileNode *SignalTreeModel::fileForIndex(const QModelIndex &index) const
+{
+    if (!index.isValid() || index.internalPointer() || index.row() >= m_files.size())
+        return nullptr;
+    return m_files.at(index.row());
+}
+
+/**
+ * @brief [辅助] 信号节点所属的表 (不是信号节点时返回 nullptr)
+ */
+SignalTreeModel::TableNode *SignalTreeModel::signalTable(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return nullptr;
+
+    Node *node = static_cast<Node *>(index.internalPointer());
+    if (!node || node->isFile)
+        return nullptr;
+    return static_cast<TableNode *>(node);
+}
+
+/**
+ * @brief [辅助] 子项为信号的表 (表节点本身，或扁平文件节点的唯一表)
+ */
+SignalTreeModel::TableNode *SignalTreeModel::childTable(const QModelIndex &parent) const
+{
+    if (TableNode *table = tableForIndex(parent))
+        return table;
+
+    FileNode *file = fileForIndex(parent);
+    if (file && file->flat)
+        return file->tables.first();
+    return nullptr;
+}
+
+QModelIndex SignalTreeModel::fileIndex(FileNode *file) const
+{
+    const int row = m_files.indexOf(file);
+    return row < 0 ? QModelIndex() : createIndex(row, 0, nullptr);
+}
+
+QModelIndex SignalTreeModel::signalIndex(TableNode *table, int row) const
+{
+    return createIndex(row, 0, static_cast<Node *>(table));
+}
+
+/**
+ * @brief [辅助] 句柄所在的表 (按表第 0 列的句柄二分查找)
+ */
+SignalTreeModel::TableNode *SignalTreeModel::locate(SignalHandle handle, int *row) const
+{
+    auto it = m_tablesByHandle.upperBound(handle);
+    if (it == m_tablesByHandle.constBegin())
+        return nullptr;
+    --it;
+
+    TableNode *table = it.value();
+    const int index = handle - table->firstHandle;
+    if (index < 0 || index >= table->signalCount)
+        return nullptr;
+
+    *row = index;
+    return table;
+}
+
+QString SignalTreeModel::tablePrefix(const QModelIndex &parent) const
+{
+    TableNode *table = childTable(parent);
+    return table ? table->idPrefix : QString();
+}
+
+/**
+ * @brief [辅助] 未修改过的信号的画笔：按加载顺序循环取色，宽度为 1
+ * * 宽度 2 绘制密集线段会卡
+ */
+QPen SignalTreeModel::defaultPen(const TableNode *table, int row) const
+{
+    if (m_colors.isEmpty())
+        return QPen(Qt::black, 1);
+    return QPen(m_colors.at((table->colorBase + row) % m_colors.size()), 1);
+}
+
+/**
+ * @brief [辅助] 把表的已加载行数扩展到 count (不超过信号总数)
+ */
+void SignalTreeModel::fetchRows(TableNode *table, int count)
+{
+    const int target = qMin(count, table->signalCount);
+    if (target <= table->fetchedCount)
+        return;
+
+    const QModelIndex parentIndex = table->file->flat
+                                        ? fileIndex(table->file)
+                                        : createIndex(table->tableIndex, 0, static_cast<Node *>(table->file));
+    beginInsertRows(parentIndex, table->fetchedCount, target - 1);
+    table->fetchedCount = target;
+    endInsertRows();
+}
+
+/**
+ * @brief [辅助] 只为已提供给视图的行发出 dataChanged
+ */
+void SignalTreeModel::emitRowsChanged(TableNode *table, int first, int last, const QVector<int> &roles)
+{
+    if (first < 0 || first >= table->fetchedCount)
+        return;
+
+    last = qMin(last, table->fetchedCount - 1);
+    emit dataChanged(signalIndex(table, first), signalIndex(table, last), roles);
+}
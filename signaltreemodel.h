@@ -0,0 +1,171 @@
+#ifndef SIGNALTREEMODEL_H
+#define SIGNALTREEMODEL_H
+
+#include <QAbstractItemModel>
+#include <QBitArray>
+#include <QHash>
+#include <QMap>
+#include <QPen>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+#include "datamanager.h"
+#include "signalregistry.h"
+
+// Custom Roles
+enum TreeItemRoles
+{
+    UniqueIdRole = Qt::UserRole + 1, // "filename/tablename/signalindex"
+    IsFileItemRole,
+    PenDataRole,
+    FileNameRole,
+    IsSignalItemRole,
+    SignalHandleRole // SignalRegistry 分配的整数句柄
+};
+
+/**
+ * @brief 信号树模型 (文件 -> 表 -> 信号)
+ * * 直接建立在已加载文件的结构之上，不为信号创建任何条目对象：
+ * 名称、唯一 ID 和画笔在 data() 中按需生成，勾选状态保存在每个表的位数组中，
+ * 画笔只为用户修改过的信号单独保存，其余由颜色序号推算。
+ * 大表的信号行分批通过 canFetchMore/fetchMore 提供给视图，滚动到末尾时再追加。
+ * 数据角色与 TreeItemRoles 保持一致，SignalTreeDelegate 和拖放解码无需区分模型实现。
+ * 对外接口以 SignalHandle 标识信号，字符串 ID 只通过 UniqueIdRole 提供。
+ */
+class SignalTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    explicit SignalTreeModel(QObject *parent = nullptr);
+    ~SignalTreeModel();
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    QMap<int, QVariant> itemData(const QModelIndex &index) const override;
+
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    /**
+     * @brief 默认画笔使用的颜色表 (信号按加载顺序循环取色)
+     */
+    void setColorList(const QVector<QColor> &colors);
+
+    /**
+     * @brief 添加一个已加载的文件
+     * @param firstHandle SignalRegistry::registerFile 返回的句柄 (文件内按表、列顺序连续)
+     * @param colorBase 文件第一个信号的颜色序号
+     * @return 文件中的信号总数
+     */
+    int addFile(const QString &filename, const FileData &data, SignalHandle firstHandle, int colorBase);
+    void removeFile(const QString &filename);
+
+    // 按句柄访问信号
+    bool contains(SignalHandle handle) const;
+    QString signalName(SignalHandle handle) const;
+    QPen signalPen(SignalHandle handle) const;
+    void setSignalPen(SignalHandle handle, const QPen &pen);
+    bool isChecked(SignalHandle handle) const;
+
+    /**
+     * @brief 设置勾选状态
+     * @param notify 为 true 且状态确实改变时发出 signalCheckChanged (与用户在视图中勾选等效)
+     */
+    void setChecked(SignalHandle handle, bool checked, bool notify = false);
+
+    /**
+     * @brief 仅勾选给定集合中的信号，其余全部取消 (不发出 signalCheckChanged)
+     */
+    void setCheckedSignals(const QSet<SignalHandle> &handles);
+
+    /**
+     * @brief 信号在视图中的索引
+     * @param fetch 为 true 时按需加载信号所在的行；为 false 时未加载的行返回无效索引
+     */
+    QModelIndex indexForHandle(SignalHandle handle, bool fetch = true);
+
+    /**
+     * @brief 文件或表节点下全部信号 (含尚未加载的行) 的句柄
+     */
+    QVector<SignalHandle> signalHandles(const QModelIndex &node) const;
+
+    /**
+     * @brief 把信号节点 parent 下已加载的行扩展到至少包含 row (按批次取整)
+     */
+    void fetchUpTo(const QModelIndex &parent, int row);
+
+    /**
+     * @brief 加载全部尚未提供给视图的信号行
+     */
+    void fetchAll();
+
+    /**
+     * @brief 子项为信号的节点 (表节点或扁平文件节点) 对应的唯一 ID 前缀，其余节点返回空字符串
+     */
+    QString tablePrefix(const QModelIndex &parent) const;
+
+signals:
+    /**
+     * @brief [信号] 信号的勾选状态被用户 (或以 notify 方式) 改变
+     */
+    void signalCheckChanged(SignalHandle handle, bool checked);
+
+private:
+    struct FileNode;
+
+    struct Node
+    {
+        bool isFile;
+    };
+
+    struct TableNode : Node
+    {
+        FileNode *file;
+        int tableIndex;
+        QString name;
+        QString idPrefix;         // "filename/tablename/"
+        SignalHandle firstHandle; // 第 0 列的句柄
+        QStringList headers;      // 与 FileData 隐式共享
+        int signalCount;
+        int fetchedCount;         // 已提供给视图的行数
+        int colorBase;
+        QBitArray checked;
+        QHash<int, QPen> customPens; // 仅保存用户修改过的画笔
+        TableStats stats;
+        QVector<SignalStats> signalStats; // 与 FileData 隐式共享
+    };
+
+    struct FileNode : Node
+    {
+        QString name;
+        bool flat; // 只有一个与文件同名的表时，信号直接挂在文件节点下
+        QVector<TableNode *> tables;
+        TableStats stats;
+    };
+
+    TableNode *tableForIndex(const QModelIndex &index) const;
+    FileNode *fileForIndex(const QModelIndex &index) const;
+    TableNode *signalTable(const QModelIndex &index) const;
+    TableNode *childTable(const QModelIndex &parent) const;
+    QModelIndex fileIndex(FileNode *file) const;
+    QModelIndex signalIndex(TableNode *table, int row) const;
+    TableNode *locate(SignalHandle handle, int *row) const;
+
+    QPen defaultPen(const TableNode *table, int row) const;
+    void fetchRows(TableNode *table, int count);
+    void emitRowsChanged(TableNode *table, int first, int last, const QVector<int> &roles);
+
+    QVector<FileNode *> m_files;
+    QMap<SignalHandle, TableNode *> m_tablesByHandle; // 表第 0 列的句柄 -> 表
+    QVector<QColor> m_colors;
+};
+
+#endif // SIGNALTREEMODEL_H
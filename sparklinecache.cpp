@@ -0,0 +1,212 @@
+#include "sparklinecache.h"
+#include "latestjobrunner.h"
+
+#include <QRunnable>
+#include <QTimer>
+#include <cmath>
+
+/**
+ * @brief [辅助函数] 计算一个信号的缩略图
+ * * 每列的 min/max 由 LOD 金字塔的区间查询得到，不逐点扫描原始数据
+ */
+static Sparkline buildSparkline(const QVector<double> &values, const SignalLod &lod)
+{
+    Sparkline sparkline;
+    sparkline.lo.fill(255, SparklineCache::kColumns);
+    sparkline.hi.fill(0, SparklineCache::kColumns);
+
+    const int n = values.size();
+    double globalLo = 0;
+    double globalHi = 0;
+    if (!lod.rangeMinMax(values, 0, n, globalLo, globalHi) || !std::isfinite(globalHi - globalLo))
+        return sparkline;
+
+    const double span = globalHi - globalLo;
+    for (int c = 0; c < SparklineCache::kColumns; ++c)
+    {
+        const int begin = int(qint64(n) * c / SparklineCache::kColumns);
+        const int end = int(qint64(n) * (c + 1) / SparklineCache::kColumns);
+        double lo = 0;
+        double hi = 0;
+        if (!lod.rangeMinMax(values, begin, end, lo, hi))
+            continue;
+
+        // 常量信号画在中线上
+        if (span <= 0)
+        {
+            sparkline.lo[c] = 128;
+            sparkline.hi[c] = 128;
+            continue;
+        }
+        sparkline.lo[c] = quint8(qBound(0.0, std::floor((lo - globalLo) / span * 255.0 + 0.5), 255.0));
+        sparkline.hi[c] = quint8(qBound(0.0, std::floor((hi - globalLo) / span * 255.0 + 0.5), 255.0));
+    }
+    return sparkline;
+}
+
+/**
+ * @brief 缩略图批量计算任务 (在线程池中运行)
+ */
+class SparklineJob : public QRunnable
+{
+public:
+    /**
+     * @brief 一个待计算的信号 (数据向量与金字塔隐式共享，不额外拷贝)
+     */
+    struct Item
+    {
+        SignalHandle handle;
+        QVector<double> values;
+        SignalLod lod;
+    };
+
+    SparklineJob(SparklineCache *owner, const QVector<Item> &items)
+        : m_owner(owner),
+          m_items(items)
+    {
+    }
+
+    void run() override
+    {
+        SparklineBatch batch;
+        batch.handles.reserve(m_items.size());
+        batch.sparklines.reserve(m_items.size());
+        for (const Item &item : m_items)
+        {
+            batch.handles.append(item.handle);
+            batch.sparklines.append(buildSparkline(item.values, item.lod));
+        }
+        emit m_owner->batchFinished(batch);
+    }
+
+private:
+    SparklineCache *m_owner;
+    QVector<Item> m_items;
+};
+
+SparklineCache::SparklineCache(SignalRegistry *registry, QObject *parent)
+    : QObject(parent),
+      m_registry(registry),
+      m_runner(nullptr),
+      m_submitTimer(nullptr)
+{
+    qRegisterMetaType<SparklineBatch>("SparklineBatch");
+
+    m_runner = new LatestJobRunner([this](int) { return createJob(); }, this);
+
+    // 同一次绘制登记的请求在回到事件循环后合并提交
+    m_submitTimer = new QTimer(this);
+    m_submitTimer->setSingleShot(true);
+    m_submitTimer->setInterval(0);
+
+    connect(m_submitTimer, &QTimer::timeout, this, &SparklineCache::submit);
+    connect(this, &SparklineCache::batchFinished, this, &SparklineCache::onBatchFinished, Qt::QueuedConnection);
+}
+
+SparklineCache::~SparklineCache()
+{
+    m_runner->cancelAndWait();
+}
+
+bool SparklineCache::sparkline(SignalHandle handle, Sparkline *out) const
+{
+    auto it = m_cache.constFind(handle);
+    if (it == m_cache.constEnd())
+        return false;
+    *out = it.value();
+    return true;
+}
+
+void SparklineCache::request(SignalHandle handle)
+{
+    if (handle == InvalidSignalHandle || m_cache.contains(handle) || m_requested.contains(handle))
+        return;
+
+    m_requested.insert(handle);
+    m_queue.append(handle);
+
+    // 快速滚动时早先登记的行多半已不可见：只保留最近的几批，丢弃的行再次绘制时会重新登记
+    const int maxQueued = 4 * kBatchSize;
+    if (m_queue.size() > maxQueued)
+    {
+        const int drop = m_queue.size() - maxQueued;
+        for (int i = 0; i < drop; ++i)
+            m_requested.remove(m_queue.at(i));
+        m_queue.remove(0, drop);
+    }
+
+    if (!m_runner->isRunning() && !m_submitTimer->isActive())
+        m_submitTimer->start();
+}
+
+void SparklineCache::removeRange(SignalHandle first, int count)
+{
+    for (auto it = m_cache.begin(); it != m_cache.end();)
+    {
+        if (it.key() >= first && it.key() < first + count)
+            it = m_cache.erase(it);
+        else
+            ++it;
+    }
+}
+
+/**
+ * @brief [槽] 提交登记的请求 (运行中的批次结束后自动接续)
+ */
+void SparklineCache::submit()
+{
+    if (!m_queue.isEmpty())
+        m_runner->request();
+}
+
+/**
+ * @brief [辅助] 取出一批请求；最近登记的行 (即当前可见的行) 优先
+ * @return 队列中已没有有效的句柄时返回 nullptr
+ */
+QRunnable *SparklineCache::createJob()
+{
+    while (!m_queue.isEmpty())
+    {
+        const int take = qMin(int(kBatchSize), m_queue.size());
+        QVector<SparklineJob::Item> items;
+        items.reserve(take);
+        for (int i = m_queue.size() - take; i < m_queue.size(); ++i)
+        {
+            const SignalHandle handle = m_queue.at(i);
+            const SignalRegistry::Location loc = m_registry->location(handle);
+            if (!loc.table || loc.column >= loc.table->valueData.size())
+            {
+                m_requested.remove(handle);
+                continue;
+            }
+
+            SparklineJob::Item item;
+            item.handle = handle;
+            item.values = loc.table->valueData.at(loc.column);
+            item.lod = loc.column < loc.table->lods.size() ? loc.table->lods.at(loc.column) : SignalLod();
+            items.append(item);
+        }
+        m_queue.resize(m_queue.size() - take);
+
+        if (!items.isEmpty())
+            return new SparklineJob(this, items);
+    }
+    return nullptr;
+}
+
+/**
+ * @brief [槽] 结果进入缓存；期间被移除的文件的结果直接丢弃
+ */
+void SparklineCache::onBatchFinished(const SparklineBatch &batch)
+{
+    for (int i = 0; i < batch.handles.size(); ++i)
+    {
+        const SignalHandle handle = batch.handles.at(i);
+        m_requested.remove(handle);
+        if (m_registry->isValid(handle))
+            m_cache.insert(handle, batch.sparklines.at(i));
+    }
+
+    emit sparklinesReady();
+    submit();
+}
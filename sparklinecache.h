@@ -0,0 +1,95 @@
+#ifndef SPARKLINECACHE_H
+#define SPARKLINECACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QMetaType>
+
+#include "signalregistry.h"
+
+// 向前声明
+class LatestJobRunner;
+class QRunnable;
+class QTimer;
+
+/**
+ * @brief 一个信号的缩略图：按样本序号等分为固定列数，每列记录归一化的 min/max
+ * * 0 对应信号的全局最小值，255 对应全局最大值；lo > hi 表示该列没有有效样本。
+ */
+struct Sparkline
+{
+    QVector<quint8> lo;
+    QVector<quint8> hi;
+};
+
+/**
+ * @brief 一批缩略图的计算结果 (工作线程 -> GUI 线程)
+ */
+struct SparklineBatch
+{
+    QVector<SignalHandle> handles;
+    QVector<Sparkline> sparklines; // 与 handles 一一对应
+};
+Q_DECLARE_METATYPE(SparklineBatch)
+
+/**
+ * @brief 信号树的缩略图缓存
+ * * 委托绘制可见行时通过 request() 登记缺失的信号，同一事件循环内的请求合并为一批，
+ * 在线程池中借助 LOD 金字塔计算 (每列 O(kBaseBucket + log n))，结果按句柄缓存。
+ * 任务由 LatestJobRunner 调度，同一时刻最多一个任务，运行期间新登记的请求等待下一批。
+ */
+class SparklineCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int kColumns = 40;   // 缩略图列数
+    static const int kBatchSize = 256; // 每个任务最多计算的信号数
+
+    explicit SparklineCache(SignalRegistry *registry, QObject *parent = nullptr);
+    ~SparklineCache();
+
+    /**
+     * @brief 取缓存的缩略图
+     * @return 尚未计算时返回 false
+     */
+    bool sparkline(SignalHandle handle, Sparkline *out) const;
+
+    /**
+     * @brief 登记需要计算的信号 (已缓存或已登记的信号被忽略)
+     */
+    void request(SignalHandle handle);
+
+    /**
+     * @brief 丢弃句柄区间 [first, first + count) 的缓存 (文件移除时调用)
+     */
+    void removeRange(SignalHandle first, int count);
+
+signals:
+    /**
+     * @brief [信号] 有新的缩略图进入缓存
+     */
+    void sparklinesReady();
+
+    // 工作线程 -> GUI 线程 (排队连接)
+    void batchFinished(const SparklineBatch &batch);
+
+private slots:
+    void submit();
+    void onBatchFinished(const SparklineBatch &batch);
+
+private:
+    QRunnable *createJob();
+
+    SignalRegistry *m_registry;
+    LatestJobRunner *m_runner;
+    QTimer *m_submitTimer;
+
+    QHash<SignalHandle, Sparkline> m_cache;
+    QVector<SignalHandle> m_queue;  // 等待提交的句柄 (按登记顺序)
+    QSet<SignalHandle> m_requested; // 已登记但尚未进入缓存的句柄
+};
+
+#endif // SPARKLINECACHE_H
@@ -0,0 +1,85 @@
+#include "timeindex.h"
+
+#include <algorithm>
+#include <cmath>
+
+TimeIndex::TimeIndex()
+{
+}
+
+void TimeIndex::addSource(const QVector<double> &keys)
+{
+    if (keys.isEmpty())
+        return;
+
+    Source &source = m_sources[keys.constData()];
+    if (source.refCount++ > 0)
+        return; // 共享的时间向量已在索引中
+
+    source.keys = keys;
+}
+
+void TimeIndex::removeSource(const QVector<double> &keys)
+{
+    auto it = m_sources.find(keys.constData());
+    if (it == m_sources.end())
+        return;
+
+    if (--it.value().refCount > 0)
+        return;
+
+    m_sources.erase(it);
+}
+
+void TimeIndex::clear()
+{
+    m_sources.clear();
+}
+
+int TimeIndex::sourceCount() const
+{
+    return m_sources.size();
+}
+
+bool TimeIndex::nearest(double key, double *result) const
+{
+    // 各来源分别二分，距离相等时取较晚的时刻 (与单个时间向量中的规则一致)
+    bool found = false;
+    double best = 0;
+    double bestDistance = 0;
+    for (auto it = m_sources.constBegin(); it != m_sources.constEnd(); ++it)
+    {
+        double candidate;
+        if (!nearestIn(it.value().keys, key, &candidate))
+            continue;
+
+        const double distance = std::abs(candidate - key);
+        if (!found || distance < bestDistance || (distance == bestDistance && candidate > best))
+        {
+            best = candidate;
+            bestDistance = distance;
+            found = true;
+        }
+    }
+
+    if (found)
+        *result = best;
+    return found;
+}
+
+bool TimeIndex::nearestIn(const QVector<double> &keys, double key, double *result)
+{
+    if (keys.isEmpty())
+        return false;
+
+    const double *data = keys.constData();
+    const int n = keys.size();
+    int i = int(std::lower_bound(data, data + n, key) - data);
+    if (i >= n)
+        i = n - 1;
+    if (i > 0 && (key - data[i - 1]) < (data[i] - key))
+        --i;
+
+    *result = data[i];
+    return true;
+}
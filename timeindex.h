@@ -0,0 +1,47 @@
+#ifndef TIMEINDEX_H
+#define TIMEINDEX_H
+
+#include <QVector>
+#include <QHash>
+
+/**
+ * @brief 多来源时间索引
+ * * 记录多个信号的 (升序) 时间向量，用于游标吸附等 "最近采样时刻" 查询。
+ * 不物化合并后的时间轴：查询时在每个来源中二分查找后取最近者，复杂度 O(k log n)，
+ * 增删来源为 O(1) 且不占用额外内存。
+ * 同一张表的信号共享同一个时间向量 (隐式共享)，按数据指针去重，只查找一次。
+ */
+class TimeIndex
+{
+public:
+    TimeIndex();
+
+    void addSource(const QVector<double> &keys);
+    void removeSource(const QVector<double> &keys);
+    void clear();
+
+    int sourceCount() const;
+
+    /**
+     * @brief 查找最接近 key 的采样时刻
+     * @param result 输出
+     * @return 索引为空时返回 false
+     */
+    bool nearest(double key, double *result) const;
+
+    /**
+     * @brief 在单个升序时间向量中查找最接近 key 的采样时刻
+     */
+    static bool nearestIn(const QVector<double> &keys, double key, double *result);
+
+private:
+    struct Source
+    {
+        QVector<double> keys;
+        int refCount = 0;
+    };
+
+    QHash<const double *, Source> m_sources;
+};
+
+#endif // TIMEINDEX_H